@@ -0,0 +1,184 @@
+/**
+* @file bench.h
+* @brief Helpers shared by benchmarks: pseudo terminal ports and reports.
+* @author Adrien Oliva
+* @date 2026-10-17
+*
+* Every benchmark builds a report: measures are shown as a table on
+* standard error and written as a single JSON object on standard output:
+*
+*     {"benchmark": "bench_io", "results": [
+*       {"name": "read.chunk_1", "value": 1.5, "unit": "MB/s"}, ...]}
+*
+* so that `make bench` can gather them in bench.json and results can be
+* compared between releases.
+*/
+#ifndef BENCH_H_J4NW8ZQE
+#define BENCH_H_J4NW8ZQE
+
+#include <comserial.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <pty.h>
+#include <unistd.h>
+
+namespace bench {
+
+    /**
+    * @brief Pseudo terminal pair with a com::serial instance on slave side.
+    */
+    struct pty_port {
+        /**
+        * @brief Open a new pseudo terminal pair.
+        *
+        * @param open_device Open com::serial on slave side.
+        *
+        * The following exception may occur:
+        *   - std::system_error when openpty() fails.
+        */
+        explicit pty_port(bool open_device = true)
+            : master(-1), slave(-1), name(), device()
+        {
+            char path[256];
+            if (openpty(&master, &slave, path, NULL, NULL) < 0)
+                throw std::system_error(errno, std::generic_category(),
+                                        "openpty");
+            name = path;
+            if (open_device)
+                device.reset(new com::serial(name));
+        }
+
+        ~pty_port()
+        {
+            device.reset();
+            if (slave >= 0)
+                close(slave);
+            close(master);
+        }
+
+        /**
+        * @brief Master side, where data read by device are written.
+        */
+        int master;
+        /**
+        * @brief Slave side, kept open to avoid hang up.
+        */
+        int slave;
+        /**
+        * @brief Path of slave side.
+        */
+        std::string name;
+        /**
+        * @brief Serial device opened on slave side.
+        */
+        std::unique_ptr<com::serial> device;
+    };
+
+    /**
+    * @brief Get time elapsed since a given point.
+    *
+    * @param start Start of measure.
+    *
+    * @return Elapsed time in ns.
+    */
+    inline double elapsed_ns(const std::chrono::steady_clock::time_point &start)
+    {
+        std::chrono::nanoseconds total = std::chrono::steady_clock::now()
+                                       - start;
+        return static_cast<double>(total.count());
+    }
+
+    /**
+    * @brief Collect measures of a benchmark and print them.
+    */
+    class report {
+        public:
+            /**
+            * @brief Start a new report.
+            *
+            * @param benchmark Name of benchmark.
+            */
+            explicit report(const std::string &benchmark)
+                : m_benchmark(benchmark), m_results()
+            { }
+
+            /**
+            * @brief Start a new group of measures in table.
+            *
+            * @param title Description of group.
+            */
+            void section(const std::string &title)
+            {
+                fprintf(stderr, "%s:\n", title.c_str());
+            }
+
+            /**
+            * @brief Add a measure.
+            *
+            * @param name Unique name of measure in benchmark.
+            * @param value Measured value.
+            * @param unit Unit of value.
+            */
+            void add(const std::string &name, double value,
+                     const std::string &unit)
+            {
+                // Keep significant digits of small ratios.
+                int precision = std::fabs(value) < 10.0 ? 4 : 1;
+                fprintf(stderr, "  %-28s %14.*f %s\n", name.c_str(),
+                        precision, value, unit.c_str());
+                m_results.push_back(result { name, value, unit });
+            }
+
+            /**
+            * @brief Print report as JSON on standard output.
+            */
+            void print() const
+            {
+                printf("{\"benchmark\": \"%s\", \"results\": [",
+                       m_benchmark.c_str());
+                for (size_t i = 0; i < m_results.size(); i++) {
+                    const result &r = m_results[i];
+                    printf("%s\n  {\"name\": \"%s\", \"value\": ",
+                           i == 0 ? "" : ",", r.name.c_str());
+                    // JSON has no representation of infinity or NaN.
+                    if (std::isfinite(r.value))
+                        printf("%.9g", r.value);
+                    else
+                        printf("null");
+                    printf(", \"unit\": \"%s\"}", r.unit.c_str());
+                }
+                printf("]}\n");
+            }
+
+        private:
+            /**
+            * @brief Single measure.
+            */
+            struct result {
+                std::string name;
+                double value;
+                std::string unit;
+            };
+
+            /**
+            * @brief Name of benchmark.
+            */
+            std::string m_benchmark;
+            /**
+            * @brief Measures in order of addition.
+            */
+            std::vector<result> m_results;
+    };
+
+};
+
+#endif /* end of include guard: BENCH_H_J4NW8ZQE */
@@ -0,0 +1,179 @@
+/**
+* @file bench_dump.cpp
+* @brief Compare former stream based hexdump with table driven one.
+* @author Adrien Oliva
+* @date 2026-10-16
+*
+* Both formatters dump the same 4 kB buffer, their output is checked to be
+* identical.
+*/
+#include "bench.h"
+#include "logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+* @brief Size of dumped buffer.
+*/
+static const size_t BUFFER_SIZE = 4096;
+/**
+* @brief Number of iterations of each measure.
+*/
+static const size_t ITERATIONS = 2000;
+
+#ifndef HAVE_YAPLOG
+
+/**
+* @brief Former implementation of logger::dump::get_formatted_string().
+*
+* @param data Buffer to dump.
+* @param size Size of buffer.
+*
+* @return Human readable string.
+*/
+static std::string former_dump(const void *data, size_t size)
+{
+    const unsigned char *data_ptr = static_cast<const unsigned char *>(data);
+
+    std::stringstream output;
+    output << "Dump " << size << " byte(s) starting at " << data << ":";
+
+    std::stringstream offset;
+    std::stringstream hexa;
+    std::stringstream ascii;
+
+    size_t i = 0;
+
+    offset.str("");
+    offset << "\n";
+    offset << std::setw(8) << std::setfill('0') << std::hex << (i);
+    offset << " ";
+    hexa.str("");
+    ascii.str("");
+    for (i = 0; i < size; i++) {
+        if (i % 16 == 8) {
+            ascii << " ";
+            hexa << " ";
+        }
+
+        hexa << std::hex << std::setfill('0') << std::setw(2)
+             << static_cast<unsigned int>(*data_ptr);
+        hexa << " ";
+
+        if (isprint(*data_ptr))
+            ascii << (*data_ptr);
+        else
+            ascii << ".";
+
+        data_ptr++;
+
+        if (i % 16 == 15) {
+            output << offset.str() << hexa.str() << "|" << ascii.str() << "|";
+
+            offset.str("");
+            offset << "\n";
+            offset << std::setw(8) << std::setfill('0') << std::hex << (i + 1);
+            offset << " ";
+            hexa.str("");
+            ascii.str("");
+        }
+    }
+
+    if (i % 16 != 0) {
+        output << offset.str();
+        output << std::setw(49) << std::setfill(' ') << std::left << hexa.str();
+        output << "|";
+        output << std::setw(17) << std::setfill(' ') << std::left << ascii.str();
+        output << "|";
+    }
+
+    return output.str();
+}
+
+/**
+* @brief Measure average duration of a dump.
+*
+* @param buffer Buffer to dump.
+* @param size Size to dump.
+* @param former Use former implementation.
+*
+* @return Average duration of a dump in ns.
+*/
+static double measure(const std::vector<uint8_t> &buffer, size_t size,
+                      bool former)
+{
+    size_t total_size = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        if (former)
+            total_size += former_dump(buffer.data(), size).size();
+        else
+            total_size += logger::dump(buffer.data(), size)
+                                .get_formatted_string().size();
+    }
+    std::chrono::nanoseconds total = std::chrono::steady_clock::now() - start;
+
+    // Keep result alive.
+    if (total_size == 0)
+        return -1.0;
+
+    return static_cast<double>(total.count()) / ITERATIONS;
+}
+
+/**
+* @brief Main function of benchmark.
+*
+* @return 0 on success.
+*/
+int main()
+{
+    std::vector<uint8_t> buffer(BUFFER_SIZE);
+    srand(42);
+    for (auto &b: buffer)
+        b = static_cast<uint8_t>(rand());
+
+    for (size_t size = 0; size <= 64; size++) {
+        if (former_dump(buffer.data(), size)
+                != logger::dump(buffer.data(), size).get_formatted_string()) {
+            fprintf(stderr, "dump of %zu bytes differs from former one\n", size);
+            return EXIT_FAILURE;
+        }
+    }
+    if (former_dump(buffer.data(), BUFFER_SIZE)
+            != logger::dump(buffer.data(), BUFFER_SIZE).get_formatted_string()) {
+        fprintf(stderr, "dump of %zu bytes differs from former one\n", BUFFER_SIZE);
+        return EXIT_FAILURE;
+    }
+
+    double former_ns = measure(buffer, BUFFER_SIZE, true);
+    double table_ns = measure(buffer, BUFFER_SIZE, false);
+
+    bench::report report("bench_dump");
+    report.section("hexdump of " + std::to_string(BUFFER_SIZE) + " bytes ("
+                   + std::to_string(ITERATIONS) + " dumps)");
+    report.add("stream", former_ns, "ns/dump");
+    report.add("table", table_ns, "ns/dump");
+    report.add("stream_throughput", BUFFER_SIZE * 1000.0 / former_ns, "MB/s");
+    report.add("table_throughput", BUFFER_SIZE * 1000.0 / table_ns, "MB/s");
+    report.print();
+
+    return EXIT_SUCCESS;
+}
+
+#else
+
+int main()
+{
+    fprintf(stderr, "hexdump benchmark is not available with YapLog\n");
+    bench::report("bench_dump").print();
+    return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,372 @@
+/**
+* @file bench_framing.cpp
+* @brief Measure single core throughput of COBS and SLIP framing.
+* @author Adrien Oliva
+* @date 2026-10-17
+*
+* Random frames are encoded then decoded in memory, without any device, by
+* com::cobs and com::slip_codec, and by straightforward byte per byte
+* implementations. Outputs of both implementations are checked to be
+* identical. Throughputs are given in MB/s of frame content on the single
+* measuring thread.
+*/
+#include "bench.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <vector>
+
+/**
+* @brief Size of each frame.
+*/
+static const size_t FRAME = 256;
+/**
+* @brief Number of frames.
+*/
+static const size_t FRAMES = 4096;
+/**
+* @brief Number of times frames are processed by each measure.
+*/
+static const size_t ITERATIONS = 20;
+
+/**
+* @brief Byte per byte COBS encoder.
+*
+* @param data Frame content.
+* @param size Size of frame.
+* @param buffer Output buffer.
+*
+* @return Size of encoded frame.
+*/
+static size_t cobs_encode_loop(const uint8_t *data, size_t size,
+                               uint8_t *buffer)
+{
+    size_t code_position = 0;
+    size_t length = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] != 0) {
+            buffer[length++] = data[i];
+            code++;
+        }
+        if (data[i] == 0 || code == 0xff) {
+            buffer[code_position] = code;
+            code = 1;
+            code_position = length;
+            if (data[i] == 0 || i + 1 < size)
+                length++;
+        }
+    }
+    // Past end of frame when it ends with a full block
+    buffer[code_position] = code;
+
+    return length;
+}
+
+/**
+* @brief Byte per byte COBS decoder.
+*
+* @param data Encoded frame.
+* @param size Size of encoded frame.
+* @param buffer Output buffer.
+*
+* @return Size of decoded frame.
+*/
+static size_t cobs_decode_loop(const uint8_t *data, size_t size,
+                               uint8_t *buffer)
+{
+    size_t length = 0;
+    size_t i = 0;
+
+    while (i < size) {
+        uint8_t code = data[i++];
+        for (uint8_t k = 1; k < code && i < size; k++)
+            buffer[length++] = data[i++];
+        if (code != 0xff && i < size)
+            buffer[length++] = 0;
+    }
+
+    return length;
+}
+
+/**
+* @brief Byte per byte SLIP encoder.
+*
+* @param data Frame content.
+* @param size Size of frame.
+* @param buffer Output buffer.
+*
+* @return Size of encoded frame.
+*/
+static size_t slip_encode_loop(const uint8_t *data, size_t size,
+                               uint8_t *buffer)
+{
+    size_t length = 0;
+
+    buffer[length++] = com::slip_codec::END;
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] == com::slip_codec::END) {
+            buffer[length++] = com::slip_codec::ESC;
+            buffer[length++] = com::slip_codec::ESC_END;
+        } else if (data[i] == com::slip_codec::ESC) {
+            buffer[length++] = com::slip_codec::ESC;
+            buffer[length++] = com::slip_codec::ESC_ESC;
+        } else {
+            buffer[length++] = data[i];
+        }
+    }
+    buffer[length++] = com::slip_codec::END;
+
+    return length;
+}
+
+/**
+* @brief Byte per byte SLIP decoder of a stream of frames.
+*
+* @param data Encoded frames.
+* @param size Size of encoded frames.
+* @param buffer Output buffer, receiving frames one after the other.
+*
+* @return Total size of decoded frames.
+*/
+static size_t slip_decode_loop(const uint8_t *data, size_t size,
+                               uint8_t *buffer)
+{
+    size_t length = 0;
+    bool escape = false;
+
+    for (size_t i = 0; i < size; i++) {
+        uint8_t byte = data[i];
+        if (escape) {
+            escape = false;
+            if (byte == com::slip_codec::ESC_END)
+                byte = com::slip_codec::END;
+            else if (byte == com::slip_codec::ESC_ESC)
+                byte = com::slip_codec::ESC;
+            buffer[length++] = byte;
+        } else if (byte == com::slip_codec::ESC) {
+            escape = true;
+        } else if (byte != com::slip_codec::END) {
+            buffer[length++] = byte;
+        }
+    }
+
+    return length;
+}
+
+/**
+* @brief Encoded frames, one after the other.
+*/
+struct stream {
+    /**
+    * @brief Encoded data.
+    */
+    std::vector<uint8_t> data;
+    /**
+    * @brief Offset of each frame in data, with end of data last.
+    */
+    std::vector<size_t> offsets;
+};
+
+/**
+* @brief Encode frames and measure encoder throughput.
+*
+* @param frames Frame contents, FRAMES frames of FRAME bytes.
+* @param encode Encoder.
+* @param max_size Largest size of an encoded frame.
+* @param output Output encoded frames.
+*
+* @return Throughput in MB/s.
+*/
+static double measure_encode(const std::vector<uint8_t> &frames,
+                             size_t (*encode)(const uint8_t *, size_t, uint8_t *),
+                             size_t max_size, stream &output)
+{
+    output.data.resize(FRAMES * max_size);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < ITERATIONS; n++) {
+        output.offsets.clear();
+        size_t length = 0;
+        for (size_t i = 0; i < FRAMES; i++) {
+            output.offsets.push_back(length);
+            length += encode(frames.data() + i * FRAME, FRAME,
+                             output.data.data() + length);
+        }
+        output.offsets.push_back(length);
+    }
+    double ns = bench::elapsed_ns(start);
+
+    output.data.resize(output.offsets.back());
+    return FRAMES * FRAME * ITERATIONS * 1000.0 / ns;
+}
+
+/**
+* @brief Decode COBS frames with com::cobs::decode().
+*
+* @param input Encoded frames.
+* @param output Output buffer.
+*
+* @return Total size of decoded frames.
+*/
+static size_t cobs_decode_all(const stream &input, uint8_t *output)
+{
+    std::error_code ec;
+    size_t length = 0;
+
+    for (size_t i = 0; i + 1 < input.offsets.size(); i++)
+        length += com::cobs::decode(input.data.data() + input.offsets[i],
+                                    input.offsets[i + 1] - input.offsets[i],
+                                    output + length, ec);
+    return length;
+}
+
+/**
+* @brief Decode COBS frames byte per byte.
+*
+* @param input Encoded frames.
+* @param output Output buffer.
+*
+* @return Total size of decoded frames.
+*/
+static size_t cobs_decode_loop_all(const stream &input, uint8_t *output)
+{
+    size_t length = 0;
+
+    for (size_t i = 0; i + 1 < input.offsets.size(); i++)
+        length += cobs_decode_loop(input.data.data() + input.offsets[i],
+                                   input.offsets[i + 1] - input.offsets[i],
+                                   output + length);
+    return length;
+}
+
+/**
+* @brief Decode SLIP frames with com::slip_codec.
+*
+* @param input Encoded frames.
+* @param output Output buffer.
+*
+* @return Total size of decoded frames.
+*/
+static size_t slip_decode_all(const stream &input, uint8_t *output)
+{
+    com::slip_codec codec;
+    com::frame f = { output, 0, FRAME };
+    const uint8_t *data = input.data.data();
+    size_t size = input.data.size();
+    size_t consumed;
+
+    while (size != 0) {
+        if (codec.decode(data, size, f, consumed)) {
+            f.data += f.size;
+            f.size = 0;
+        }
+        data += consumed;
+        size -= consumed;
+    }
+    return f.data - output;
+}
+
+/**
+* @brief Decode SLIP frames byte per byte.
+*
+* @param input Encoded frames.
+* @param output Output buffer.
+*
+* @return Total size of decoded frames.
+*/
+static size_t slip_decode_loop_all(const stream &input, uint8_t *output)
+{
+    return slip_decode_loop(input.data.data(), input.data.size(), output);
+}
+
+/**
+* @brief Decode frames and measure decoder throughput.
+*
+* @param input Encoded frames.
+* @param decode Decoder of all frames.
+* @param output Output decoded frames.
+*
+* @return Throughput in MB/s.
+*/
+static double measure_decode(const stream &input,
+                             size_t (*decode)(const stream &, uint8_t *),
+                             std::vector<uint8_t> &output)
+{
+    size_t length = 0;
+    output.resize(FRAMES * FRAME);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < ITERATIONS; n++)
+        length = decode(input, output.data());
+    double ns = bench::elapsed_ns(start);
+
+    output.resize(length);
+    return FRAMES * FRAME * ITERATIONS * 1000.0 / ns;
+}
+
+/**
+* @brief Main function of benchmark.
+*
+* @return 0 on success.
+*/
+int main()
+{
+    std::vector<uint8_t> frames(FRAMES * FRAME);
+    srand(42);
+    for (auto &b: frames)
+        b = static_cast<uint8_t>(rand());
+
+    struct codec {
+        const char *name;
+        size_t (*encode)(const uint8_t *, size_t, uint8_t *);
+        size_t (*encode_loop)(const uint8_t *, size_t, uint8_t *);
+        size_t (*decode)(const stream &, uint8_t *);
+        size_t (*decode_loop)(const stream &, uint8_t *);
+        size_t max_size;
+    };
+    const codec codecs[2] = {
+        { "cobs", com::cobs::encode, cobs_encode_loop, cobs_decode_all,
+          cobs_decode_loop_all, com::cobs::max_encoded_size(FRAME) },
+        { "slip", com::slip_codec::encode, slip_encode_loop, slip_decode_all,
+          slip_decode_loop_all, com::slip_codec::max_encoded_size(FRAME) },
+    };
+
+    bench::report report("bench_framing");
+    for (const codec &c: codecs) {
+        stream encoded;
+        stream reference;
+        std::vector<uint8_t> decoded;
+        std::vector<uint8_t> decoded_loop;
+
+        report.section(std::string(c.name) + " of " + std::to_string(FRAME)
+                       + " bytes frames, single core");
+        double encode = measure_encode(frames, c.encode, c.max_size, encoded);
+        double encode_loop = measure_encode(frames, c.encode_loop, c.max_size,
+                                            reference);
+        double decode = measure_decode(encoded, c.decode, decoded);
+        double decode_loop = measure_decode(encoded, c.decode_loop,
+                                            decoded_loop);
+
+        if (encoded.data != reference.data || decoded != frames
+                || decoded_loop != frames) {
+            fprintf(stderr, "%s output differs from byte per byte one\n",
+                    c.name);
+            return EXIT_FAILURE;
+        }
+
+        std::string prefix(c.name);
+        report.add(prefix + ".encode", encode, "MB/s");
+        report.add(prefix + ".encode_byte_loop", encode_loop, "MB/s");
+        report.add(prefix + ".decode", decode, "MB/s");
+        report.add(prefix + ".decode_byte_loop", decode_loop, "MB/s");
+    }
+    report.print();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,481 @@
+/**
+* @file bench_io.cpp
+* @brief Measure throughput, latency and call overhead of device I/O.
+* @author Adrien Oliva
+* @date 2026-10-17
+*
+* Every measure is done over local pseudo terminals:
+*   - throughput of com::serial::read_buffer() and write_buffer() for
+*     several chunk sizes, along with number of system calls per byte done
+*     by device, ppoll() included (see com::io_stats::syscalls);
+*   - throughput of 64 bytes lines read byte per byte with read_buffer(),
+*     as done by doc/example/rs232_to_stdout.cpp, and with read_until();
+*   - round trip latency percentiles of a small message echoed by a thread
+*     on master side;
+*   - per call overhead of C wrapper comserial_read_buffer() and of traffic
+*     capture compared with com::serial::read_buffer(). Variants read the
+*     same pseudo terminal in turn, so that they share system noise, and
+*     minimum and median over repetitions are reported.
+*/
+#include "bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <termios.h>
+#include <unistd.h>
+
+/**
+* @brief Chunk sizes of throughput measures.
+*/
+static const size_t CHUNKS[] = { 1, 16, 256, 4096 };
+/**
+* @brief Maximum amount of data moved by each throughput measure.
+*/
+static const size_t TOTAL = 8 * 1024 * 1024;
+/**
+* @brief Maximum number of calls of each throughput measure.
+*/
+static const size_t MAX_CALLS = 50000;
+/**
+* @brief Size of each line of line reading measure, delimiter included.
+*/
+static const size_t LINE = 64;
+/**
+* @brief Number of lines of line reading measure.
+*/
+static const size_t LINES = 16384;
+/**
+* @brief Size of echoed message.
+*/
+static const size_t MESSAGE = 16;
+/**
+* @brief Number of round trips of latency measure.
+*/
+static const size_t ROUND_TRIPS = 10000;
+/**
+* @brief Number of repetitions of overhead measure, each one timing a batch
+*        of calls of every variant.
+*/
+static const size_t REPETITIONS = 100;
+/**
+* @brief Number of calls of a batch of overhead measure, also written on
+*        master at once, so low enough to fit in pseudo terminal buffer.
+*/
+static const size_t BATCH = 1024;
+
+/**
+* @brief Result of a throughput measure.
+*/
+struct throughput {
+    /**
+    * @brief Throughput in MB/s, negative on error.
+    */
+    double rate;
+    /**
+    * @brief System calls per byte.
+    */
+    double syscalls;
+};
+
+/**
+* @brief Write an amount of data on a file descriptor.
+*
+* @param fd File descriptor.
+* @param total Amount to write.
+*
+* @return true on success.
+*/
+static bool feed(int fd, size_t total)
+{
+    std::vector<uint8_t> data(4096, 0x5a);
+    while (total != 0) {
+        ssize_t w = write(fd, data.data(), std::min(total, data.size()));
+        if (w <= 0)
+            return false;
+        total -= w;
+    }
+    return true;
+}
+
+/**
+* @brief Read an amount of data on a file descriptor.
+*
+* @param fd File descriptor.
+* @param total Amount to read.
+*
+* @return true on success.
+*/
+static bool drain(int fd, size_t total)
+{
+    std::vector<uint8_t> data(4096);
+    while (total != 0) {
+        ssize_t r = read(fd, data.data(), std::min(total, data.size()));
+        if (r <= 0)
+            return false;
+        total -= r;
+    }
+    return true;
+}
+
+/**
+* @brief Measure throughput of device reads or writes.
+*
+* @param chunk Size of each call.
+* @param reading Measure read_buffer() instead of write_buffer().
+*
+* @return Measure.
+*/
+static throughput measure_throughput(size_t chunk, bool reading)
+{
+    bench::pty_port port;
+    size_t total = std::min(TOTAL, chunk * MAX_CALLS);
+    std::vector<uint8_t> buffer(chunk, 0xa5);
+    size_t moved = 0;
+
+    std::thread peer([&port, total, reading] {
+        if (reading)
+            feed(port.master, total);
+        else
+            drain(port.master, total);
+    });
+
+    com::serial_stats before = port.device->stats();
+    auto start = std::chrono::steady_clock::now();
+    try {
+        while (moved < total) {
+            if (reading)
+                moved += port.device->read_buffer(buffer.data(), chunk);
+            else
+                moved += port.device->write_buffer(buffer.data(), chunk);
+        }
+    } catch (std::exception &e) {
+        fprintf(stderr, "transfer error: %s\n", e.what());
+    }
+    double ns = bench::elapsed_ns(start);
+    com::serial_stats after = port.device->stats();
+
+    if (moved < total) {
+        // Unblock peer stuck on pseudo terminal.
+        tcflush(port.slave, TCIOFLUSH);
+        port.device.reset();
+        close(port.slave);
+        port.slave = -1;
+    }
+    peer.join();
+
+    throughput result;
+    result.rate = moved < total ? -1.0 : moved * 1000.0 / ns;
+    uint64_t calls = reading ? after.read.syscalls - before.read.syscalls
+                             : after.write.syscalls - before.write.syscalls;
+    result.syscalls = static_cast<double>(calls) / moved;
+    return result;
+}
+
+/**
+* @brief Measure throughput of line reading.
+*
+* @param until Use read_until() instead of reading byte per byte.
+*
+* @return Measure.
+*/
+static throughput measure_lines(bool until)
+{
+    bench::pty_port port;
+    size_t total = LINE * LINES;
+    size_t moved = 0;
+
+    std::thread peer([&port, total] {
+        std::vector<uint8_t> data(total, 'x');
+        for (size_t i = LINE - 1; i < total; i += LINE)
+            data[i] = '\n';
+        size_t written = 0;
+        while (written < total) {
+            ssize_t w = write(port.master, data.data() + written,
+                              total - written);
+            if (w <= 0)
+                break;
+            written += w;
+        }
+    });
+
+    uint8_t line[LINE];
+    com::serial_stats before = port.device->stats();
+    auto start = std::chrono::steady_clock::now();
+    try {
+        while (moved < total) {
+            if (until) {
+                moved += port.device->read_until('\n', line, sizeof(line));
+            } else {
+                size_t size = 0;
+                do {
+                    size += port.device->read_buffer(line + size, 1);
+                } while (line[size - 1] != '\n' && size < sizeof(line));
+                moved += size;
+            }
+        }
+    } catch (std::exception &e) {
+        fprintf(stderr, "line error: %s\n", e.what());
+    }
+    double ns = bench::elapsed_ns(start);
+    com::serial_stats after = port.device->stats();
+
+    if (moved < total) {
+        tcflush(port.slave, TCIOFLUSH);
+        port.device.reset();
+        close(port.slave);
+        port.slave = -1;
+    }
+    peer.join();
+
+    throughput result;
+    result.rate = moved < total ? -1.0 : moved * 1000.0 / ns;
+    result.syscalls = static_cast<double>(after.read.syscalls
+                                          - before.read.syscalls) / moved;
+    return result;
+}
+
+/**
+* @brief Measure round trip latency of a message echoed on master side.
+*
+* @param latencies Output latency of each round trip in ns, sorted.
+*
+* @return false on error.
+*/
+static bool measure_latency(std::vector<double> &latencies)
+{
+    bench::pty_port port;
+    std::thread echo([&port] {
+        std::vector<uint8_t> data(MESSAGE);
+        size_t remaining = MESSAGE * ROUND_TRIPS;
+        while (remaining != 0) {
+            ssize_t r = read(port.master, data.data(), data.size());
+            if (r <= 0 || write(port.master, data.data(), r) != r)
+                break;
+            remaining -= r;
+        }
+    });
+
+    uint8_t message[MESSAGE] = { 0 };
+    uint8_t answer[MESSAGE];
+    bool valid = true;
+
+    try {
+        for (size_t i = 0; i < ROUND_TRIPS; i++) {
+            auto start = std::chrono::steady_clock::now();
+            port.device->write_buffer(message, MESSAGE);
+            port.device->read_buffer(answer, MESSAGE);
+            latencies.push_back(bench::elapsed_ns(start));
+        }
+    } catch (std::exception &e) {
+        fprintf(stderr, "round trip error: %s\n", e.what());
+        port.device.reset();
+        close(port.slave);
+        port.slave = -1;
+        valid = false;
+    }
+
+    echo.join();
+    std::sort(latencies.begin(), latencies.end());
+    return valid;
+}
+
+/**
+* @brief Get a percentile of sorted values.
+*
+* @param values Sorted values.
+* @param p Percentile, from 0 to 100.
+*
+* @return Value.
+*/
+static double percentile(const std::vector<double> &values, double p)
+{
+    if (values.empty())
+        return -1.0;
+    size_t index = static_cast<size_t>(p / 100.0 * (values.size() - 1));
+    return values[index];
+}
+
+/**
+* @brief Read call measured by overhead measure.
+*/
+enum variant {
+    /**
+    * @brief com::serial::read_buffer().
+    */
+    VARIANT_CPP,
+    /**
+    * @brief comserial_read_buffer().
+    */
+    VARIANT_C,
+    /**
+    * @brief com::serial::read_buffer() with traffic capture.
+    */
+    VARIANT_CAPTURE,
+    /**
+    * @brief Number of variants.
+    */
+    VARIANTS
+};
+
+/**
+* @brief Measure duration of one byte reads with data available.
+*
+* @param durations Output average duration of a call in ns, for each
+*        variant and each repetition.
+*
+* @return false on error.
+*/
+static bool measure_overhead(std::vector<double> (&durations)[VARIANTS])
+{
+    bench::pty_port port;
+    com::serial captured(port.name);
+    com::capture capture("bench_io.cap");
+    captured.set_capture(&capture);
+    comserial_t device = comserial_create_device(port.name.c_str());
+    if (device == NULL)
+        return false;
+
+    std::vector<uint8_t> data(BATCH, 0x55);
+    uint8_t byte;
+    bool valid = true;
+
+    for (size_t i = 0; valid && i < REPETITIONS; i++) {
+        // Rotate order, so that no variant always follows the same one.
+        for (size_t k = 0; valid && k < VARIANTS; k++) {
+            size_t v = (i + k) % VARIANTS;
+            if (write(port.master, data.data(), BATCH)
+                    != static_cast<ssize_t>(BATCH)) {
+                valid = false;
+                break;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            for (size_t j = 0; j < BATCH; j++) {
+                if (v == VARIANT_C) {
+                    if (comserial_read_buffer(device, &byte, 1) != 1)
+                        valid = false;
+                } else if (v == VARIANT_CAPTURE) {
+                    captured.read_buffer(&byte, 1);
+                } else {
+                    port.device->read_buffer(&byte, 1);
+                }
+            }
+            durations[v].push_back(bench::elapsed_ns(start) / BATCH);
+        }
+    }
+
+    comserial_destroy_device(&device);
+    captured.set_capture(NULL);
+    unlink("bench_io.cap");
+
+    return valid;
+}
+
+/**
+* @brief Get median of values.
+*
+* @param values Values.
+*
+* @return Median, or negative value when there is none.
+*/
+static double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return percentile(values, 50.0);
+}
+
+/**
+* @brief Add minimum and median overhead of a variant compared with a
+*        reference to report.
+*
+* @param report Report to fill.
+* @param name Name of measure.
+* @param variant Durations of variant for each repetition.
+* @param reference Durations of reference for each repetition.
+*/
+static void add_overhead(bench::report &report, const std::string &name,
+                         const std::vector<double> &variant,
+                         const std::vector<double> &reference)
+{
+    // Repetitions are paired: both durations were measured back to back.
+    std::vector<double> deltas;
+    for (size_t i = 0; i < variant.size() && i < reference.size(); i++)
+        deltas.push_back(variant[i] - reference[i]);
+
+    double min_delta = *std::min_element(variant.begin(), variant.end())
+                     - *std::min_element(reference.begin(), reference.end());
+    report.add(name + ".min", min_delta, "ns/call");
+    report.add(name + ".median", median(deltas), "ns/call");
+}
+
+/**
+* @brief Main function of benchmark.
+*
+* @return 0 on success.
+*/
+int main()
+{
+    bench::report report("bench_io");
+    bool valid = true;
+
+    for (int reading = 1; reading >= 0; reading--) {
+        const char *call = reading ? "read" : "write";
+        report.section(std::string(call) + "_buffer throughput");
+        for (size_t chunk: CHUNKS) {
+            throughput t = measure_throughput(chunk, reading);
+            std::string name = std::string(call) + ".chunk_"
+                             + std::to_string(chunk);
+            report.add(name, t.rate, "MB/s");
+            report.add(name + ".syscalls", t.syscalls, "syscalls/byte");
+            valid = valid && t.rate > 0.0;
+        }
+    }
+
+    report.section(std::to_string(LINE) + " bytes lines throughput");
+    for (int until = 0; until <= 1; until++) {
+        throughput t = measure_lines(until);
+        std::string name = until ? "lines.read_until" : "lines.byte_loop";
+        report.add(name, t.rate, "MB/s");
+        report.add(name + ".syscalls", t.syscalls, "syscalls/byte");
+        valid = valid && t.rate > 0.0;
+    }
+
+    std::vector<double> latencies;
+    valid = measure_latency(latencies) && valid;
+    report.section("round trip latency (" + std::to_string(MESSAGE)
+                   + " bytes, " + std::to_string(ROUND_TRIPS)
+                   + " round trips)");
+    report.add("latency.p50", percentile(latencies, 50.0) / 1000.0, "us");
+    report.add("latency.p90", percentile(latencies, 90.0) / 1000.0, "us");
+    report.add("latency.p99", percentile(latencies, 99.0) / 1000.0, "us");
+    report.add("latency.p999", percentile(latencies, 99.9) / 1000.0, "us");
+    report.add("latency.max", percentile(latencies, 100.0) / 1000.0, "us");
+
+    std::vector<double> durations[VARIANTS];
+    valid = measure_overhead(durations) && valid;
+    report.section("read_buffer call overhead (1 byte available, "
+                   + std::to_string(REPETITIONS) + " x "
+                   + std::to_string(BATCH) + " calls per variant)");
+    if (!durations[VARIANT_CAPTURE].empty()) {
+        static const char *names[VARIANTS] = { "cpp", "c", "captured" };
+        for (size_t v = 0; v < VARIANTS; v++) {
+            std::string name = std::string("overhead.") + names[v];
+            report.add(name + ".min", *std::min_element(durations[v].begin(),
+                                                        durations[v].end()),
+                       "ns/call");
+            report.add(name + ".median", median(durations[v]), "ns/call");
+        }
+        add_overhead(report, "overhead.c_wrapper", durations[VARIANT_C],
+                     durations[VARIANT_CPP]);
+        add_overhead(report, "overhead.capture", durations[VARIANT_CAPTURE],
+                     durations[VARIANT_CPP]);
+    }
+    report.print();
+    return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,130 @@
+/**
+* @file bench_logger.cpp
+* @brief Measure cost of disabled log statements.
+* @author Adrien Oliva
+* @date 2026-10-16
+*
+* Three measures are done with logs disabled:
+*   - former log statement, reproduced here, which reads environment and
+*     allocates an output stream on each statement (to stderr and to a
+*     file);
+*   - log statement using cached logger context;
+*   - a one byte com::serial::write_buffer() over a pseudo terminal, where
+*     every log statement of write path is now a single comparison.
+*/
+#include "bench.h"
+#include "logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include <unistd.h>
+
+/**
+* @brief Number of iterations of each measure.
+*/
+static const size_t ITERATIONS = 100000;
+
+#ifndef HAVE_YAPLOG
+
+/**
+* @brief Measure average duration of former disabled log statement.
+*
+* @return Average duration of a statement in ns.
+*/
+static double measure_former()
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        logger::InternalLog(logger::log_level::debug,
+                            logger::log_location(__func__, __FILE__, __LINE__),
+                            logger::InternalLog::getOstream(),
+                            logger::InternalLog::getSystemLevel())
+            << "Iteration " << i;
+    }
+    std::chrono::nanoseconds total = std::chrono::steady_clock::now() - start;
+
+    return static_cast<double>(total.count()) / ITERATIONS;
+}
+
+/**
+* @brief Measure average duration of disabled log statement.
+*
+* @return Average duration of a statement in ns.
+*/
+static double measure_context()
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ITERATIONS; i++)
+        DLOG() << "Iteration " << i;
+    std::chrono::nanoseconds total = std::chrono::steady_clock::now() - start;
+
+    return static_cast<double>(total.count()) / ITERATIONS;
+}
+
+/**
+* @brief Measure average duration of a one byte write on a device.
+*
+* @return Average duration of a call in ns, or negative value on error.
+*/
+static double measure_write()
+{
+    bench::pty_port port;
+    uint8_t byte = 0x55;
+    double total = 0.0;
+
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        auto start = std::chrono::steady_clock::now();
+        port.device->write_buffer(&byte, 1);
+        total += bench::elapsed_ns(start);
+
+        if (read(port.master, &byte, 1) != 1)
+            return -1.0;
+    }
+
+    return total / ITERATIONS;
+}
+
+/**
+* @brief Main function of benchmark.
+*
+* @return 0 on success.
+*/
+int main()
+{
+    unsetenv("CSER_LOGLEVEL");
+    unsetenv("CSER_LOGDESTINATION");
+    logger::context::instance().reload();
+
+    double former_ns = measure_former();
+    setenv("CSER_LOGDESTINATION", "/dev/null", 1);
+    double former_file_ns = measure_former();
+    unsetenv("CSER_LOGDESTINATION");
+    double context_ns = measure_context();
+    double write_ns = measure_write();
+
+    bench::report report("bench_logger");
+    report.section("disabled log statement (" + std::to_string(ITERATIONS)
+                   + " statements)");
+    report.add("statement.former_stderr", former_ns, "ns/statement");
+    report.add("statement.former_file", former_file_ns, "ns/statement");
+    report.add("statement.context", context_ns, "ns/statement");
+    report.section("write_buffer with logs disabled (1 byte, "
+                   + std::to_string(ITERATIONS) + " calls)");
+    report.add("write_buffer.context", write_ns, "ns/call");
+    report.print();
+
+    return write_ns > 0.0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#else
+
+int main()
+{
+    fprintf(stderr, "logger benchmark is not available with YapLog\n");
+    bench::report("bench_logger").print();
+    return EXIT_SUCCESS;
+}
+
+#endif
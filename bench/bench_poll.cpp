@@ -0,0 +1,172 @@
+/**
+* @file bench_poll.cpp
+* @brief Compare legacy select() based I/O wait with poll() based one.
+* @author Adrien Oliva
+* @date 2026-10-16
+*
+* Two measures are done over local pseudo terminals:
+*   - per call overhead of a one byte read, with the former select() loop
+*     (reproduced here) and with com::serial::read_buffer();
+*   - maximum number of devices that can be opened and used: select() is
+*     limited to file descriptors lower than FD_SETSIZE, poll() is not.
+*/
+#include "bench.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/select.h>
+#include <unistd.h>
+
+/**
+* @brief Number of iterations of overhead measure.
+*/
+static const size_t ITERATIONS = 100000;
+/**
+* @brief Maximum number of devices opened by port count measure.
+*/
+static const size_t MAX_PORTS = 4096;
+
+/**
+* @brief Former read loop of com::serial::read_buffer() based on select().
+*
+* @param fd File descriptor to read.
+* @param buffer Output buffer.
+* @param length Size to read.
+* @param timeout Timeout in ms.
+*
+* @return Number of bytes read.
+*/
+static size_t select_read(int fd, uint8_t *buffer, size_t length,
+                          unsigned int timeout)
+{
+    size_t size_read = 0;
+    fd_set read_set;
+    struct timeval tv = { timeout / 1000, (timeout % 1000) * 1000 };
+
+    FD_ZERO(&read_set);
+    FD_SET(fd, &read_set);
+
+    while (size_read != length) {
+        int ret = select(fd + 1, &read_set, NULL, NULL, &tv);
+        if (ret <= 0)
+            break;
+        ssize_t r = read(fd, buffer + size_read, length - size_read);
+        if (r <= 0)
+            break;
+        size_read += r;
+    }
+
+    return size_read;
+}
+
+/**
+* @brief Measure average duration of a one byte read.
+*
+* @param port Port to use.
+* @param legacy Use select() loop instead of com::serial::read_buffer().
+*
+* @return Average duration of a call in ns.
+*/
+static double measure_overhead(bench::pty_port &port, bool legacy)
+{
+    uint8_t byte = 0x55;
+    std::chrono::nanoseconds total(0);
+
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        if (write(port.master, &byte, 1) != 1)
+            return -1.0;
+
+        auto start = std::chrono::steady_clock::now();
+        if (legacy)
+            select_read(port.device->get_fd(), &byte, 1, 1000);
+        else
+            port.device->read_buffer(&byte, 1);
+        total += std::chrono::steady_clock::now() - start;
+    }
+
+    return static_cast<double>(total.count()) / ITERATIONS;
+}
+
+/**
+* @brief Open as many devices as possible and check the last one is usable.
+*
+* @param select_ports Output number of opened devices usable with select().
+* @param highest_fd Output highest file descriptor used by a device.
+*
+* @return Number of opened devices usable with poll().
+*/
+static size_t measure_ports(size_t &select_ports, int &highest_fd)
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    std::vector<std::unique_ptr<bench::pty_port>> ports;
+    select_ports = 0;
+    highest_fd = -1;
+
+    try {
+        while (ports.size() < MAX_PORTS) {
+            ports.emplace_back(new bench::pty_port());
+            highest_fd = ports.back()->device->get_fd();
+            if (highest_fd < FD_SETSIZE)
+                select_ports++;
+        }
+    } catch (std::exception &) {
+        // Out of file descriptors or pseudo terminals.
+    }
+
+    if (ports.empty())
+        return 0;
+
+    uint8_t byte = 0xaa;
+    bench::pty_port &last = *ports.back();
+    if (write(last.master, &byte, 1) != 1)
+        return 0;
+    byte = 0;
+    if (last.device->read_buffer(&byte, 1) != 1 || byte != 0xaa)
+        return 0;
+
+    return ports.size();
+}
+
+/**
+* @brief Main function of benchmark.
+*
+* @return 0 on success.
+*/
+int main()
+{
+    bench::pty_port port;
+    bench::report report("bench_poll");
+
+    double select_ns = measure_overhead(port, true);
+    double poll_ns = measure_overhead(port, false);
+
+    report.section("read_buffer overhead (1 byte, "
+                   + std::to_string(ITERATIONS) + " calls)");
+    report.add("overhead.select", select_ns, "ns/call");
+    report.add("overhead.ppoll", poll_ns, "ns/call");
+
+    size_t select_ports = 0;
+    int highest_fd = -1;
+    size_t poll_ports = measure_ports(select_ports, highest_fd);
+
+    report.section("maximum usable ports (limit " + std::to_string(MAX_PORTS)
+                   + ", select needs fd < " + std::to_string(FD_SETSIZE)
+                   + ")");
+    report.add("ports.select", select_ports, "ports");
+    report.add("ports.ppoll", poll_ports, "ports");
+    report.add("ports.highest_fd", highest_fd, "fd");
+    report.print();
+
+    return (poll_ports > 0 && select_ns > 0.0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,111 @@
+/**
+* @file bench_splice.cpp
+* @brief Compare read_buffer()/write() copy loop with splice_to().
+* @author Adrien Oliva
+* @date 2026-10-16
+*
+* A writer thread continuously feeds the master side of a pseudo terminal,
+* while data received by com::serial on slave side are moved to a file,
+* either with a read_buffer() + write() loop or with splice_to().
+*/
+#include "bench.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+* @brief Amount of data moved by each measure.
+*/
+static const size_t TOTAL = 16 * 1024 * 1024;
+/**
+* @brief Size of each transfer.
+*/
+static const size_t CHUNK = 4096;
+
+/**
+* @brief Measure throughput of moving TOTAL bytes from device to a file.
+*
+* @param use_splice Use splice_to() instead of copy loop.
+*
+* @return Throughput in MB/s, or negative value on error.
+*/
+static double measure(bool use_splice)
+{
+    bench::pty_port port;
+    std::atomic<bool> stop(false);
+    char path[] = "/tmp/bench_spliceXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return -1.0;
+    unlink(path);
+
+    std::thread writer([&port, &stop] {
+        std::vector<uint8_t> data(CHUNK, 0x5a);
+        while (!stop.load()) {
+            if (write(port.master, data.data(), data.size()) < 0)
+                break;
+        }
+    });
+
+    std::vector<uint8_t> buffer(CHUNK);
+    size_t moved = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    try {
+        while (moved < TOTAL) {
+            if (use_splice) {
+                moved += port.device->splice_to(fd, CHUNK);
+            } else {
+                size_t r = port.device->read_buffer(buffer.data(), CHUNK);
+                if (write(fd, buffer.data(), r) != static_cast<ssize_t>(r))
+                    break;
+                moved += r;
+            }
+        }
+    } catch (std::exception &e) {
+        fprintf(stderr, "transfer error: %s\n", e.what());
+    }
+
+    std::chrono::duration<double> elapsed =
+                                std::chrono::steady_clock::now() - start;
+    stop.store(true);
+    // Unblock writer stuck on full pseudo terminal.
+    tcflush(port.slave, TCIFLUSH);
+    port.device.reset();
+    close(port.slave);
+    port.slave = -1;
+    writer.join();
+    close(fd);
+
+    if (moved < TOTAL)
+        return -1.0;
+    return moved / elapsed.count() / (1024.0 * 1024.0);
+}
+
+/**
+* @brief Main function of benchmark.
+*
+* @return 0 on success.
+*/
+int main()
+{
+    bench::report report("bench_splice");
+    double copy = measure(false);
+    double spliced = measure(true);
+
+    report.section("device to file throughput ("
+                   + std::to_string(TOTAL / (1024 * 1024)) + " MB, "
+                   + std::to_string(CHUNK) + " bytes chunks)");
+    report.add("read_buffer_write", copy, "MB/s");
+    report.add("splice_to", spliced, "MB/s");
+    report.print();
+
+    return (copy > 0.0 && spliced > 0.0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,317 @@
+/**
+* @file binlog.h
+* @brief Compact binary log format, written by logger context and read by
+*        comserial-logdecode.
+* @author Adrien Oliva
+* @date 2026-10-17
+*
+* A binary log is a sequence of records:
+*   - record type (1 byte);
+*   - body length (4 bytes);
+*   - body.
+*
+* Every integer is stored in little endian. Known records are:
+*   - header ('H'): "CSERLOG" followed by format version, written each time
+*     a process opens log; call site ids are only valid up to next header.
+*   - call site ('S'): id (4 bytes), line (4 bytes), file name length
+*     (2 bytes), file name, function name length (2 bytes), function name.
+*     A call site is defined once, the first time it logs.
+*   - message ('M'): timestamp in ns since epoch (8 bytes), call site id
+*     (4 bytes, 0 for logger own messages), level (1 byte), then chunks:
+*       - text ('T'): length (4 bytes), text;
+*       - binary ('B'): length (4 bytes), buffer address (8 bytes), raw
+*         bytes of buffer, rendered as a hexdump.
+*
+* Call site ids are allocated by the writing process and records carry no
+* process id, so a binary log must have a single writer at a time: several
+* processes appending to the same `CSER_LOGDESTINATION` interleave records
+* whose ids collide, and their messages can not be attributed.
+*/
+#ifndef BINLOG_H_Q7TZ2WXC
+#define BINLOG_H_Q7TZ2WXC
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <time.h>
+
+namespace binlog {
+
+    /**
+    * @brief Header record type.
+    */
+    static const uint8_t HEADER = 'H';
+    /**
+    * @brief Call site record type.
+    */
+    static const uint8_t SITE = 'S';
+    /**
+    * @brief Message record type.
+    */
+    static const uint8_t MESSAGE = 'M';
+    /**
+    * @brief Text chunk type.
+    */
+    static const uint8_t TEXT = 'T';
+    /**
+    * @brief Binary chunk type.
+    */
+    static const uint8_t BINARY = 'B';
+    /**
+    * @brief Body of header record.
+    */
+    static const char MAGIC[] = "CSERLOG\x01";
+    /**
+    * @brief Size of record type and length.
+    */
+    static const size_t RECORD_HEADER_SIZE = 5;
+
+    /**
+    * @brief Append an integer in little endian.
+    *
+    * @param out Output buffer.
+    * @param value Value to append.
+    * @param size Number of bytes to append.
+    */
+    inline void put(std::string &out, uint64_t value, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+
+    /**
+    * @brief Read an integer stored in little endian.
+    *
+    * @param data Input buffer.
+    * @param size Number of bytes to read.
+    *
+    * @return Value read.
+    */
+    inline uint64_t get(const uint8_t *data, size_t size)
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < size; i++)
+            value |= static_cast<uint64_t>(data[i]) << (8 * i);
+        return value;
+    }
+
+    /**
+    * @brief Start a record.
+    *
+    * @param out Output buffer.
+    * @param type Record type.
+    *
+    * @return Position of record in output buffer, for end_record().
+    */
+    inline size_t begin_record(std::string &out, uint8_t type)
+    {
+        size_t start = out.size();
+        out.push_back(static_cast<char>(type));
+        put(out, 0, 4);
+        return start;
+    }
+
+    /**
+    * @brief Complete a record with its length.
+    *
+    * @param out Output buffer.
+    * @param start Position returned by begin_record().
+    */
+    inline void end_record(std::string &out, size_t start)
+    {
+        uint64_t length = out.size() - start - RECORD_HEADER_SIZE;
+        for (size_t i = 0; i < 4; i++)
+            out[start + 1 + i] = static_cast<char>((length >> (8 * i)) & 0xff);
+    }
+
+    /**
+    * @brief Append a header record.
+    *
+    * @param out Output buffer.
+    */
+    inline void write_header(std::string &out)
+    {
+        size_t start = begin_record(out, HEADER);
+        out.append(MAGIC, sizeof(MAGIC) - 1);
+        end_record(out, start);
+    }
+
+    /**
+    * @brief Append a call site record.
+    *
+    * @param out Output buffer.
+    * @param id Call site id.
+    * @param file File name.
+    * @param line Line number.
+    * @param function Function name.
+    */
+    inline void write_site(std::string &out, uint32_t id,
+                           const std::string &file, size_t line,
+                           const std::string &function)
+    {
+        size_t file_size = file.size() < 0xffff ? file.size() : 0xffff;
+        size_t function_size = function.size() < 0xffff ? function.size()
+                                                        : 0xffff;
+
+        size_t start = begin_record(out, SITE);
+        put(out, id, 4);
+        put(out, line, 4);
+        put(out, file_size, 2);
+        out.append(file, 0, file_size);
+        put(out, function_size, 2);
+        out.append(function, 0, function_size);
+        end_record(out, start);
+    }
+
+    /**
+    * @brief Append a message record.
+    *
+    * @param out Output buffer.
+    * @param timestamp Time of message in ns since epoch.
+    * @param site Call site id.
+    * @param level Log level.
+    * @param chunks Chunks of message, built with text_chunk() and
+    *        binary_chunk().
+    */
+    inline void write_message(std::string &out, uint64_t timestamp,
+                              uint32_t site, unsigned int level,
+                              const std::string &chunks)
+    {
+        size_t start = begin_record(out, MESSAGE);
+        put(out, timestamp, 8);
+        put(out, site, 4);
+        put(out, level, 1);
+        out += chunks;
+        end_record(out, start);
+    }
+
+    /**
+    * @brief Append a text chunk.
+    *
+    * @param chunks Chunks of message.
+    * @param text Text to append.
+    */
+    inline void text_chunk(std::string &chunks, const std::string &text)
+    {
+        if (text.empty())
+            return;
+        chunks.push_back(static_cast<char>(TEXT));
+        put(chunks, text.size(), 4);
+        chunks += text;
+    }
+
+    /**
+    * @brief Append a binary chunk.
+    *
+    * @param chunks Chunks of message.
+    * @param data Raw buffer.
+    * @param size Size of buffer.
+    */
+    inline void binary_chunk(std::string &chunks, const void *data,
+                             size_t size)
+    {
+        chunks.push_back(static_cast<char>(BINARY));
+        put(chunks, size, 4);
+        put(chunks, reinterpret_cast<uintptr_t>(data), 8);
+        chunks.append(static_cast<const char *>(data), size);
+    }
+
+    /**
+    * @brief Get current time.
+    *
+    * @return Time in ns since epoch.
+    */
+    inline uint64_t now()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL
+             + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    /**
+    * @brief Record read from a binary log.
+    */
+    struct record {
+        /**
+        * @brief Record type.
+        */
+        uint8_t type;
+        /**
+        * @brief Record body.
+        */
+        const uint8_t *body;
+        /**
+        * @brief Size of body.
+        */
+        size_t length;
+    };
+
+    /**
+    * @brief Iterate over records of a binary log held in memory.
+    */
+    class reader {
+        public:
+            /**
+            * @brief Read a binary log.
+            *
+            * @param data Binary log content.
+            * @param size Size of content.
+            */
+            reader(const void *data, size_t size)
+                : m_data(static_cast<const uint8_t *>(data))
+                , m_size(size)
+                , m_offset(0)
+            { }
+
+            /**
+            * @brief Get next record.
+            *
+            * @param r Output record.
+            *
+            * @return false at end of log, or when last record is truncated.
+            */
+            bool next(record &r)
+            {
+                if (m_size - m_offset < RECORD_HEADER_SIZE)
+                    return false;
+
+                size_t length = get(m_data + m_offset + 1, 4);
+                if (m_size - m_offset - RECORD_HEADER_SIZE < length)
+                    return false;
+
+                r.type = m_data[m_offset];
+                r.body = m_data + m_offset + RECORD_HEADER_SIZE;
+                r.length = length;
+                m_offset += RECORD_HEADER_SIZE + length;
+                return true;
+            }
+
+            /**
+            * @brief Get position of next record.
+            *
+            * @return Offset in log.
+            */
+            size_t offset() const
+            {
+                return m_offset;
+            }
+
+        private:
+            /**
+            * @brief Binary log content.
+            */
+            const uint8_t *m_data;
+            /**
+            * @brief Size of content.
+            */
+            size_t m_size;
+            /**
+            * @brief Position of next record.
+            */
+            size_t m_offset;
+    };
+
+};
+
+#endif /* end of include guard: BINLOG_H_Q7TZ2WXC */
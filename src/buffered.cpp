@@ -0,0 +1,318 @@
+/**
+* @file buffered.cpp
+* @brief Implementation of com::buffered_serial.
+* @author Adrien Oliva
+* @date 2026-10-16
+*/
+#include "comserial/buffered.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+using namespace com;
+
+buffered_serial::buffered_serial(serial &device, size_t capacity)
+    : m_device(device)
+    , m_ring()
+    , m_mask(0)
+    , m_wakefd(-1)
+    , m_head(0)
+    , m_high_water(0)
+    , m_overflow(0)
+    , m_error(0)
+    , m_padding()
+    , m_tail(0)
+    , m_waiting(false)
+    , m_mutex()
+    , m_cond()
+    , m_thread()
+{
+    if (capacity == 0) {
+        ELOG() << "Invalid ring buffer capacity";
+        throw exception::invalid_input();
+    }
+
+    size_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+    m_ring.resize(size);
+    m_mask = size - 1;
+
+    m_wakefd = eventfd(0, EFD_CLOEXEC);
+    if (m_wakefd < 0) {
+        CLOG() << "Internal system function returns error (eventfd)";
+        throw exception::runtime_error("Fail to create event file descriptor");
+    }
+
+    try {
+        m_thread = std::thread(&buffered_serial::receive, this);
+    } catch (std::system_error &) {
+        close(m_wakefd);
+        CLOG() << "Fail to start reader thread";
+        throw exception::runtime_error("Fail to start reader thread");
+    }
+
+    ILOG() << "New buffered device (" << size << " bytes ring)";
+}
+
+buffered_serial::~buffered_serial()
+{
+    ILOG() << "Destroy buffered device";
+
+    uint64_t value = 1;
+    if (write(m_wakefd, &value, sizeof(value)) != sizeof(value))
+        CLOG() << "Fail to stop reader thread";
+    m_thread.join();
+
+    close(m_wakefd);
+}
+
+size_t buffered_serial::read_buffer(uint8_t *buffer, size_t length)
+{
+    std::error_code ec;
+    size_t size_read = try_read_exact(buffer, length, ec);
+
+    if (ec == std::make_error_code(std::errc::invalid_argument))
+        throw exception::invalid_input();
+    else if (ec == std::errc::timed_out)
+        throw exception::timeout(size_read);
+    else if (ec)
+        throw exception::runtime_error("Fail to read");
+
+    return size_read;
+}
+
+size_t buffered_serial::read_some(uint8_t *buffer, size_t length,
+                                  std::error_code &ec)
+{
+    ec.clear();
+    if (buffer == NULL || length == 0) {
+        ec = std::make_error_code(std::errc::invalid_argument);
+        return 0;
+    }
+
+    auto deadline = std::chrono::steady_clock::now()
+                  + std::chrono::milliseconds(m_device.get_read_timeout());
+
+    for (;;) {
+        size_t size_read = pop(buffer, length);
+        if (size_read != 0)
+            return size_read;
+
+        int error = m_error.load();
+        if (error != 0) {
+            ec = std::error_code(error, std::system_category());
+            return 0;
+        }
+
+        if (!wait_data(deadline)) {
+            ec = std::make_error_code(std::errc::timed_out);
+            return 0;
+        }
+    }
+}
+
+size_t buffered_serial::try_read_exact(uint8_t *buffer, size_t length,
+                                       std::error_code &ec)
+{
+    ec.clear();
+    if (buffer == NULL || length == 0) {
+        ec = std::make_error_code(std::errc::invalid_argument);
+        return 0;
+    }
+
+    size_t size_read = 0;
+    auto deadline = std::chrono::steady_clock::now()
+                  + std::chrono::milliseconds(m_device.get_read_timeout());
+
+    while (size_read != length) {
+        size_read += pop(buffer + size_read, length - size_read);
+        if (size_read == length)
+            break;
+
+        int error = m_error.load();
+        if (error != 0) {
+            ec = std::error_code(error, std::system_category());
+            break;
+        }
+
+        if (!wait_data(deadline)) {
+            // Last chance for data pushed right at deadline.
+            size_read += pop(buffer + size_read, length - size_read);
+            if (size_read != length)
+                ec = std::make_error_code(std::errc::timed_out);
+            break;
+        }
+    }
+
+    DLOG() << "Buffered read:" << logger::dump(buffer, size_read);
+    return size_read;
+}
+
+size_t buffered_serial::read_available(uint8_t *buffer, size_t length)
+{
+    if (buffer == NULL || length == 0)
+        throw exception::invalid_input();
+
+    return pop(buffer, length);
+}
+
+size_t buffered_serial::write_buffer(const uint8_t *buffer, size_t length)
+{
+    return m_device.write_buffer(buffer, length);
+}
+
+size_t buffered_serial::available() const
+{
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    return m_head.load(std::memory_order_acquire) - tail;
+}
+
+size_t buffered_serial::capacity() const
+{
+    return m_ring.size();
+}
+
+size_t buffered_serial::high_water_mark() const
+{
+    return m_high_water.load(std::memory_order_relaxed);
+}
+
+uint64_t buffered_serial::overflow_count() const
+{
+    return m_overflow.load(std::memory_order_relaxed);
+}
+
+serial &buffered_serial::device()
+{
+    return m_device;
+}
+
+void buffered_serial::receive()
+{
+    struct pollfd fds[2];
+    fds[0].fd = m_device.get_fd();
+    fds[0].events = POLLIN;
+    fds[1].fd = m_wakefd;
+    fds[1].events = POLLIN;
+
+    // Data already read ahead by device do not wake poll up.
+    bool running = drain_device(0);
+
+    while (running) {
+        int ret = poll(fds, 2, -1);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            m_error.store(errno);
+            CLOG() << "Internal system function returns error (poll)";
+            break;
+        }
+
+        if (fds[1].revents != 0)
+            break;
+        if (fds[0].revents != 0)
+            running = drain_device(fds[0].revents);
+    }
+
+    // Wake up consumer so that it sees error instead of waiting timeout.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cond.notify_all();
+}
+
+bool buffered_serial::drain_device(short revents)
+{
+    size_t size = m_ring.size();
+    bool received = false;
+    bool drained = false;
+
+    for (;;) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        size_t used = head - m_tail.load(std::memory_order_acquire);
+        size_t offset = head & m_mask;
+        size_t chunk = std::min(size - used, size - offset);
+
+        // Read through device so that read ahead data come first, and
+        // traffic is accounted in statistics and captures.
+        size_t r;
+        try {
+            if (chunk != 0) {
+                r = m_device.read_available(&m_ring[offset], chunk);
+            } else {
+                // Ring is full: consume device anyway and drop data, so that
+                // loss is accounted for instead of silently happening in
+                // kernel.
+                uint8_t discard[256];
+                r = m_device.read_available(discard, sizeof(discard));
+                m_overflow.fetch_add(r, std::memory_order_relaxed);
+            }
+        } catch (exception::runtime_error &) {
+            m_error.store(EIO);
+            return false;
+        }
+
+        if (r == 0)
+            break;
+
+        drained = true;
+        if (chunk != 0) {
+            m_head.store(head + r);
+            if (used + r > m_high_water.load(std::memory_order_relaxed))
+                m_high_water.store(used + r, std::memory_order_relaxed);
+            received = true;
+        }
+    }
+
+    if (!drained && (revents & (POLLHUP | POLLERR)) != 0) {
+        m_error.store(EIO);
+        WLOG() << "Device hang up";
+        return false;
+    }
+
+    if (received && m_waiting.load()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cond.notify_all();
+    }
+
+    return true;
+}
+
+size_t buffered_serial::pop(uint8_t *buffer, size_t length)
+{
+    size_t size = m_ring.size();
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    size_t count = std::min(length,
+                            m_head.load(std::memory_order_acquire) - tail);
+    if (count == 0)
+        return 0;
+
+    size_t offset = tail & m_mask;
+    size_t first = std::min(count, size - offset);
+    memcpy(buffer, &m_ring[offset], first);
+    memcpy(buffer + first, &m_ring[0], count - first);
+
+    m_tail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+bool buffered_serial::wait_data(
+        const std::chrono::steady_clock::time_point &deadline)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // Paired with m_head store and m_waiting load in drain_device(): either
+    // reader sees consumer waiting, or consumer sees new data.
+    m_waiting.store(true);
+    bool ready = m_cond.wait_until(lock, deadline, [this] {
+        return m_head.load() != m_tail.load(std::memory_order_relaxed)
+            || m_error.load() != 0;
+    });
+    m_waiting.store(false);
+
+    return ready;
+}
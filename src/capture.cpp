@@ -0,0 +1,423 @@
+/**
+* @file capture.cpp
+* @brief Implementation of com::capture and com::capture_reader.
+* @author Adrien Oliva
+* @date 2026-10-17
+*/
+#include "comserial/capture.h"
+#include "comserial/exceptions.h"
+#include "comserial/stats.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace com;
+
+namespace {
+
+    /**
+    * @brief First bytes of a capture file, ending with format version.
+    */
+    const char MAGIC[8] = { 'C', 'S', 'E', 'R', 'C', 'A', 'P', 1 };
+
+    /**
+    * @brief Header of a capture file.
+    */
+    struct file_header {
+        /**
+        * @brief MAGIC.
+        */
+        char magic[8];
+        /**
+        * @brief CLOCK_REALTIME time of creation in ns.
+        */
+        uint64_t realtime;
+        /**
+        * @brief CLOCK_MONOTONIC time of creation in ns.
+        */
+        uint64_t monotonic;
+        /**
+        * @brief Number of files created before this one by capture.
+        */
+        uint64_t index;
+    };
+
+    /**
+    * @brief Header of a record, followed by data padded to 8 bytes.
+    */
+    struct record_header {
+        /**
+        * @brief Size of record, header and padding included, stored last:
+        *        0 marks end of records.
+        */
+        std::atomic<uint32_t> length;
+        /**
+        * @brief Port id.
+        */
+        uint16_t port;
+        /**
+        * @brief Type of record (capture::direction).
+        */
+        uint8_t dir;
+        /**
+        * @brief Number of padding bytes after data.
+        */
+        uint8_t padding;
+        /**
+        * @brief Time of record in ns on CLOCK_MONOTONIC.
+        */
+        uint64_t timestamp;
+    };
+
+    static_assert(sizeof(file_header) % 8 == 0, "Misaligned records");
+    static_assert(sizeof(record_header) == 16, "Unexpected record layout");
+
+    /**
+    * @brief Get total size of a record.
+    *
+    * @param size Size of data.
+    *
+    * @return Size of record, header and padding included.
+    */
+    inline size_t record_length(size_t size)
+    {
+        return sizeof(record_header) + ((size + 7) & ~static_cast<size_t>(7));
+    }
+
+};
+
+capture::capture(const std::string &path, size_t size, unsigned int files)
+    : m_path(path)
+    , m_size(size)
+    , m_files(files)
+    , m_mutex()
+    , m_ports()
+    , m_slots()
+    , m_current(NULL)
+    , m_dropped(0)
+    , m_file_count(0)
+{
+    if (files == 0 || size < sizeof(file_header) + record_length(1)
+                   || size > UINT32_MAX) {
+        ELOG() << "Invalid capture file size";
+        throw exception::invalid_input();
+    }
+
+    for (file &f: m_slots) {
+        f.base = NULL;
+        f.size = 0;
+        f.offset.store(0, std::memory_order_relaxed);
+        f.users.store(0, std::memory_order_relaxed);
+        f.fd = -1;
+    }
+
+    if (!open_file(m_slots[0]))
+        throw exception::runtime_error("Fail to create capture file");
+    m_current.store(&m_slots[0]);
+
+    ILOG() << "New capture " << path << " (" << files << " files of "
+           << size << " bytes)";
+}
+
+capture::~capture()
+{
+    close_file(*m_current.load());
+    ILOG() << "Close capture " << m_path;
+}
+
+uint16_t capture::add_port(const std::string &name)
+{
+    uint16_t id;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_ports.size() > UINT16_MAX) {
+            ELOG() << "Too many capture ports";
+            throw exception::invalid_input();
+        }
+        id = static_cast<uint16_t>(m_ports.size());
+        m_ports.push_back(name);
+    }
+
+    // A concurrent rotation may define port twice, which is harmless.
+    record(id, port, name.data(), name.size());
+    DLOG() << "Capture port " << id << ": " << name;
+    return id;
+}
+
+void capture::record(uint16_t port_id, direction dir, const void *data,
+                     size_t size)
+{
+    struct iovec iov;
+    iov.iov_base = const_cast<void *>(data);
+    iov.iov_len = size;
+    record(port_id, dir, &iov, 1, size);
+}
+
+void capture::record(uint16_t port_id, direction dir, const struct iovec *iov,
+                     size_t count, size_t size)
+{
+    if (size == 0)
+        return;
+
+    size_t length = record_length(size);
+    if (length > m_size - sizeof(file_header)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    for (;;) {
+        file *f = acquire();
+        size_t offset = f->offset.fetch_add(length, std::memory_order_relaxed);
+        if (offset + length <= f->size) {
+            write_record(f->base + offset, port_id, dir, iov, count, size);
+            release(f);
+            return;
+        }
+
+        release(f);
+        if (!rotate(f)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+uint64_t capture::dropped() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t capture::file_count() const
+{
+    return m_file_count.load(std::memory_order_relaxed);
+}
+
+capture::file *capture::acquire()
+{
+    // Current file can not be closed once it is seen current after being
+    // marked used, as rotate() switches file before waiting for its users.
+    for (;;) {
+        file *f = m_current.load();
+        f->users.fetch_add(1);
+        if (m_current.load() == f)
+            return f;
+        f->users.fetch_sub(1);
+    }
+}
+
+void capture::release(file *f)
+{
+    f->users.fetch_sub(1, std::memory_order_release);
+}
+
+bool capture::rotate(file *full)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_current.load() != full)
+        return true;
+
+    // Full file keeps being written through its mapping once renamed.
+    for (unsigned int i = m_files - 1; i > 0; i--) {
+        std::string from = i == 1 ? m_path
+                                  : m_path + "." + std::to_string(i - 1);
+        std::string to = m_path + "." + std::to_string(i);
+        rename(from.c_str(), to.c_str());
+    }
+
+    file &next = full == &m_slots[0] ? m_slots[1] : m_slots[0];
+    if (!open_file(next))
+        return false;
+    m_current.store(&next);
+
+    while (full->users.load() != 0)
+        std::this_thread::yield();
+    close_file(*full);
+
+    DLOG() << "Rotate capture " << m_path;
+    return true;
+}
+
+bool capture::open_file(file &f)
+{
+    // Never truncate a file which may still be mapped.
+    unlink(m_path.c_str());
+
+    int fd = open(m_path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        ALOG() << "Fail to create capture file " << m_path;
+        return false;
+    }
+
+    // Reserve blocks now: a write to a mapping of a full disk is a SIGBUS.
+    void *addr = MAP_FAILED;
+    if (posix_fallocate(fd, 0, static_cast<off_t>(m_size)) == 0)
+        addr = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        ALOG() << "Fail to allocate capture file " << m_path;
+        close(fd);
+        unlink(m_path.c_str());
+        return false;
+    }
+
+    uint8_t *base = static_cast<uint8_t *>(addr);
+    file_header header;
+    struct timespec ts;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    clock_gettime(CLOCK_REALTIME, &ts);
+    header.realtime = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL
+                    + static_cast<uint64_t>(ts.tv_nsec);
+    header.monotonic = io_counters::now();
+    header.index = m_file_count.load(std::memory_order_relaxed);
+    memcpy(base, &header, sizeof(header));
+
+    // Each file defines its ports, so that it can be read alone.
+    size_t offset = sizeof(file_header);
+    for (size_t i = 0; i < m_ports.size(); i++) {
+        size_t length = record_length(m_ports[i].size());
+        if (m_ports[i].empty() || offset + length > m_size)
+            continue;
+        struct iovec iov;
+        iov.iov_base = const_cast<char *>(m_ports[i].data());
+        iov.iov_len = m_ports[i].size();
+        write_record(base + offset, static_cast<uint16_t>(i), port, &iov, 1,
+                     iov.iov_len);
+        offset += length;
+    }
+
+    f.base = base;
+    f.size = m_size;
+    f.offset.store(offset, std::memory_order_relaxed);
+    f.fd = fd;
+    m_file_count.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void capture::close_file(file &f)
+{
+    if (f.fd < 0)
+        return;
+
+    size_t used = std::min(f.offset.load(), f.size);
+    munmap(f.base, f.size);
+    if (ftruncate(f.fd, static_cast<off_t>(used)) < 0)
+        WLOG() << "Fail to truncate capture file";
+    close(f.fd);
+
+    f.base = NULL;
+    f.fd = -1;
+}
+
+void capture::write_record(uint8_t *at, uint16_t port_id, direction dir,
+                           const struct iovec *iov, size_t count, size_t size)
+{
+    record_header *h = reinterpret_cast<record_header *>(at);
+    size_t length = record_length(size);
+
+    h->port = port_id;
+    h->dir = static_cast<uint8_t>(dir);
+    h->padding = static_cast<uint8_t>(length - sizeof(record_header) - size);
+    h->timestamp = io_counters::now();
+
+    // Padding is already zero: files are created empty.
+    uint8_t *data = at + sizeof(record_header);
+    for (size_t i = 0; i < count && size != 0; i++) {
+        size_t chunk = std::min(size, iov[i].iov_len);
+        memcpy(data, iov[i].iov_base, chunk);
+        data += chunk;
+        size -= chunk;
+    }
+
+    h->length.store(static_cast<uint32_t>(length), std::memory_order_release);
+}
+
+capture_reader::capture_reader(const std::string &path)
+    : m_base(NULL)
+    , m_size(0)
+    , m_offset(sizeof(file_header))
+    , m_ports()
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        ELOG() << "Fail to open capture file " << path;
+        throw exception::runtime_error("Fail to open capture file");
+    }
+
+    struct stat st;
+    void *addr = MAP_FAILED;
+    if (fstat(fd, &st) == 0
+            && static_cast<size_t>(st.st_size) >= sizeof(file_header))
+        addr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (addr == MAP_FAILED) {
+        ELOG() << "Fail to map capture file " << path;
+        throw exception::runtime_error("Fail to map capture file");
+    }
+
+    m_base = static_cast<const uint8_t *>(addr);
+    m_size = st.st_size;
+    if (memcmp(m_base, MAGIC, sizeof(MAGIC)) != 0) {
+        munmap(const_cast<uint8_t *>(m_base), m_size);
+        ELOG() << path << " is not a capture file";
+        throw exception::runtime_error("Invalid capture file");
+    }
+}
+
+capture_reader::~capture_reader()
+{
+    munmap(const_cast<uint8_t *>(m_base), m_size);
+}
+
+bool capture_reader::next(capture_record &r)
+{
+    if (m_size - m_offset < sizeof(record_header))
+        return false;
+
+    const record_header *h =
+                reinterpret_cast<const record_header *>(m_base + m_offset);
+    size_t length = h->length.load(std::memory_order_acquire);
+    if (length < sizeof(record_header) || length > m_size - m_offset
+            || length % 8 != 0
+            || h->padding > length - sizeof(record_header))
+        return false;
+
+    r.timestamp = h->timestamp;
+    r.port = h->port;
+    r.dir = static_cast<capture::direction>(h->dir);
+    r.data = m_base + m_offset + sizeof(record_header);
+    r.size = length - sizeof(record_header) - h->padding;
+    m_offset += length;
+
+    if (r.dir == capture::port) {
+        if (m_ports.size() <= r.port)
+            m_ports.resize(r.port + 1);
+        m_ports[r.port].assign(reinterpret_cast<const char *>(r.data), r.size);
+    }
+    return true;
+}
+
+std::string capture_reader::port_name(uint16_t port) const
+{
+    return port < m_ports.size() ? m_ports[port] : std::string();
+}
+
+uint64_t capture_reader::start_realtime() const
+{
+    const file_header *h = reinterpret_cast<const file_header *>(m_base);
+    return h->realtime;
+}
+
+uint64_t capture_reader::start_monotonic() const
+{
+    const file_header *h = reinterpret_cast<const file_header *>(m_base);
+    return h->monotonic;
+}
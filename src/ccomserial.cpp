@@ -150,6 +150,81 @@ char comserial_set_parity(comserial_t device, char parity)
     return old_parity;
 }
 
+int comserial_get_flow_control(const comserial_t device)
+{
+    int mode = -1;
+
+    if (device != NULL)
+        mode = device->dev->get_flow_control();
+
+    return mode;
+}
+
+int comserial_set_flow_control(comserial_t device, int mode)
+{
+    int old_mode = -1;
+
+    if (device != NULL && mode >= COMSER_FLOW_NONE
+            && mode <= COMSER_FLOW_SOFTWARE)
+        old_mode = device->dev->set_flow_control(
+                                        static_cast<com::flow_control>(mode));
+
+    return old_mode;
+}
+
+int comserial_get_config(const comserial_t device, comserial_config_t *config)
+{
+    if (device == NULL || config == NULL)
+        return -1;
+
+    com::serial_config current = device->dev->get_config();
+    config->speed = current.speed;
+    config->data_size = current.data_size;
+    config->stop_size = current.stop_size;
+    config->parity = current.parity;
+    config->flow_control = current.flow;
+
+    return 0;
+}
+
+int comserial_apply_config(comserial_t device, const comserial_config_t *config,
+                           int when)
+{
+    static const com::apply_when modes[] = {
+        com::apply_now,
+        com::apply_drain,
+        com::apply_flush
+    };
+
+    if (device == NULL || config == NULL || when < COMSER_APPLY_NOW
+            || when > COMSER_APPLY_FLUSH
+            || config->flow_control < COMSER_FLOW_NONE
+            || config->flow_control > COMSER_FLOW_SOFTWARE)
+        return -1;
+
+    try {
+        device->dev->apply(com::serial_config(config->speed,
+                                              config->data_size,
+                                              config->stop_size,
+                                              config->parity,
+                                              static_cast<com::flow_control>(
+                                                  config->flow_control)),
+                           modes[when]);
+    } catch (com::exception::invalid_speed &) {
+        return -1;
+    } catch (com::exception::invalid_data_size &) {
+        return -1;
+    } catch (com::exception::invalid_stop_size &) {
+        return -1;
+    } catch (com::exception::invalid_parity &) {
+        return -1;
+    } catch (com::exception::invalid_configuration &) {
+        return -1;
+    }
+
+    return 0;
+}
+
 unsigned long comserial_get_read_timeout(const comserial_t device)
 {
     unsigned int timeout = 0;
@@ -197,15 +272,12 @@ ssize_t comserial_write_buffer(const comserial_t device, const uint8_t *buffer,
     if (device == NULL)
         return -COMSER_IOERROR;
 
-    try {
-        write_length = device->dev->write_buffer(buffer, length);
-    } catch (com::exception::invalid_input &) {
-        return -COMSER_IOERROR;
-    } catch (com::exception::runtime_error &) {
+    std::error_code ec;
+    write_length = device->dev->try_write_exact(buffer, length, ec);
+    if (ec == std::errc::timed_out)
+        return -write_length;
+    else if (ec)
         return -COMSER_IOERROR;
-    } catch (const com::exception::timeout &e) {
-        return -e.get_bytes();
-    }
 
     return write_length;
 }
@@ -217,16 +289,97 @@ ssize_t comserial_read_buffer(const comserial_t device, uint8_t *buffer, size_t
     if (device == NULL)
         return -COMSER_IOERROR;
 
-    try {
-        read_length = device->dev->read_buffer(buffer, length);
-    } catch (com::exception::invalid_input &) {
+    std::error_code ec;
+    read_length = device->dev->try_read_exact(buffer, length, ec);
+    if (ec == std::errc::timed_out)
+        return -read_length;
+    else if (ec)
         return -COMSER_IOERROR;
-    } catch (com::exception::runtime_error &) {
+
+    return read_length;
+}
+
+ssize_t comserial_write_buffers(const comserial_t device, const struct iovec *iov, size_t count)
+{
+    ssize_t write_length = 0;
+
+    if (device == NULL)
+        return -COMSER_IOERROR;
+
+    std::error_code ec;
+    write_length = device->dev->try_write_buffers(iov, count, ec);
+    if (ec == std::errc::timed_out)
+        return -write_length;
+    else if (ec)
+        return -COMSER_IOERROR;
+
+    return write_length;
+}
+
+ssize_t comserial_read_buffers(const comserial_t device, const struct iovec *iov, size_t count)
+{
+    ssize_t read_length = 0;
+
+    if (device == NULL)
+        return -COMSER_IOERROR;
+
+    std::error_code ec;
+    read_length = device->dev->try_read_buffers(iov, count, ec);
+    if (ec == std::errc::timed_out)
+        return -read_length;
+    else if (ec)
         return -COMSER_IOERROR;
-    } catch (const com::exception::timeout &e) {
-        return -e.get_bytes();
-    }
 
     return read_length;
 }
 
+ssize_t comserial_read_until(const comserial_t device, const uint8_t *delimiters, size_t count, uint8_t *buffer, size_t length)
+{
+    ssize_t read_length = 0;
+
+    if (device == NULL)
+        return -COMSER_IOERROR;
+
+    std::error_code ec;
+    read_length = device->dev->try_read_until(delimiters, count, buffer, length, ec);
+    if (ec == std::errc::timed_out)
+        return -read_length;
+    else if (ec)
+        return -COMSER_IOERROR;
+
+    return read_length;
+}
+
+
+/**
+* @brief Copy statistics of one direction to C structure.
+*
+* @param from Statistics snapshot.
+* @param to Output C structure.
+*/
+static void copy_io_stats(const com::io_stats &from, comserial_io_stats_t *to)
+{
+    static_assert(COMSER_LATENCY_BUCKETS == com::io_stats::LATENCY_BUCKETS,
+                  "Latency histograms of C and C++ API differ");
+
+    to->bytes = from.bytes;
+    to->calls = from.calls;
+    to->syscalls = from.syscalls;
+    to->timeouts = from.timeouts;
+    to->timeout_bytes = from.timeout_bytes;
+    to->errors = from.errors;
+    for (size_t i = 0; i < COMSER_LATENCY_BUCKETS; i++)
+        to->latency[i] = from.latency[i];
+}
+
+int comserial_get_stats(const comserial_t device, comserial_stats_t *stats)
+{
+    if (device == NULL || stats == NULL)
+        return -1;
+
+    com::serial_stats current = device->dev->stats();
+    copy_io_stats(current.read, &stats->read);
+    copy_io_stats(current.write, &stats->write);
+
+    return 0;
+}
@@ -0,0 +1,196 @@
+/**
+* @file cobs.cpp
+* @brief Implementation of COBS functions and com::cobs_serial.
+* @author Adrien Oliva
+* @date 2026-10-17
+*/
+#include "comserial/cobs.h"
+#include "comserial/exceptions.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace com;
+
+/**
+* @brief Largest number of data bytes in a block.
+*/
+static const size_t BLOCK = 254;
+/**
+* @brief Smallest size of receive buffer.
+*/
+static const size_t INPUT_SIZE = 4096;
+
+size_t cobs::encode(const uint8_t *data, size_t size, uint8_t *buffer)
+{
+    size_t length = 0;
+    size_t i = 0;
+
+    for (;;) {
+        size_t limit = std::min(size - i, BLOCK);
+        const void *zero = memchr(data + i, DELIMITER, limit);
+        size_t run = zero == NULL ? limit
+                                  : static_cast<const uint8_t *>(zero)
+                                    - (data + i);
+
+        // Code byte never overwrites data not read yet when encoding in
+        // place, but data run may overlap its destination.
+        buffer[length] = static_cast<uint8_t>(run + 1);
+        memmove(buffer + length + 1, data + i, run);
+        length += run + 1;
+        i += run;
+
+        // A full block at end of frame needs no trailing empty block
+        if (zero != NULL)
+            i++;
+        else if (run != BLOCK || i == size)
+            break;
+    }
+
+    return length;
+}
+
+size_t cobs::decode(const uint8_t *data, size_t size, uint8_t *buffer,
+                    std::error_code &ec)
+{
+    size_t length = 0;
+    size_t i = 0;
+
+    ec.clear();
+    while (i < size) {
+        uint8_t code = data[i++];
+        size_t run = code - 1U;
+        if (code == DELIMITER || run > size - i) {
+            ec = std::make_error_code(std::errc::bad_message);
+            return 0;
+        }
+
+        memmove(buffer + length, data + i, run);
+        length += run;
+        i += run;
+        if (run != BLOCK && i < size)
+            buffer[length++] = 0;
+    }
+
+    return length;
+}
+
+cobs_serial::cobs_serial(serial &device, size_t mtu)
+    : m_device(device)
+    , m_mtu(mtu)
+    , m_input()
+    , m_start(0)
+    , m_scan(0)
+    , m_end(0)
+    , m_discard(false)
+    , m_dropped(0)
+    , m_output()
+{
+    if (mtu == 0) {
+        ELOG() << "Invalid COBS frame size";
+        throw exception::invalid_input();
+    }
+
+    // Room for a whole frame besides the end of a previous one
+    m_input.resize(std::max(INPUT_SIZE, 2 * (cobs::max_encoded_size(mtu) + 1)));
+    m_output.resize(cobs::max_encoded_size(mtu) + 1);
+
+    ILOG() << "New COBS device (" << mtu << " bytes frames)";
+}
+
+frame cobs_serial::read_frame()
+{
+    std::error_code ec;
+    frame f = try_read_frame(ec);
+
+    if (ec == std::errc::timed_out)
+        throw exception::timeout(m_end - m_start);
+    else if (ec)
+        throw exception::runtime_error("Fail to read");
+
+    return f;
+}
+
+frame cobs_serial::try_read_frame(std::error_code &ec)
+{
+    uint8_t *input = m_input.data();
+
+    ec.clear();
+    for (;;) {
+        const void *found = memchr(input + m_scan, cobs::DELIMITER,
+                                   m_end - m_scan);
+        if (found != NULL) {
+            size_t start = m_start;
+            size_t stop = static_cast<const uint8_t *>(found) - input;
+            m_start = stop + 1;
+            m_scan = m_start;
+
+            if (m_discard) {
+                m_discard = false;
+            } else if (stop == start) {
+                continue;
+            } else if (stop - start <= cobs::max_encoded_size(m_mtu)) {
+                size_t size = cobs::decode(input + start, stop - start,
+                                           input + start, ec);
+                if (!ec && size <= m_mtu) {
+                    frame f = { input + start, size, size };
+                    return f;
+                }
+                ec.clear();
+            }
+
+            DLOG() << "Drop COBS frame";
+            m_dropped++;
+            continue;
+        }
+
+        // Make room for more data
+        m_scan = m_end;
+        if (m_start == m_end) {
+            m_start = m_scan = m_end = 0;
+        } else if (m_end == m_input.size()) {
+            if (m_start == 0) {
+                // Whole buffer is a single oversized frame
+                m_discard = true;
+                m_scan = m_end = 0;
+            } else {
+                memmove(input, input + m_start, m_end - m_start);
+                m_end -= m_start;
+                m_scan = m_end;
+                m_start = 0;
+            }
+        }
+
+        size_t size = m_device.read_some(input + m_end,
+                                         m_input.size() - m_end, ec);
+        if (ec) {
+            frame none = { NULL, 0, 0 };
+            return none;
+        }
+        m_end += size;
+    }
+}
+
+size_t cobs_serial::write_frame(const uint8_t *data, size_t size)
+{
+    if (data == NULL || size == 0 || size > m_mtu) {
+        ELOG() << "Invalid COBS frame";
+        throw exception::invalid_input();
+    }
+
+    size_t length = cobs::encode(data, size, m_output.data());
+    m_output[length++] = cobs::DELIMITER;
+    m_device.write_buffer(m_output.data(), length);
+    return size;
+}
+
+uint64_t cobs_serial::dropped() const
+{
+    return m_dropped;
+}
+
+serial &cobs_serial::device()
+{
+    return m_device;
+}
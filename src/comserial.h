@@ -9,6 +9,11 @@
 
 #ifdef __cplusplus
 #include <comserial/cppcomserial.h>
+#include <comserial/reactor.h>
+#include <comserial/buffered.h>
+#include <comserial/replayer.h>
+#include <comserial/slip.h>
+#include <comserial/cobs.h>
 #endif
 
 #include <comserial/ccomserial.h>
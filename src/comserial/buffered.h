@@ -0,0 +1,256 @@
+/**
+* @file buffered.h
+* @brief Serial device drained by a background thread into a ring buffer.
+* @author Adrien Oliva
+* @date 2026-10-16
+*/
+#ifndef BUFFERED_H_R8VZ2TNC
+#define BUFFERED_H_R8VZ2TNC
+
+#include <comserial/cppcomserial.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace com {
+
+    /**
+    * @brief Wrap a serial device with a dedicated reader thread.
+    *
+    * As soon as data arrive on device, the reader thread moves them in a
+    * large lock free single producer / single consumer ring buffer, so a
+    * stalled consumer does not let the kernel TTY buffer overflow. Reads
+    * from application are then only a copy out of the ring.
+    *
+    * When ring is full, incoming bytes are dropped and counted (see
+    * overflow_count()), and the highest ring occupancy ever reached is
+    * available with high_water_mark() to size the ring.
+    *
+    * Reader thread reads through wrapped device: data already read ahead
+    * by device are delivered first, and received traffic still shows up in
+    * device statistics and captures.
+    *
+    * Read functions must be called from a single consumer thread. Writes
+    * are directly forwarded to the wrapped device.
+    */
+    class buffered_serial {
+
+        public:
+            /**
+            * @brief Start draining a device.
+            *
+            * @param device Device to drain. Device must outlive this
+            *        instance and must not be read directly anymore.
+            * @param capacity Size of ring buffer in bytes, rounded up to the
+            *        next power of two (default to 64kB).
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when capacity is 0.
+            *   - com::exception::runtime_error when reader thread can not be
+            *     started.
+            */
+            explicit buffered_serial(serial &device, size_t capacity = 65536);
+            ~buffered_serial();
+
+            /**
+            * @brief Read data from ring buffer, waiting for data up to read
+            *        timeout of device.
+            *
+            * @param buffer Output buffer where read data is stored.
+            * @param length Size of buffer to read.
+            *
+            * @return Total amount of byte(s) successfully read.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when input buffer is invalid
+            *     (could be eigther a NULL pointer or a 0-length buffer)
+            *   - com::exception::runtime_error when reader thread stopped
+            *     on a device error and ring is empty.
+            *   - com::exception::timeout when read timeout is reached.
+            */
+            size_t read_buffer(uint8_t *buffer, size_t length);
+            /**
+            * @brief Read data available in ring buffer, waiting up to read
+            *        timeout of device when ring is empty.
+            *
+            * @param buffer Output buffer where read data is stored.
+            * @param length Size of buffer to read.
+            * @param ec Output error code, cleared on success.
+            *
+            * @return Amount of byte(s) read.
+            *
+            * Same as serial::read_some(), but data come from ring buffer.
+            */
+            size_t read_some(uint8_t *buffer, size_t length,
+                             std::error_code &ec);
+            /**
+            * @brief Read a whole buffer without throwing.
+            *
+            * @param buffer Output buffer where read data is stored.
+            * @param length Size of buffer to read.
+            * @param ec Output error code, cleared on success.
+            *
+            * @return Amount of byte(s) read, lower than length when an error
+            *         is reported.
+            *
+            * Same as serial::try_read_exact(), but data come from ring
+            * buffer.
+            */
+            size_t try_read_exact(uint8_t *buffer, size_t length,
+                                  std::error_code &ec);
+            /**
+            * @brief Read data already in ring buffer without waiting.
+            *
+            * @param buffer Output buffer where read data is stored.
+            * @param length Size of buffer to read.
+            *
+            * @return Amount of byte(s) read, possibly 0.
+            */
+            size_t read_available(uint8_t *buffer, size_t length);
+
+            /**
+            * @brief Write a given data buffer on wrapped device.
+            *
+            * @param buffer Input data to write.
+            * @param length Size of buffer to write.
+            *
+            * @return Total amount of byte(s) successfully written on device.
+            *
+            * See serial::write_buffer().
+            */
+            size_t write_buffer(const uint8_t *buffer, size_t length);
+
+            /**
+            * @brief Get number of bytes waiting in ring buffer.
+            *
+            * @return Number of bytes.
+            */
+            size_t available() const;
+            /**
+            * @brief Get size of ring buffer.
+            *
+            * @return Size in bytes.
+            */
+            size_t capacity() const;
+            /**
+            * @brief Get highest number of bytes ever stored in ring buffer.
+            *
+            * @return Number of bytes.
+            */
+            size_t high_water_mark() const;
+            /**
+            * @brief Get number of bytes dropped because ring buffer was full.
+            *
+            * @return Number of bytes.
+            */
+            uint64_t overflow_count() const;
+
+            /**
+            * @brief Retrieve wrapped device.
+            *
+            * @return Device given at construction.
+            */
+            serial &device();
+
+        private:
+            /**
+            * @brief Main loop of reader thread.
+            */
+            void receive();
+            /**
+            * @brief Move data from device to ring buffer until device is
+            *        empty.
+            *
+            * @param revents Events reported by poll on device, 0 when
+            *        not polled.
+            *
+            * @return false when reader must stop because of a device error.
+            */
+            bool drain_device(short revents);
+            /**
+            * @brief Copy data out of ring buffer.
+            *
+            * @param buffer Output buffer.
+            * @param length Size of output buffer.
+            *
+            * @return Amount of byte(s) copied.
+            */
+            size_t pop(uint8_t *buffer, size_t length);
+            /**
+            * @brief Sleep until ring buffer is not empty.
+            *
+            * @param deadline Time limit of wait.
+            *
+            * @return false when deadline is reached without data.
+            */
+            bool wait_data(const std::chrono::steady_clock::time_point &deadline);
+
+        private:
+            /**
+            * @brief Wrapped device.
+            */
+            serial &m_device;
+            /**
+            * @brief Ring buffer storage.
+            */
+            std::vector<uint8_t> m_ring;
+            /**
+            * @brief Mask to convert a position in ring offset.
+            */
+            size_t m_mask;
+            /**
+            * @brief Event file descriptor used to stop reader thread.
+            */
+            int m_wakefd;
+
+            /**
+            * @brief Write position, only updated by reader thread.
+            */
+            std::atomic<size_t> m_head;
+            /**
+            * @brief Highest ring occupancy seen by reader thread.
+            */
+            std::atomic<size_t> m_high_water;
+            /**
+            * @brief Number of dropped bytes.
+            */
+            std::atomic<uint64_t> m_overflow;
+            /**
+            * @brief errno value that stopped reader thread (0 while running,
+            *        EIO on device failure).
+            */
+            std::atomic<int> m_error;
+            /**
+            * @brief Keep consumer position away from producer cache line.
+            */
+            char m_padding[64];
+            /**
+            * @brief Read position, only updated by consumer.
+            */
+            std::atomic<size_t> m_tail;
+            /**
+            * @brief Set while consumer sleeps on empty ring.
+            */
+            std::atomic<bool> m_waiting;
+
+            /**
+            * @brief Mutex protecting consumer sleep.
+            */
+            std::mutex m_mutex;
+            /**
+            * @brief Condition signaled when data are pushed in empty ring.
+            */
+            std::condition_variable m_cond;
+            /**
+            * @brief Reader thread.
+            */
+            std::thread m_thread;
+    };
+
+};
+
+#endif /* end of include guard: BUFFERED_H_R8VZ2TNC */
@@ -0,0 +1,358 @@
+/**
+* @file capture.h
+* @brief Capture of device traffic in memory mapped record files.
+* @author Adrien Oliva
+* @date 2026-10-17
+*/
+#ifndef CAPTURE_H_M3XQ8KTV
+#define CAPTURE_H_M3XQ8KTV
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <sys/uio.h>
+
+namespace com {
+
+    /**
+    * @brief Record file where devices attached with serial::set_capture()
+    *        append every byte they send and receive.
+    *
+    * A capture file is created with its final size and mapped in memory:
+    * appending a record only reserves its space with an atomic increment
+    * of file offset, then copies timestamp, direction, port id and raw
+    * bytes in mapping. Records are written by kernel even when process
+    * crashes, and several devices, from several threads, may share a
+    * capture.
+    *
+    * When file is full, it is renamed to `<path>.1` (previous `<path>.1`
+    * becomes `<path>.2` and so on, up to the number of kept files) and a
+    * new file is created. Closed files are truncated to their content.
+    *
+    * Timestamps are in ns on CLOCK_MONOTONIC; each file header also holds
+    * CLOCK_REALTIME and CLOCK_MONOTONIC times of file creation to convert
+    * them. Records use native byte order.
+    */
+    class capture {
+
+        public:
+            /**
+            * @brief Type of a record.
+            */
+            enum direction {
+                /**
+                * @brief Data received from device.
+                */
+                rx = 0,
+                /**
+                * @brief Data sent to device.
+                */
+                tx = 1,
+                /**
+                * @brief Definition of a port: data is path name of device.
+                *        Definitions are repeated at start of each file.
+                */
+                port = 2,
+            };
+
+            /**
+            * @brief Create a capture file.
+            *
+            * @param path Path of capture file, replaced when it exists.
+            * @param size Size of each file in bytes (default to 64MB).
+            * @param files Number of files kept, current one included
+            *        (default to 2).
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when size can not hold a
+            *     single record or files is 0.
+            *   - com::exception::runtime_error when file can not be
+            *     created.
+            */
+            explicit capture(const std::string &path,
+                             size_t size = 64 * 1024 * 1024,
+                             unsigned int files = 2);
+            /**
+            * @brief Close capture, truncating current file to its content.
+            *
+            * Attached devices must be detached before.
+            */
+            ~capture();
+
+            /**
+            * @brief Register a new port.
+            *
+            * @param name Path name of device.
+            *
+            * @return Port id of records of device.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when too many ports are
+            *     registered.
+            */
+            uint16_t add_port(const std::string &name);
+
+            /**
+            * @brief Append a record.
+            *
+            * @param port_id Port id from add_port().
+            * @param dir Direction of data.
+            * @param data Raw bytes.
+            * @param size Number of bytes.
+            */
+            void record(uint16_t port_id, direction dir, const void *data,
+                        size_t size);
+            /**
+            * @brief Append a record gathered from several buffers.
+            *
+            * @param port_id Port id from add_port().
+            * @param dir Direction of data.
+            * @param iov Buffers.
+            * @param count Number of buffers.
+            * @param size Number of bytes to take from buffers.
+            */
+            void record(uint16_t port_id, direction dir,
+                        const struct iovec *iov, size_t count, size_t size);
+
+            /**
+            * @brief Get number of records dropped because they are larger
+            *        than a file or a new file can not be created.
+            *
+            * @return Number of records.
+            */
+            uint64_t dropped() const;
+            /**
+            * @brief Get number of files created since capture started.
+            *
+            * @return Number of files, current one included.
+            */
+            uint64_t file_count() const;
+
+        private:
+            capture(const capture &) = delete;
+            capture &operator=(const capture &) = delete;
+
+            /**
+            * @brief Mapping of a capture file.
+            */
+            struct file {
+                /**
+                * @brief Start of mapping.
+                */
+                uint8_t *base;
+                /**
+                * @brief Size of mapping.
+                */
+                size_t size;
+                /**
+                * @brief Offset of next record, may go beyond size when file
+                *        is full.
+                */
+                std::atomic<size_t> offset;
+                /**
+                * @brief Number of writers currently using mapping.
+                */
+                std::atomic<unsigned int> users;
+                /**
+                * @brief File descriptor, -1 when file is closed.
+                */
+                int fd;
+            };
+
+            /**
+            * @brief Get current file and prevent it to be closed.
+            *
+            * @return Current file, to give back to release().
+            */
+            file *acquire();
+            /**
+            * @brief Give back a file obtained with acquire().
+            *
+            * @param f File.
+            */
+            void release(file *f);
+            /**
+            * @brief Replace a full file by a new one.
+            *
+            * @param full File found full, nothing is done when it has
+            *        already been replaced.
+            *
+            * @return false when new file can not be created.
+            */
+            bool rotate(file *full);
+            /**
+            * @brief Create and map a new file at capture path.
+            *
+            * @param f Slot of new file.
+            *
+            * @return false on error.
+            */
+            bool open_file(file &f);
+            /**
+            * @brief Truncate a file to its content and unmap it.
+            *
+            * @param f File to close.
+            */
+            void close_file(file &f);
+            /**
+            * @brief Write a record at a given offset.
+            *
+            * @param at Start of record.
+            * @param port_id Port id.
+            * @param dir Direction of data.
+            * @param iov Buffers.
+            * @param count Number of buffers.
+            * @param size Number of bytes to take from buffers.
+            */
+            static void write_record(uint8_t *at, uint16_t port_id,
+                                     direction dir,
+                                     const struct iovec *iov, size_t count,
+                                     size_t size);
+
+            /**
+            * @brief Path of current file.
+            */
+            std::string m_path;
+            /**
+            * @brief Size of each file.
+            */
+            size_t m_size;
+            /**
+            * @brief Number of kept files.
+            */
+            unsigned int m_files;
+            /**
+            * @brief Protect rotation and ports.
+            */
+            std::mutex m_mutex;
+            /**
+            * @brief Path name of registered ports, by id.
+            */
+            std::vector<std::string> m_ports;
+            /**
+            * @brief Current and previous file: a writer holding a stale
+            *        slot only touches its counters before retrying, so
+            *        slots are reused instead of freed.
+            */
+            file m_slots[2];
+            /**
+            * @brief Current file.
+            */
+            std::atomic<file *> m_current;
+            /**
+            * @brief See dropped().
+            */
+            std::atomic<uint64_t> m_dropped;
+            /**
+            * @brief See file_count().
+            */
+            std::atomic<uint64_t> m_file_count;
+    };
+
+    /**
+    * @brief Record read from a capture file.
+    */
+    struct capture_record {
+        /**
+        * @brief Time of record in ns on CLOCK_MONOTONIC.
+        */
+        uint64_t timestamp;
+        /**
+        * @brief Port id.
+        */
+        uint16_t port;
+        /**
+        * @brief Type of record.
+        */
+        capture::direction dir;
+        /**
+        * @brief Raw bytes, valid as long as reader exists.
+        */
+        const uint8_t *data;
+        /**
+        * @brief Number of bytes.
+        */
+        size_t size;
+    };
+
+    /**
+    * @brief Iterate over records of a capture file.
+    *
+    * File is mapped read only, so it may be read while it is written: only
+    * completely written records are returned.
+    */
+    class capture_reader {
+
+        public:
+            /**
+            * @brief Open a capture file.
+            *
+            * @param path Path of capture file.
+            *
+            * The following exception may occur:
+            *   - com::exception::runtime_error when file can not be read or
+            *     is not a capture file.
+            */
+            explicit capture_reader(const std::string &path);
+            ~capture_reader();
+
+            /**
+            * @brief Get next record.
+            *
+            * @param r Output record.
+            *
+            * @return false at end of file.
+            */
+            bool next(capture_record &r);
+
+            /**
+            * @brief Get path name of a port defined by records already read.
+            *
+            * @param port Port id.
+            *
+            * @return Path name, empty when port is unknown.
+            */
+            std::string port_name(uint16_t port) const;
+
+            /**
+            * @brief Get CLOCK_REALTIME time of file creation.
+            *
+            * @return Time in ns since epoch.
+            */
+            uint64_t start_realtime() const;
+            /**
+            * @brief Get CLOCK_MONOTONIC time of file creation.
+            *
+            * @return Time in ns.
+            */
+            uint64_t start_monotonic() const;
+
+        private:
+            capture_reader(const capture_reader &) = delete;
+            capture_reader &operator=(const capture_reader &) = delete;
+
+            /**
+            * @brief Start of mapping.
+            */
+            const uint8_t *m_base;
+            /**
+            * @brief Size of mapping.
+            */
+            size_t m_size;
+            /**
+            * @brief Offset of next record.
+            */
+            size_t m_offset;
+            /**
+            * @brief Path name of ports, by id.
+            */
+            std::vector<std::string> m_ports;
+    };
+
+};
+
+#endif /* end of include guard: CAPTURE_H_M3XQ8KTV */
@@ -13,12 +13,122 @@ extern "C" {
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <sys/uio.h>
 
 /**
 * @brief Generic I/O error code.
 */
 #define COMSER_IOERROR                              (0x7fffffff)
 
+/**
+* @brief No flow control.
+*/
+#define COMSER_FLOW_NONE                            (0)
+/**
+* @brief Hardware flow control with RTS/CTS lines.
+*/
+#define COMSER_FLOW_HARDWARE                        (1)
+/**
+* @brief Software flow control with XON/XOFF characters.
+*/
+#define COMSER_FLOW_SOFTWARE                        (2)
+
+/**
+* @brief Apply new configuration immediately.
+*/
+#define COMSER_APPLY_NOW                            (0)
+/**
+* @brief Apply new configuration once pending output has been transmitted.
+*/
+#define COMSER_APPLY_DRAIN                          (1)
+/**
+* @brief Apply new configuration once pending output has been transmitted and
+*        discard pending input.
+*/
+#define COMSER_APPLY_FLUSH                          (2)
+
+/**
+* @brief Complete line configuration of a serial device.
+*/
+typedef struct {
+    /**
+    * @brief Speed in bps.
+    */
+    unsigned int speed;
+    /**
+    * @brief Data size in bits.
+    */
+    unsigned int data_size;
+    /**
+    * @brief Stop size in bit(s).
+    */
+    unsigned int stop_size;
+    /**
+    * @brief Parity ('n', 'e' or 'o').
+    */
+    char parity;
+    /**
+    * @brief Flow control mode (COMSER_FLOW_NONE, COMSER_FLOW_HARDWARE or
+    *        COMSER_FLOW_SOFTWARE).
+    */
+    int flow_control;
+} comserial_config_t;
+
+/**
+* @brief Number of latency histogram buckets in comserial_io_stats_t.
+*/
+#define COMSER_LATENCY_BUCKETS                      (32)
+
+/**
+* @brief I/O statistics of a serial device in one direction.
+*/
+typedef struct {
+    /**
+    * @brief Number of bytes transferred.
+    */
+    uint64_t bytes;
+    /**
+    * @brief Number of I/O calls on device, including failed ones.
+    */
+    uint64_t calls;
+    /**
+    * @brief Number of system calls done on device by I/O calls.
+    */
+    uint64_t syscalls;
+    /**
+    * @brief Number of calls ended by a timeout.
+    */
+    uint64_t timeouts;
+    /**
+    * @brief Number of bytes transferred by calls ended by a timeout.
+    */
+    uint64_t timeout_bytes;
+    /**
+    * @brief Number of calls ended by any other error.
+    */
+    uint64_t errors;
+    /**
+    * @brief Histogram of call durations: bucket 0 counts calls shorter than
+    *        1us, bucket i counts calls from 2^(i-1) to 2^i us and last bucket
+    *        also counts any longer call.
+    */
+    uint64_t latency[COMSER_LATENCY_BUCKETS];
+} comserial_io_stats_t;
+
+/**
+* @brief I/O statistics of a serial device.
+*/
+typedef struct {
+    /**
+    * @brief Statistics of data received from device.
+    */
+    comserial_io_stats_t read;
+    /**
+    * @brief Statistics of data sent to device.
+    */
+    comserial_io_stats_t write;
+} comserial_stats_t;
+
 /**
 * @brief Opaque structure symbolizing a serial com device.
 */
@@ -86,6 +196,8 @@ unsigned int comserial_get_speed(const comserial_t device);
 *   - 57600
 *   - 115200
 *   - 230400
+*   - 460800 up to 4000000 standard speeds when system knows them
+*   - any other non null speed on Linux, set with termios2
 *
 * @return Old speed of device or 0 on error (invalid speed or invalid device).
 */
@@ -164,6 +276,59 @@ char comserial_get_parity(const comserial_t device);
 */
 char comserial_set_parity(comserial_t device, char parity);
 
+/**
+* @brief Retrieve current flow control mode of given device.
+*
+* @param device Requested device.
+*
+* @return COMSER_FLOW_NONE, COMSER_FLOW_HARDWARE or COMSER_FLOW_SOFTWARE, or
+*         -1 if given device is invalid.
+*/
+int comserial_get_flow_control(const comserial_t device);
+/**
+* @brief Set a new flow control mode on given device.
+*
+* @param device Requested device.
+* @param mode New flow control mode.
+*
+* Authorized value are:
+*   - COMSER_FLOW_NONE (default)
+*   - COMSER_FLOW_HARDWARE for RTS/CTS flow control
+*   - COMSER_FLOW_SOFTWARE for XON/XOFF flow control
+*
+* @return Old flow control mode or -1 on error (invalid mode or invalid
+*         device).
+*/
+int comserial_set_flow_control(comserial_t device, int mode);
+
+/**
+* @brief Retrieve whole line configuration of given device.
+*
+* @param device Requested device.
+* @param config Output configuration (parity in lower case).
+*
+* @return 0 on success or -1 if given device or config is invalid.
+*/
+int comserial_get_config(const comserial_t device, comserial_config_t *config);
+/**
+* @brief Set speed, data size, stop size, parity and flow control of given
+*        device at once.
+*
+* @param device Requested device.
+* @param config New configuration to set.
+* @param when When configuration takes effect: COMSER_APPLY_NOW,
+*        COMSER_APPLY_DRAIN or COMSER_APPLY_FLUSH.
+*
+* Whole configuration is validated first and committed in a single step, so
+* on error device configuration is left unchanged. Applying the configuration
+* already set does nothing.
+*
+* @return 0 on success or -1 on error (invalid device, configuration or
+*         @em when value).
+*/
+int comserial_apply_config(comserial_t device, const comserial_config_t *config,
+                           int when);
+
 /**
 * @brief Retrieve the current read timeout registered in device.
 *
@@ -228,6 +393,54 @@ ssize_t comserial_write_buffer(const comserial_t device, const uint8_t *buffer,
 */
 ssize_t comserial_read_buffer(const comserial_t device, uint8_t *buffer, size_t length);
 
+/**
+* @brief Write many data buffers on serial device, in order.
+*
+* @param device Device where data will be written.
+* @param iov Array of buffers to write.
+* @param count Number of buffers in array.
+*
+* @return Same as comserial_write_buffer(), for the total size of buffers.
+*/
+ssize_t comserial_write_buffers(const comserial_t device, const struct iovec *iov, size_t count);
+/**
+* @brief Read data on serial device into many buffers, in order.
+*
+* @param device Device where data will be read.
+* @param iov Array of buffers to fill.
+* @param count Number of buffers in array.
+*
+* @return Same as comserial_read_buffer(), for the total size of buffers.
+*/
+ssize_t comserial_read_buffers(const comserial_t device, const struct iovec *iov, size_t count);
+/**
+* @brief Read data on serial device up to any of given delimiters.
+*
+* @param device Device where data will be read.
+* @param delimiters Bytes ending a message.
+* @param count Number of delimiters.
+* @param buffer Output buffer where read data is stored.
+* @param length Size of buffer.
+*
+* @return Amount of byte(s) read, including delimiter, or length if buffer is
+*         full before any delimiter is found. Errors are reported like
+*         comserial_read_buffer(). Bytes received after delimiter are kept for
+*         next read on device.
+*/
+ssize_t comserial_read_until(const comserial_t device, const uint8_t *delimiters, size_t count, uint8_t *buffer, size_t length);
+
+/**
+* @brief Retrieve I/O statistics of given device since it was opened.
+*
+* @param device Requested device.
+* @param stats Output statistics.
+*
+* Statistics are always collected and may be retrieved from any thread.
+*
+* @return 0 on success or -1 if given device or stats is invalid.
+*/
+int comserial_get_stats(const comserial_t device, comserial_stats_t *stats);
+
 #ifdef __cplusplus
 };
 #endif
@@ -0,0 +1,204 @@
+/**
+* @file cobs.h
+* @brief COBS framing (Consistent Overhead Byte Stuffing) over a serial
+*        device.
+* @author Adrien Oliva
+* @date 2026-10-17
+*/
+#ifndef COBS_H_M8RT3VQK
+#define COBS_H_M8RT3VQK
+
+#include <comserial/cppcomserial.h>
+#include <comserial/frame.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <vector>
+
+namespace com {
+
+    /**
+    * @brief COBS encoding.
+    *
+    * Zero bytes are removed from a frame: it is sent as blocks made of a
+    * code byte, the offset of next zero, followed by up to 254 non zero
+    * bytes. Encoded frames contain no zero, so a single zero byte ends
+    * each frame on the link, and encoding adds at most one byte per 254.
+    *
+    * Zero bytes are searched with memchr(), vectorized by C library, and
+    * blocks are copied at once.
+    */
+    namespace cobs {
+
+        /**
+        * @brief Frame delimiter.
+        */
+        static const uint8_t DELIMITER = 0x00;
+
+        /**
+        * @brief Get largest size of an encoded frame, delimiter excluded.
+        *
+        * @param size Size of frame.
+        *
+        * @return Size of buffer needed by encode().
+        */
+        inline size_t max_encoded_size(size_t size)
+        {
+            return size + size / 254 + 1;
+        }
+
+        /**
+        * @brief Encode a frame.
+        *
+        * @param data Frame content.
+        * @param size Size of frame.
+        * @param buffer Output buffer, at least max_encoded_size(size)
+        *        bytes long.
+        *
+        * @return Size of encoded frame, delimiter excluded.
+        *
+        * To encode in place, frame must be stored at buffer +
+        * max_encoded_size(size) - size.
+        */
+        size_t encode(const uint8_t *data, size_t size, uint8_t *buffer);
+
+        /**
+        * @brief Decode a frame.
+        *
+        * @param data Encoded frame, delimiter excluded.
+        * @param size Size of encoded frame.
+        * @param buffer Output buffer, at least size bytes long. It may be
+        *        data itself to decode in place.
+        * @param ec Output error code, cleared on success. It is
+        *        std::errc::bad_message when data is not a valid frame.
+        *
+        * @return Size of decoded frame, 0 on error.
+        */
+        size_t decode(const uint8_t *data, size_t size, uint8_t *buffer,
+                      std::error_code &ec);
+
+    };
+
+    /**
+    * @brief Read and write COBS frames on a serial device.
+    *
+    * Device is read by large chunks in a receive buffer where frames are
+    * decoded in place: read_frame() returns a view of receive buffer, so
+    * receiving frames does not copy nor allocate any memory. A view is only
+    * valid until next read function is called.
+    *
+    * Like com::serial, an instance must only be used by one thread at a
+    * time.
+    */
+    class cobs_serial {
+
+        public:
+            /**
+            * @brief Start framing a device.
+            *
+            * @param device Device to use. Device must outlive this instance
+            *        and must not be read directly anymore.
+            * @param mtu Largest frame size (default to 1024).
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when mtu is 0.
+            */
+            explicit cobs_serial(serial &device, size_t mtu = 1024);
+
+            /**
+            * @brief Read next frame.
+            *
+            * @return View of frame in receive buffer, valid until next read
+            *         function is called.
+            *
+            * Each wait for data is bounded by read timeout of device. A
+            * frame partially received on timeout is completed by next call.
+            *
+            * The following exception may occur:
+            *   - com::exception::timeout when read timeout is reached.
+            *   - com::exception::runtime_error on a device error.
+            */
+            frame read_frame();
+            /**
+            * @brief Read next frame without throwing.
+            *
+            * @param ec Output error code, cleared on success.
+            *
+            * @return View of frame in receive buffer, valid until next read
+            *         function is called, with a NULL data on error.
+            */
+            frame try_read_frame(std::error_code &ec);
+
+            /**
+            * @brief Encode and write a frame.
+            *
+            * @param data Frame content.
+            * @param size Size of frame.
+            *
+            * @return Size of frame.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when data is NULL, or size is
+            *     0 or larger than mtu.
+            *   - See serial::write_buffer() for write errors.
+            */
+            size_t write_frame(const uint8_t *data, size_t size);
+
+            /**
+            * @brief Get number of received frames dropped because they are
+            *        larger than mtu or malformed.
+            *
+            * @return Number of frames.
+            */
+            uint64_t dropped() const;
+
+            /**
+            * @brief Retrieve framed device.
+            *
+            * @return Device given at construction.
+            */
+            serial &device();
+
+        private:
+            /**
+            * @brief Framed device.
+            */
+            serial &m_device;
+            /**
+            * @brief Largest frame size.
+            */
+            size_t m_mtu;
+            /**
+            * @brief Receive buffer.
+            */
+            std::vector<uint8_t> m_input;
+            /**
+            * @brief Start of first frame not returned yet in receive buffer.
+            */
+            size_t m_start;
+            /**
+            * @brief Position from which delimiter is still to be searched.
+            */
+            size_t m_scan;
+            /**
+            * @brief End of received data.
+            */
+            size_t m_end;
+            /**
+            * @brief Set while an oversized frame is skipped.
+            */
+            bool m_discard;
+            /**
+            * @brief Number of dropped frames.
+            */
+            uint64_t m_dropped;
+            /**
+            * @brief Buffer of encoded frames.
+            */
+            std::vector<uint8_t> m_output;
+    };
+
+};
+
+#endif /* end of include guard: COBS_H_M8RT3VQK */
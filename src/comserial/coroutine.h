@@ -0,0 +1,577 @@
+/**
+* @file coroutine.h
+* @brief C++20 coroutine support for serial devices.
+* @author Adrien Oliva
+* @date 2026-10-16
+*
+* This component is optional and only available when library is built with
+* `--enable-coroutines` configure switch. It requires a C++20 compiler, so
+* it is not included from comserial.h.
+*/
+#ifndef COROUTINE_H_B6WJ0TRE
+#define COROUTINE_H_B6WJ0TRE
+
+#if __cplusplus < 202002L
+#   error "comserial/coroutine.h requires C++20"
+#endif
+
+#include <comserial/cppcomserial.h>
+#include <comserial/reactor.h>
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <list>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace com {
+
+    template <typename T = void>
+    class task;
+
+    class executor;
+
+    /**
+    * @brief Internal details of coroutine support.
+    */
+    namespace detail {
+
+        /**
+        * @brief Common part of task promises.
+        */
+        struct promise_base {
+            /**
+            * @brief Awaiter of final suspend point, that resumes awaiting
+            *        coroutine if any.
+            */
+            struct final_awaiter {
+                /**
+                * @brief Always suspend at final point.
+                *
+                * @return false.
+                */
+                bool await_ready() const noexcept { return false; }
+
+                /**
+                * @brief Transfer control to awaiting coroutine.
+                *
+                * @param h Handle of finished coroutine.
+                *
+                * @return Coroutine to resume.
+                */
+                template <typename P>
+                std::coroutine_handle<> await_suspend(
+                        std::coroutine_handle<P> h) noexcept
+                {
+                    promise_base &p = h.promise();
+                    if (p.continuation)
+                        return p.continuation;
+                    return std::noop_coroutine();
+                }
+
+                /**
+                * @brief Never resumed.
+                */
+                void await_resume() const noexcept { }
+            };
+
+            /**
+            * @brief Tasks are lazily started.
+            *
+            * @return Awaiter that always suspends.
+            */
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            /**
+            * @brief Resume awaiting coroutine at end of task.
+            *
+            * @return Final awaiter.
+            */
+            final_awaiter final_suspend() const noexcept { return {}; }
+            /**
+            * @brief Store exception thrown by task body.
+            */
+            void unhandled_exception() { error = std::current_exception(); }
+
+            /**
+            * @brief Coroutine to resume once task is done.
+            */
+            std::coroutine_handle<> continuation;
+            /**
+            * @brief Exception thrown by task body.
+            */
+            std::exception_ptr error;
+        };
+
+        /**
+        * @brief Promise of a task returning a value.
+        */
+        template <typename T>
+        struct promise : promise_base {
+            /**
+            * @brief Build task bound to this promise.
+            *
+            * @return New task.
+            */
+            task<T> get_return_object() noexcept;
+            /**
+            * @brief Store value returned by task.
+            *
+            * @param v Returned value.
+            */
+            void return_value(T v) { value.emplace(std::move(v)); }
+            /**
+            * @brief Get result of task, rethrowing its exception if any.
+            *
+            * @return Returned value.
+            */
+            T result()
+            {
+                if (error)
+                    std::rethrow_exception(error);
+                return std::move(*value);
+            }
+
+            /**
+            * @brief Value returned by task.
+            */
+            std::optional<T> value;
+        };
+
+        /**
+        * @brief Promise of a task returning nothing.
+        */
+        template <>
+        struct promise<void> : promise_base {
+            /**
+            * @brief Build task bound to this promise.
+            *
+            * @return New task.
+            */
+            task<void> get_return_object() noexcept;
+            /**
+            * @brief End of task.
+            */
+            void return_void() const noexcept { }
+            /**
+            * @brief Rethrow exception of task if any.
+            */
+            void result()
+            {
+                if (error)
+                    std::rethrow_exception(error);
+            }
+        };
+
+    };
+
+    /**
+    * @brief Lazily started coroutine, that can be awaited by another task or
+    *        spawned on an executor.
+    */
+    template <typename T>
+    class task {
+
+        public:
+            /**
+            * @brief Promise type of coroutine.
+            */
+            typedef detail::promise<T> promise_type;
+            /**
+            * @brief Handle type of coroutine.
+            */
+            typedef std::coroutine_handle<promise_type> handle_type;
+
+            /**
+            * @brief Create a task from its coroutine handle.
+            *
+            * @param h Handle of coroutine, owned by new task.
+            */
+            explicit task(handle_type h) noexcept : m_handle(h) { }
+            /**
+            * @brief Move a task.
+            *
+            * @param other Moved task.
+            */
+            task(task &&other) noexcept
+                : m_handle(std::exchange(other.m_handle, nullptr)) { }
+            task(const task &) = delete;
+            task &operator=(const task &) = delete;
+            ~task()
+            {
+                if (m_handle)
+                    m_handle.destroy();
+            }
+
+            /**
+            * @brief Task is never ready before being awaited.
+            *
+            * @return false.
+            */
+            bool await_ready() const noexcept { return false; }
+            /**
+            * @brief Start task and resume caller once it is done.
+            *
+            * @param caller Awaiting coroutine.
+            *
+            * @return Handle of task to start.
+            */
+            std::coroutine_handle<> await_suspend(
+                    std::coroutine_handle<> caller) noexcept
+            {
+                m_handle.promise().continuation = caller;
+                return m_handle;
+            }
+            /**
+            * @brief Get result of task.
+            *
+            * @return Value returned by task.
+            */
+            T await_resume() { return m_handle.promise().result(); }
+
+            /**
+            * @brief Give up ownership of coroutine.
+            *
+            * @return Handle of coroutine.
+            */
+            handle_type release() noexcept
+            {
+                return std::exchange(m_handle, nullptr);
+            }
+
+        private:
+            /**
+            * @brief Coroutine handle.
+            */
+            handle_type m_handle;
+    };
+
+    namespace detail {
+
+        template <typename T>
+        inline task<T> promise<T>::get_return_object() noexcept
+        {
+            return task<T>(std::coroutine_handle<promise<T>>::from_promise(*this));
+        }
+
+        inline task<void> promise<void>::get_return_object() noexcept
+        {
+            return task<void>(std::coroutine_handle<promise<void>>::from_promise(*this));
+        }
+
+    };
+
+    /**
+    * @brief Single threaded executor resuming coroutines once the devices
+    *        they wait for are ready.
+    *
+    * Readiness of devices is watched through a com::reactor, so a single
+    * thread can run thousands of concurrent transactions. At most one read
+    * and one write operation may wait on a device at a time.
+    *
+    * Like com::reactor, an executor must be driven by a single thread and
+    * only stop() may be called from another thread.
+    */
+    class executor {
+
+        public:
+            /**
+            * @brief Clock used for operation deadlines.
+            */
+            typedef std::chrono::steady_clock clock;
+
+            /**
+            * @brief Awaitable returned by wait().
+            */
+            class awaiter {
+
+                public:
+                    /**
+                    * @brief Build a wait operation.
+                    *
+                    * @param owner Executor running operation.
+                    * @param device Device to wait for.
+                    * @param events reactor::readable or reactor::writable.
+                    * @param deadline Time limit of wait.
+                    */
+                    awaiter(executor &owner, serial &device,
+                            unsigned int events, clock::time_point deadline);
+
+                    /**
+                    * @brief Always suspend, caller is expected to have tried
+                    *        its operation first.
+                    *
+                    * @return false.
+                    */
+                    bool await_ready() const noexcept { return false; }
+                    /**
+                    * @brief Register wait in executor.
+                    *
+                    * @param h Waiting coroutine.
+                    */
+                    void await_suspend(std::coroutine_handle<> h);
+                    /**
+                    * @brief Get events that occurred.
+                    *
+                    * @return Events that occurred (see com::reactor::event),
+                    *         0 if deadline was reached.
+                    */
+                    unsigned int await_resume() const noexcept
+                    {
+                        return m_occurred;
+                    }
+
+                private:
+                    friend class executor;
+
+                    /**
+                    * @brief Executor running operation.
+                    */
+                    executor &m_owner;
+                    /**
+                    * @brief Device waited for.
+                    */
+                    serial &m_device;
+                    /**
+                    * @brief Events waited for.
+                    */
+                    unsigned int m_events;
+                    /**
+                    * @brief Events that occurred.
+                    */
+                    unsigned int m_occurred;
+                    /**
+                    * @brief Time limit of wait.
+                    */
+                    clock::time_point m_deadline;
+                    /**
+                    * @brief Position in executor timers.
+                    */
+                    std::multimap<clock::time_point, awaiter *>::iterator m_timer;
+                    /**
+                    * @brief Waiting coroutine.
+                    */
+                    std::coroutine_handle<> m_handle;
+            };
+
+            /**
+            * @brief Create a new executor.
+            *
+            * @param batch_size Maximum number of device events handled at
+            *        once (see com::reactor).
+            */
+            explicit executor(size_t batch_size = 64);
+            ~executor();
+
+            executor(const executor &) = delete;
+            executor &operator=(const executor &) = delete;
+
+            /**
+            * @brief Start a task and keep it running until it is done.
+            *
+            * @param t Task to run, owned by executor.
+            *
+            * Task is started immediately, up to its first suspension point.
+            */
+            void spawn(task<void> t);
+
+            /**
+            * @brief Wait for device events and resume ready coroutines once.
+            *
+            * @param timeout Maximum time to wait in ms (-1 to wait forever).
+            *
+            * @return Number of resumed coroutines.
+            *
+            * An exception escaping a spawned task is rethrown here, once the
+            * task is released.
+            */
+            size_t run_once(int timeout = -1);
+            /**
+            * @brief Run until all spawned tasks are done or stop() is called.
+            */
+            void run();
+            /**
+            * @brief Ask run() to return, from any thread.
+            */
+            void stop();
+
+            /**
+            * @brief Get number of spawned tasks still running.
+            *
+            * @return Number of tasks.
+            */
+            size_t size() const;
+
+            /**
+            * @brief Wait for a device to be ready.
+            *
+            * @param device Device to wait for.
+            * @param events reactor::readable or reactor::writable.
+            * @param deadline Time limit of wait.
+            *
+            * @return Awaitable, resuming with the events that occurred or 0
+            *         when deadline is reached.
+            *
+            * The following exception may occur once awaited:
+            *   - com::exception::invalid_input when another coroutine already
+            *     waits for the same event on device.
+            */
+            awaiter wait(serial &device, unsigned int events,
+                         clock::time_point deadline);
+
+        private:
+            /**
+            * @brief Coroutines waiting on a device.
+            */
+            struct waiters {
+                /**
+                * @brief Waiting reader, if any.
+                */
+                awaiter *reader;
+                /**
+                * @brief Waiting writer, if any.
+                */
+                awaiter *writer;
+                /**
+                * @brief Events registered in reactor (0 when device is not
+                *        registered).
+                */
+                unsigned int events;
+            };
+
+            /**
+            * @brief Register a suspended wait.
+            *
+            * @param op Wait operation.
+            */
+            void suspend(awaiter *op);
+            /**
+            * @brief Terminate a wait and schedule its coroutine.
+            *
+            * @param op Wait operation.
+            * @param occurred Events that occurred (0 on timeout).
+            */
+            void wake(awaiter *op, unsigned int occurred);
+            /**
+            * @brief Handle events reported by reactor.
+            *
+            * @param device Ready device.
+            * @param events Events that occurred.
+            */
+            void on_event(serial &device, unsigned int events);
+            /**
+            * @brief Update reactor registration of a device.
+            *
+            * @param device Device to update.
+            * @param w Current waiters of device.
+            */
+            void update(serial &device, waiters &w);
+            /**
+            * @brief Compute reactor timeout from next deadline.
+            *
+            * @param timeout Maximum timeout requested by caller.
+            *
+            * @return Timeout in ms.
+            */
+            int next_timeout(int timeout) const;
+
+        private:
+            /**
+            * @brief Reactor watching devices.
+            */
+            reactor m_reactor;
+            /**
+            * @brief Waiting coroutines, indexed by device file descriptor.
+            */
+            std::map<int, waiters> m_waiters;
+            /**
+            * @brief Pending deadlines.
+            */
+            std::multimap<clock::time_point, awaiter *> m_timers;
+            /**
+            * @brief Coroutines ready to be resumed.
+            */
+            std::vector<std::coroutine_handle<>> m_ready;
+            /**
+            * @brief Running spawned tasks.
+            */
+            std::list<std::coroutine_handle<detail::promise<void>>> m_tasks;
+            /**
+            * @brief Set by stop().
+            */
+            std::atomic<bool> m_stopped;
+    };
+
+    /**
+    * @brief Read a whole buffer from a device.
+    *
+    * @param ex Executor running operation.
+    * @param device Device to read.
+    * @param buffer Output buffer where read data is stored.
+    * @param length Size of buffer to read.
+    *
+    * @return Task resulting in the amount of byte(s) read, always length.
+    *
+    * This is the asynchronous version of serial::read_buffer(), bound by
+    * device read timeout.
+    *
+    * The following exception may occur once awaited:
+    *   - com::exception::invalid_input when input buffer is invalid.
+    *   - com::exception::runtime_error when device fails.
+    *   - com::exception::timeout when read timeout is reached.
+    */
+    task<size_t> async_read(executor &ex, serial &device, uint8_t *buffer,
+                            size_t length);
+    /**
+    * @brief Write a whole buffer on a device.
+    *
+    * @param ex Executor running operation.
+    * @param device Device where data is written.
+    * @param buffer Input data to write, that must remain valid until task
+    *        is done.
+    * @param length Size of buffer to write.
+    *
+    * @return Task resulting in the amount of byte(s) written, always length.
+    *
+    * This is the asynchronous version of serial::write_buffer(), bound by
+    * device write timeout.
+    *
+    * The following exception may occur once awaited:
+    *   - com::exception::invalid_input when input buffer is invalid.
+    *   - com::exception::runtime_error when device fails.
+    *   - com::exception::timeout when write timeout is reached.
+    */
+    task<size_t> async_write(executor &ex, serial &device,
+                             const uint8_t *buffer, size_t length);
+    /**
+    * @brief Read from a device up to a delimiter.
+    *
+    * @param ex Executor running operation.
+    * @param device Device to read.
+    * @param buffer Output buffer where read data is stored.
+    * @param length Size of buffer.
+    * @param delimiter Byte ending a message.
+    *
+    * @return Task resulting in the amount of byte(s) read, including
+    *         delimiter, or length if buffer is full before delimiter is
+    *         found.
+    *
+    * Data received after delimiter are kept in read ahead buffer of device
+    * (see serial::peek_available()), so they are returned by the next read
+    * function, asynchronous or not.
+    *
+    * The following exception may occur once awaited:
+    *   - com::exception::invalid_input when input buffer is invalid.
+    *   - com::exception::runtime_error when device fails.
+    *   - com::exception::timeout when read timeout is reached.
+    */
+    task<size_t> async_read_until(executor &ex, serial &device,
+                                  uint8_t *buffer, size_t length,
+                                  uint8_t delimiter);
+
+};
+
+#endif /* end of include guard: COROUTINE_H_B6WJ0TRE */
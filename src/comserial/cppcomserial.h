@@ -7,13 +7,109 @@
 #ifndef CPPSERIALCOMM_H_JSJEFHWR
 #define CPPSERIALCOMM_H_JSJEFHWR
 
+#include <comserial/capture.h>
 #include <comserial/exceptions.h>
+#include <comserial/stats.h>
 
 #include <string>
+#include <system_error>
+#include <vector>
+#include <ctime>
 #include <termios.h>
+#include <sys/uio.h>
 
 namespace com {
 
+    /**
+    * @brief Flow control mode of a serial device.
+    */
+    enum flow_control {
+        /**
+        * @brief No flow control.
+        */
+        flow_none = 0,
+        /**
+        * @brief Hardware flow control with RTS/CTS lines.
+        */
+        flow_hardware = 1,
+        /**
+        * @brief Software flow control with XON/XOFF characters, which can
+        *        then not be part of transferred data.
+        */
+        flow_software = 2
+    };
+
+    /**
+    * @brief Complete line configuration of a serial device.
+    */
+    struct serial_config {
+        /**
+        * @brief Build a configuration (default to 19200 bps, 8n1, without
+        *        flow control).
+        *
+        * @param s Speed in bps.
+        * @param d Data size in bits.
+        * @param st Stop size in bit(s).
+        * @param p Parity ('n', 'e' or 'o').
+        * @param f Flow control mode.
+        */
+        serial_config(unsigned int s = 19200, unsigned int d = 8,
+                      unsigned int st = 1, char p = 'n',
+                      flow_control f = flow_none)
+            : speed(s), data_size(d), stop_size(st), parity(p), flow(f) { }
+
+        /**
+        * @brief Speed in bps.
+        */
+        unsigned int speed;
+        /**
+        * @brief Data size in bits.
+        */
+        unsigned int data_size;
+        /**
+        * @brief Stop size in bit(s).
+        */
+        unsigned int stop_size;
+        /**
+        * @brief Parity ('n', 'e' or 'o').
+        */
+        char parity;
+        /**
+        * @brief Flow control mode.
+        */
+        flow_control flow;
+
+        bool operator==(const serial_config &other) const
+        {
+            return speed == other.speed && data_size == other.data_size
+                && stop_size == other.stop_size && parity == other.parity
+                && flow == other.flow;
+        }
+        bool operator!=(const serial_config &other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    /**
+    * @brief When a new configuration takes effect (see serial::apply()).
+    */
+    enum apply_when {
+        /**
+        * @brief Immediately.
+        */
+        apply_now = TCSANOW,
+        /**
+        * @brief Once pending output has been transmitted.
+        */
+        apply_drain = TCSADRAIN,
+        /**
+        * @brief Once pending output has been transmitted, pending input
+        *        is discarded.
+        */
+        apply_flush = TCSAFLUSH
+    };
+
     /**
     * @brief Main class at the heart of library, that provide RS-232 device
     *        abstraction.
@@ -91,6 +187,10 @@ namespace com {
             *   - 57600
             *   - 115200
             *   - 230400
+            *   - 460800 up to 4000000 standard speeds when system knows
+            *     them (460800, 500000, 576000, 921600, 1000000, ...)
+            *   - any other non null speed on Linux, set with termios2
+            *     (invalid_speed is thrown when driver rejects it)
             */
             unsigned int set_speed(unsigned int speed);
 
@@ -172,6 +272,61 @@ namespace com {
             */
             char set_parity(char parity);
 
+            /**
+            * @brief Retrieve current flow control mode of device.
+            *
+            * @return Flow control mode.
+            */
+            flow_control get_flow_control() const;
+            /**
+            * @brief Set a new flow control mode to the device.
+            *
+            * @param mode New flow control mode.
+            *
+            * @return Old flow control mode of device.
+            *
+            * With flow control, a slow receiver makes the sender wait
+            * instead of losing data. Flow control is disabled by default.
+            *
+            * The following exceptions may occur:
+            *   - com::exception::invalid_flow_control when given mode is
+            *     invalid.
+            *   - com::exception::invalid_configuration when complete
+            *     configuration failed to be set.
+            */
+            flow_control set_flow_control(flow_control mode);
+
+            /**
+            * @brief Retrieve whole line configuration of device.
+            *
+            * @return Current configuration (parity in lower case).
+            */
+            serial_config get_config() const;
+            /**
+            * @brief Set speed, data size, stop size, parity and flow control
+            *        at once.
+            *
+            * @param config New configuration to set.
+            * @param when When configuration takes effect (default to
+            *        apply_flush, like individual setters).
+            *
+            * @return Old configuration of device.
+            *
+            * Whole configuration is validated before anything is changed,
+            * then committed with a single call to tcsetattr(). Applying the
+            * configuration already set does nothing.
+            *
+            * The following exceptions may occur:
+            *   - com::exception::invalid_input when when is invalid.
+            *   - com::exception::invalid_speed, invalid_data_size,
+            *     invalid_stop_size, invalid_parity or invalid_flow_control
+            *     when a field of config is invalid (device configuration is then left unchanged).
+            *   - com::exception::invalid_configuration when complete
+            *     configuration failed to be set.
+            */
+            serial_config apply(const serial_config &config,
+                                apply_when when = apply_flush);
+
             /**
             * @brief Retrieve current read timeout set on device.
             *
@@ -212,7 +367,7 @@ namespace com {
             * The following exception may occur:
             *   - com::exception::invalid_input when input buffer is invalid
             *     (could be eigther a NULL pointer or a 0-length buffer)
-            *   - com::exception::runtime_error when system call to select or
+            *   - com::exception::runtime_error when system call to poll or
             *     write fail
             *   - com::exception::timeout when write timeout is reached.
             */
@@ -228,12 +383,377 @@ namespace com {
             * The following exception may occur:
             *   - com::exception::invalid_input when input buffer is invalid
             *     (could be eigther a NULL pointer or a 0-length buffer)
-            *   - com::exception::runtime_error when system call to select or
+            *   - com::exception::runtime_error when system call to poll or
             *     read fail
             *   - com::exception::timeout when read timeout is reached.
             */
             size_t read_buffer(uint8_t *buffer, size_t length);
 
+            /**
+            * @brief Write many data buffers on serial device with a single
+            *        system call.
+            *
+            * @param iov Array of buffers to write, in order.
+            * @param count Number of buffers in array.
+            *
+            * @return Total amount of byte(s) successfully written on device.
+            *
+            * This is the scatter/gather version of write_buffer(), that
+            * avoids to concatenate a frame before writing it. The whole
+            * transfer is bound by a single write timeout.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when buffer array is invalid
+            *     (a NULL array, a NULL buffer with non zero length or a
+            *     0-length total)
+            *   - com::exception::runtime_error when system call to poll or
+            *     write fail
+            *   - com::exception::timeout when write timeout is reached.
+            */
+            size_t write_buffers(const struct iovec *iov, size_t count);
+            /**
+            * @brief Read data on serial device into many buffers.
+            *
+            * @param iov Array of buffers to fill, in order.
+            * @param count Number of buffers in array.
+            *
+            * @return Total amount of byte(s) successfully read on device.
+            *
+            * This is the scatter/gather version of read_buffer(): all
+            * buffers are filled before returning, within a single read
+            * timeout.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when buffer array is invalid
+            *     (a NULL array, a NULL buffer with non zero length or a
+            *     0-length total)
+            *   - com::exception::runtime_error when system call to poll or
+            *     read fail
+            *   - com::exception::timeout when read timeout is reached.
+            */
+            size_t read_buffers(const struct iovec *iov, size_t count);
+
+            /**
+            * @brief Write some data on serial device without throwing.
+            *
+            * @param buffer Input data to write.
+            * @param length Size of buffer to write.
+            * @param ec Output error code, cleared on success.
+            *
+            * @return Amount of byte(s) written on device by a single write
+            *         system call, once device accepts data.
+            *
+            * Unlike write_buffer(), this function never throws and returns
+            * as soon as some data are written. Possible errors are:
+            *   - std::errc::invalid_argument when input buffer is invalid
+            *     (could be eigther a NULL pointer or a 0-length buffer)
+            *   - std::errc::timed_out when write timeout is reached.
+            *   - a std::system_category() error when system call to poll or
+            *     write fail.
+            */
+            size_t write_some(const uint8_t *buffer, size_t length,
+                              std::error_code &ec);
+            /**
+            * @brief Read some data on serial device without throwing.
+            *
+            * @param buffer Output buffer where read data is stored.
+            * @param length Size of buffer to read.
+            * @param ec Output error code, cleared on success.
+            *
+            * @return Amount of byte(s) read on device by a single read system
+            *         call, once data are available.
+            *
+            * Unlike read_buffer(), this function never throws and returns as
+            * soon as some data are read. Possible errors are the same as
+            * write_some().
+            */
+            size_t read_some(uint8_t *buffer, size_t length,
+                             std::error_code &ec);
+            /**
+            * @brief Write a whole data buffer on serial device without
+            *        throwing.
+            *
+            * @param buffer Input data to write.
+            * @param length Size of buffer to write.
+            * @param ec Output error code, cleared on success.
+            *
+            * @return Amount of byte(s) written on device, lower than length
+            *         when an error is reported.
+            *
+            * This is the non throwing version of write_buffer(): a timeout is
+            * reported as std::errc::timed_out along with the number of bytes
+            * already written. Possible errors are the same as write_some().
+            */
+            size_t try_write_exact(const uint8_t *buffer, size_t length,
+                                   std::error_code &ec);
+            /**
+            * @brief Read a whole data buffer on serial device without
+            *        throwing.
+            *
+            * @param buffer Output buffer where read data is stored.
+            * @param length Size of buffer to read.
+            * @param ec Output error code, cleared on success.
+            *
+            * @return Amount of byte(s) read on device, lower than length when
+            *         an error is reported.
+            *
+            * This is the non throwing version of read_buffer(): a timeout is
+            * reported as std::errc::timed_out along with the number of bytes
+            * already read. Possible errors are the same as write_some().
+            */
+            size_t try_read_exact(uint8_t *buffer, size_t length,
+                                  std::error_code &ec);
+
+            /**
+            * @brief Write many data buffers without throwing.
+            *
+            * @param iov Array of buffers to write, in order.
+            * @param count Number of buffers in array.
+            * @param ec Output error code, cleared on success.
+            *
+            * @return Amount of byte(s) written on device.
+            *
+            * Non throwing version of write_buffers(), reporting errors like
+            * try_write_exact().
+            */
+            size_t try_write_buffers(const struct iovec *iov, size_t count,
+                                   std::error_code &ec);
+            /**
+            * @brief Read data into many buffers without throwing.
+            *
+            * @param iov Array of buffers to fill, in order.
+            * @param count Number of buffers in array.
+            * @param ec Output error code, cleared on success.
+            *
+            * @return Amount of byte(s) read on device.
+            *
+            * Non throwing version of read_buffers(), reporting errors like
+            * try_read_exact().
+            */
+            size_t try_read_buffers(const struct iovec *iov, size_t count,
+                                  std::error_code &ec);
+
+            /**
+            * @brief Read data up to a delimiter.
+            *
+            * @param delimiter Byte ending a message.
+            * @param buffer Output buffer where read data is stored.
+            * @param length Size of buffer.
+            *
+            * @return Amount of byte(s) read, including delimiter, or length
+            *         if buffer is full before delimiter is found.
+            *
+            * Device is read by large chunks into an internal read ahead
+            * buffer, where delimiter is searched with vector instructions.
+            * Bytes received after delimiter are kept and returned first by
+            * the next read function called on device, so a line protocol
+            * costs a few system calls per chunk instead of two per byte.
+            * Like read_buffer(), the whole call is bound by read timeout.
+            *
+            * Data kept ahead are not seen by wrappers reading device file
+            * descriptor directly (uring), nor by readiness of file
+            * descriptor in a reactor.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when input buffer is invalid
+            *     (could be eigther a NULL pointer or a 0-length buffer)
+            *   - com::exception::runtime_error when system call to read or
+            *     poll fail.
+            *   - com::exception::timeout when read timeout is reached, with
+            *     the number of bytes already stored in buffer.
+            */
+            size_t read_until(uint8_t delimiter, uint8_t *buffer,
+                              size_t length);
+            /**
+            * @brief Read data up to any of several delimiters.
+            *
+            * @param delimiters Bytes ending a message.
+            * @param count Number of delimiters.
+            * @param buffer Output buffer where read data is stored.
+            * @param length Size of buffer.
+            *
+            * @return Amount of byte(s) read, including delimiter, or length
+            *         if buffer is full before any delimiter is found.
+            *
+            * Same as read_until() with a single delimiter. Up to 8
+            * delimiters are searched with vector instructions.
+            */
+            size_t read_until(const uint8_t *delimiters, size_t count,
+                              uint8_t *buffer, size_t length);
+            /**
+            * @brief Read data up to any of several delimiters without
+            *        throwing.
+            *
+            * @param delimiters Bytes ending a message.
+            * @param count Number of delimiters.
+            * @param buffer Output buffer where read data is stored.
+            * @param length Size of buffer.
+            * @param ec Output error code, cleared on success.
+            *
+            * @return Amount of byte(s) read.
+            *
+            * Non throwing version of read_until(), reporting errors like
+            * try_read_exact().
+            */
+            size_t try_read_until(const uint8_t *delimiters, size_t count,
+                                  uint8_t *buffer, size_t length,
+                                  std::error_code &ec);
+
+            /**
+            * @brief Get data read ahead without copying them, reading device
+            *        once when there is none.
+            *
+            * @param data Output pointer to data read ahead, valid until next
+            *        read function is called on device.
+            * @param ec Output error code, cleared on success.
+            *
+            * @return Amount of byte(s) available at data, 0 on error.
+            *
+            * Data are not consumed: consume() must be called with the
+            * amount actually used, which is returned again by next read
+            * functions otherwise. Like read_some(), device is waited for up
+            * to read timeout. This is meant for protocol decoders working
+            * in place on received data.
+            */
+            size_t peek(const uint8_t *&data, std::error_code &ec);
+            /**
+            * @brief Drop data returned by peek().
+            *
+            * @param length Amount of byte(s) used, at most the amount
+            *        returned by peek().
+            */
+            void consume(size_t length);
+
+            /**
+            * @brief Write as much data as possible without waiting.
+            *
+            * @param buffer Input data to write.
+            * @param length Size of buffer to write.
+            *
+            * @return Amount of byte(s) written on device, possibly 0 if
+            *         device is not ready to accept data.
+            *
+            * This function is the non blocking counterpart of
+            * write_buffer(), meant to be used from a com::reactor handler.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when input buffer is invalid
+            *     (could be eigther a NULL pointer or a 0-length buffer)
+            *   - com::exception::runtime_error when system call to write
+            *     fail
+            */
+            size_t write_available(const uint8_t *buffer, size_t length);
+            /**
+            * @brief Read all data already available without waiting.
+            *
+            * @param buffer Output buffer where read data is stored.
+            * @param length Size of buffer to read
+            *
+            * @return Amount of byte(s) read on device, possibly 0 if no data
+            *         is available.
+            *
+            * This function is the non blocking counterpart of read_buffer(),
+            * meant to be used from a com::reactor handler.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when input buffer is invalid
+            *     (could be eigther a NULL pointer or a 0-length buffer)
+            *   - com::exception::runtime_error when system call to read fail
+            */
+            size_t read_available(uint8_t *buffer, size_t length);
+            /**
+            * @brief Get data read ahead without copying them nor waiting.
+            *
+            * @param data Output pointer to data read ahead, valid until next
+            *        read function is called on device.
+            *
+            * @return Amount of byte(s) available at data, possibly 0 if no
+            *         data is available.
+            *
+            * This function is the non blocking counterpart of peek(), meant
+            * to be used from a com::reactor handler. Data are consumed with
+            * consume().
+            *
+            * The following exception may occur:
+            *   - com::exception::runtime_error when system call to read fail
+            */
+            size_t peek_available(const uint8_t *&data);
+
+            /**
+            * @brief Move data from serial device to another file descriptor
+            *        without copying them in user space.
+            *
+            * @param fd Destination file descriptor (file, pipe, socket...).
+            * @param length Amount of bytes to move.
+            *
+            * @return Total amount of byte(s) moved.
+            *
+            * Data go through an internal pipe with splice(). When kernel
+            * refuses to splice device or destination, a copy loop is used
+            * instead. Like read_buffer(), the whole transfer is bound by the
+            * read timeout.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when fd or length is invalid.
+            *   - com::exception::runtime_error when a system call fail.
+            *   - com::exception::timeout when read timeout is reached.
+            */
+            size_t splice_to(int fd, size_t length);
+            /**
+            * @brief Move data from another file descriptor to serial device
+            *        without copying them in user space.
+            *
+            * @param fd Source file descriptor (file, pipe, socket...).
+            * @param length Maximum amount of bytes to move.
+            *
+            * @return Total amount of byte(s) moved, lower than length when
+            *         end of source is reached.
+            *
+            * Same as splice_to(), in the other direction, and bound by the
+            * write timeout.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when fd or length is invalid.
+            *   - com::exception::runtime_error when a system call fail.
+            *   - com::exception::timeout when write timeout is reached.
+            */
+            size_t splice_from(int fd, size_t length);
+
+            /**
+            * @brief Retrieve file descriptor of underlying device.
+            *
+            * @return File descriptor, usable to integrate device in an
+            *         external event loop.
+            *
+            * @note File descriptor remains owned by instance and must not be
+            *       closed by caller.
+            */
+            int get_fd() const;
+
+            /**
+            * @brief Retrieve I/O statistics of device since it was opened.
+            *
+            * @return Snapshot of statistics.
+            *
+            * Statistics are always collected, with relaxed atomic counters,
+            * and may be retrieved from any thread.
+            */
+            serial_stats stats() const;
+
+            /**
+            * @brief Record all data sent and received by device in a
+            *        capture.
+            *
+            * @param c Capture, which must outlive device or be detached
+            *        before, NULL to stop capture.
+            *
+            * Data moved by splice_to() and splice_from() without copy are
+            * not captured, nor data read by wrappers directly from file
+            * descriptor (buffered_serial, reactors). Capture must not be
+            * changed while device is used by another thread.
+            */
+            void set_capture(capture *c);
+
         private:
             /**
             * @brief Really open device.
@@ -291,15 +811,167 @@ namespace com {
             */
             void check_and_set_parity(char new_parity);
 
+            /**
+            * @brief Validate and store new flow control mode in object
+            *        instance.
+            *
+            * @param mode Flow control mode to validate.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_flow_control if given mode is
+            *     invalid.
+            */
+            void check_and_set_flow_control(flow_control mode);
+
             /**
             * @brief Commit the whole stored configuration on the opened
             *        device.
             *
+            * @param when tcsetattr() optional actions.
+            *
+            * A configuration with a custom speed is committed in a single
+            * termios2 call. On error, options and speed of instance are
+            * restored to the last committed ones.
+            *
             * The following exception may occur:
             *   - com::exception::invalid_configuration() if global
             *     configuration is inconsistant.
+            *   - com::exception::invalid_speed() if device rejects a custom
+            *     speed.
             */
-            void commit_termios_configuration();
+            void commit_termios_configuration(int when = TCSAFLUSH);
+
+            /**
+            * @brief Compute an absolute deadline on monotonic clock.
+            *
+            * @param timeout Delay from now in ms.
+            *
+            * @return Deadline expressed on CLOCK_MONOTONIC.
+            */
+            static struct timespec deadline_from_now(unsigned int timeout);
+            /**
+            * @brief Wait for the device to be ready until a deadline.
+            *
+            * @param events poll events to wait for (POLLIN or POLLOUT).
+            * @param deadline Absolute deadline on CLOCK_MONOTONIC.
+            *
+            * @return Positive value when device is ready, 0 when deadline is
+            *         reached or negative value on error.
+            *
+            * Unlike select(), poll() does not restrict file descriptor value
+            * to FD_SETSIZE, so any number of devices may be opened.
+            */
+            int wait_device(short events, const struct timespec &deadline) const;
+            /**
+            * @brief Wait for any file descriptor to be ready until a
+            *        deadline.
+            *
+            * @param fd File descriptor to wait for.
+            * @param events poll events to wait for (POLLIN or POLLOUT).
+            * @param deadline Absolute deadline on CLOCK_MONOTONIC.
+            *
+            * @return Same as wait_device().
+            */
+            static int wait_fd(int fd, short events,
+                               const struct timespec &deadline);
+            /**
+            * @brief Create internal splice pipe if needed.
+            *
+            * @return false if pipe can not be created.
+            */
+            bool open_pipe();
+            /**
+            * @brief Move data from a file descriptor to internal pipe.
+            *
+            * @param fd Source file descriptor.
+            * @param length Maximum amount of bytes to move.
+            * @param deadline Absolute deadline on CLOCK_MONOTONIC.
+            *
+            * @return Amount of bytes moved, 0 at end of source, or -1 with
+            *         errno set (ETIMEDOUT when deadline is reached).
+            */
+            ssize_t fill_pipe(int fd, size_t length,
+                              const struct timespec &deadline);
+            /**
+            * @brief Move all data of internal pipe to a file descriptor.
+            *
+            * @param fd Destination file descriptor.
+            * @param length Amount of bytes in pipe.
+            * @param deadline Absolute deadline on CLOCK_MONOTONIC.
+            * @param ec Output error code, left untouched on success.
+            *
+            * When kernel refuses to splice to destination, data are copied
+            * out of pipe instead.
+            */
+            void drain_pipe(int fd, size_t length,
+                            const struct timespec &deadline,
+                            std::error_code &ec);
+            /**
+            * @brief Write a whole buffer on any file descriptor.
+            *
+            * @param fd Destination file descriptor.
+            * @param buffer Data to write.
+            * @param length Size of data.
+            * @param deadline Absolute deadline on CLOCK_MONOTONIC.
+            * @param ec Output error code, left untouched on success.
+            */
+            static void write_fd(int fd, const uint8_t *buffer, size_t length,
+                                 const struct timespec &deadline,
+                                 std::error_code &ec);
+            /**
+            * @brief Close internal splice pipe.
+            */
+            void close_pipe();
+            /**
+            * @brief Wait for device and write data once.
+            *
+            * @param iov Input buffers to write.
+            * @param count Number of buffers (at most IOV_MAX).
+            * @param deadline Absolute deadline on CLOCK_MONOTONIC.
+            * @param ec Output error code, left untouched on success.
+            *
+            * @return Amount of byte(s) written on device.
+            */
+            size_t write_once(const struct iovec *iov, size_t count,
+                              const struct timespec &deadline,
+                              std::error_code &ec);
+            /**
+            * @brief Take data kept ahead, or wait for device and read data
+            *        once.
+            *
+            * @param iov Output buffers where read data is stored.
+            * @param count Number of buffers (at most IOV_MAX).
+            * @param deadline Absolute deadline on CLOCK_MONOTONIC.
+            * @param ec Output error code, left untouched on success.
+            *
+            * @return Amount of byte(s) read.
+            */
+            size_t read_once(const struct iovec *iov, size_t count,
+                             const struct timespec &deadline,
+                             std::error_code &ec);
+            /**
+            * @brief Wait for device and read data once, ignoring data kept
+            *        ahead.
+            *
+            * @param iov Output buffers where read data is stored.
+            * @param count Number of buffers (at most IOV_MAX).
+            * @param deadline Absolute deadline on CLOCK_MONOTONIC.
+            * @param ec Output error code, left untouched on success.
+            *
+            * @return Amount of byte(s) read on device.
+            */
+            size_t read_device(const struct iovec *iov, size_t count,
+                               const struct timespec &deadline,
+                               std::error_code &ec);
+            /**
+            * @brief Move data kept ahead to buffers.
+            *
+            * @param iov Output buffers.
+            * @param count Number of buffers.
+            *
+            * @return Amount of byte(s) moved.
+            */
+            size_t take_ahead(const struct iovec *iov, size_t count);
 
 
         private:
@@ -308,6 +980,10 @@ namespace com {
             */
             int m_fd;
             /**
+            * @brief Path name of device.
+            */
+            std::string m_device;
+            /**
             * @brief Current speed (in bps).
             */
             unsigned int m_speed;
@@ -324,6 +1000,11 @@ namespace com {
             */
             char m_parity;
 
+            /**
+            * @brief Current flow control mode.
+            */
+            flow_control m_flow_control;
+
             /**
             * @brief Current read timeout (in ms).
             */
@@ -337,11 +1018,70 @@ namespace com {
             * @brief Termios version of current speed.
             */
             speed_t m_termios_speed;
+            /**
+            * @brief Current speed is not a standard one and is set with
+            *        termios2.
+            */
+            bool m_custom_speed;
 
             /**
             * @brief Termios structure with all serial options.
             */
             struct termios m_options;
+            /**
+            * @brief Last options successfully committed on device.
+            */
+            struct termios m_committed_options;
+            /**
+            * @brief Speed of m_committed_options.
+            */
+            unsigned int m_committed_speed;
+            /**
+            * @brief m_committed_options speed is set with termios2.
+            */
+            bool m_committed_custom_speed;
+
+            /**
+            * @brief Pipe used by splice_to() and splice_from(), created on
+            *        first use (-1 otherwise).
+            */
+            int m_pipe[2];
+
+            /**
+            * @brief Statistics of data received from device.
+            */
+            io_counters m_read_stats;
+            /**
+            * @brief Keep write statistics away from read statistics cache
+            *        line, as they are usually updated by another thread.
+            */
+            char m_stats_padding[64];
+            /**
+            * @brief Statistics of data sent to device.
+            */
+            io_counters m_write_stats;
+
+            /**
+            * @brief Data read ahead by read_until(), allocated on first use.
+            */
+            std::vector<uint8_t> m_ahead;
+            /**
+            * @brief Position of first byte kept in m_ahead.
+            */
+            size_t m_ahead_start;
+            /**
+            * @brief Position after last byte kept in m_ahead.
+            */
+            size_t m_ahead_end;
+
+            /**
+            * @brief Capture of device traffic, NULL when disabled.
+            */
+            capture *m_capture;
+            /**
+            * @brief Port id of device in capture.
+            */
+            uint16_t m_capture_port;
     };
 
 };
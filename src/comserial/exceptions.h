@@ -195,6 +195,43 @@ namespace com
                 std::string m_what;
         };
 
+        /**
+        * @brief Exception thrown when an invalid flow control mode is given to
+        *        a serial device.
+        *
+        * The given mode is shown in exception message.
+        */
+        class invalid_flow_control : public std::exception
+        {
+            public:
+                /**
+                * @brief Constructor of an invalid flow control exception.
+                *
+                * @param mode Invalid flow control mode that cause the
+                *        exception.
+                */
+                explicit invalid_flow_control(int mode) : m_what() {
+                    std::stringstream ss;
+                    ss << "Invalid flow control (" << mode << ")";
+                    m_what.assign(ss.str());
+                }
+
+                /**
+                * @brief Get exception error message.
+                *
+                * @return Error message.
+                */
+                virtual const char *what() const throw() {
+                    return m_what.c_str();
+                }
+
+            private:
+                /**
+                * @brief Exception error message.
+                */
+                std::string m_what;
+        };
+
         /**
         * @brief Exception thrown when given device path is invalid.
         *
@@ -0,0 +1,99 @@
+/**
+* @file frame.h
+* @brief Preallocated buffers holding decoded frames.
+* @author Adrien Oliva
+* @date 2026-10-17
+*/
+#ifndef FRAME_H_W3QJ8ZLD
+#define FRAME_H_W3QJ8ZLD
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace com {
+
+    /**
+    * @brief Frame buffer taken from a com::frame_pool.
+    */
+    struct frame {
+        /**
+        * @brief Frame content.
+        */
+        uint8_t *data;
+        /**
+        * @brief Size of frame content.
+        */
+        size_t size;
+        /**
+        * @brief Size of buffer at data.
+        */
+        size_t capacity;
+    };
+
+    /**
+    * @brief Fixed set of frame buffers, all allocated at construction.
+    *
+    * Frames are handed out by acquire() and given back with release(), so
+    * that framed readers decode without any allocation once running. Pool
+    * is not thread safe: frames must be acquired and released from the same
+    * thread, or under a lock of caller.
+    */
+    class frame_pool {
+
+        public:
+            /**
+            * @brief Allocate frames.
+            *
+            * @param count Number of frames.
+            * @param capacity Size of each frame buffer.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when count or capacity is 0.
+            */
+            frame_pool(size_t count, size_t capacity);
+
+            /**
+            * @brief Take a free frame.
+            *
+            * @return Frame with a 0 size, or NULL when all frames are in use.
+            */
+            frame *acquire();
+            /**
+            * @brief Give back a frame.
+            *
+            * @param f Frame returned by acquire(), ignored when NULL.
+            */
+            void release(frame *f);
+
+            /**
+            * @brief Get number of free frames.
+            *
+            * @return Number of frames.
+            */
+            size_t available() const;
+            /**
+            * @brief Get size of frame buffers.
+            *
+            * @return Size in bytes.
+            */
+            size_t frame_capacity() const;
+
+        private:
+            /**
+            * @brief Storage of all frame buffers.
+            */
+            std::vector<uint8_t> m_storage;
+            /**
+            * @brief Frame descriptors.
+            */
+            std::vector<frame> m_frames;
+            /**
+            * @brief Stack of free frames.
+            */
+            std::vector<frame *> m_free;
+    };
+
+};
+
+#endif /* end of include guard: FRAME_H_W3QJ8ZLD */
@@ -0,0 +1,223 @@
+/**
+* @file reactor.h
+* @brief Event driven multiplexer of many serial devices.
+* @author Adrien Oliva
+* @date 2026-10-16
+*/
+#ifndef REACTOR_H_QM3XKD7A
+#define REACTOR_H_QM3XKD7A
+
+#include <comserial/cppcomserial.h>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <vector>
+#include <sys/epoll.h>
+
+namespace com {
+
+    /**
+    * @brief Dispatch readiness of many serial devices to per device handlers
+    *        through a single epoll set.
+    *
+    * Each registered device is watched for the requested events and, once
+    * ready, its handler is called with the device and the events that
+    * occurred. Handlers are expected to use the non blocking
+    * serial::read_available() and serial::write_available() calls so that a
+    * single thread can service hundreds of devices.
+    *
+    * A reactor instance is meant to be driven by a single thread: add(),
+    * modify(), remove() and run_once() must be called from that thread (or
+    * from within a handler). Only stop() may be called from another thread.
+    * To spread devices on several threads, simply use one reactor per
+    * thread.
+    */
+    class reactor {
+
+        public:
+            /**
+            * @brief Events that can be watched on a device.
+            *
+            * Values can be combined as a bit mask.
+            */
+            enum event {
+                /**
+                * @brief Data are available for reading.
+                */
+                readable = 0x1,
+                /**
+                * @brief Device is ready to accept data.
+                */
+                writable = 0x2,
+                /**
+                * @brief An error or a hang up occurs on device (always
+                *        reported, even when not requested).
+                */
+                error = 0x4,
+            };
+
+            /**
+            * @brief Callback called when a registered device is ready.
+            *
+            * First argument is the ready device, second argument is a bit
+            * mask of com::reactor::event that occurred.
+            */
+            typedef std::function<void (serial &, unsigned int)> handler;
+
+            /**
+            * @brief Create a new empty reactor.
+            *
+            * @param batch_size Maximum number of events retrieved and
+            *        dispatched by a single system call (default to 64).
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when batch size is 0.
+            *   - com::exception::runtime_error when epoll instance can not be
+            *     created.
+            */
+            explicit reactor(size_t batch_size = 64);
+            ~reactor();
+
+            /**
+            * @brief Register a new device in reactor.
+            *
+            * @param device Device to watch. Device must outlive its
+            *        registration.
+            * @param callback Handler called each time device is ready.
+            * @param events Bit mask of com::reactor::event to watch (default
+            *        to readable).
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when device is already
+            *     registered or when callback is empty.
+            *   - com::exception::runtime_error when device can not be added
+            *     in epoll set.
+            */
+            void add(serial &device, const handler &callback,
+                     unsigned int events = readable);
+            /**
+            * @brief Change watched events of an already registered device.
+            *
+            * @param device Registered device.
+            * @param events New bit mask of com::reactor::event to watch.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when device is not registered.
+            *   - com::exception::runtime_error when epoll set can not be
+            *     updated.
+            */
+            void modify(serial &device, unsigned int events);
+            /**
+            * @brief Unregister a device from reactor.
+            *
+            * @param device Device to remove.
+            *
+            * @return true if device was registered, false otherwise.
+            *
+            * @note It is safe to remove any device (including the one being
+            *       dispatched) from within a handler.
+            */
+            bool remove(serial &device);
+            /**
+            * @brief Retrieve number of registered devices.
+            *
+            * @return Number of devices.
+            */
+            size_t size() const;
+
+            /**
+            * @brief Wait for events and dispatch them to handlers.
+            *
+            * @param timeout Maximum time to wait in ms (-1 to wait forever, 0
+            *        to return immediately).
+            *
+            * @return Number of handlers called.
+            *
+            * The following exception may occur:
+            *   - com::exception::runtime_error when system call to epoll_wait
+            *     fail.
+            *
+            * Any exception thrown by a handler is propagated to the caller.
+            */
+            size_t run_once(int timeout = -1);
+            /**
+            * @brief Dispatch events until stop() is called.
+            *
+            * The following exception may occur:
+            *   - com::exception::runtime_error when system call to epoll_wait
+            *     fail.
+            */
+            void run();
+            /**
+            * @brief Ask a running reactor to return from run().
+            *
+            * This function can be called from any thread or from a handler.
+            */
+            void stop();
+
+        private:
+            /**
+            * @brief Internal information of a registered device.
+            */
+            struct registration {
+                /**
+                * @brief Registered device (NULL once removed).
+                */
+                serial *device;
+                /**
+                * @brief Handler of device.
+                */
+                handler callback;
+            };
+
+            /**
+            * @brief Convert a bit mask of com::reactor::event into epoll
+            *        events.
+            *
+            * @param events Bit mask to convert.
+            *
+            * @return epoll events.
+            */
+            static uint32_t to_epoll(unsigned int events);
+            /**
+            * @brief Convert epoll events into a bit mask of
+            *        com::reactor::event.
+            *
+            * @param events epoll events to convert.
+            *
+            * @return Bit mask of com::reactor::event.
+            */
+            static unsigned int from_epoll(uint32_t events);
+
+        private:
+            /**
+            * @brief File descriptor of epoll instance.
+            */
+            int m_epfd;
+            /**
+            * @brief Event file descriptor used to wake up a running reactor.
+            */
+            int m_wakefd;
+            /**
+            * @brief Set when stop() is requested.
+            */
+            std::atomic<bool> m_stopped;
+            /**
+            * @brief Events retrieved by last epoll_wait call.
+            */
+            std::vector<struct epoll_event> m_events;
+            /**
+            * @brief All registered devices, indexed by file descriptor.
+            */
+            std::map<int, registration *> m_registrations;
+            /**
+            * @brief Registrations removed while dispatching, released at the
+            *        end of the batch.
+            */
+            std::vector<registration *> m_removed;
+    };
+
+};
+
+#endif /* end of include guard: REACTOR_H_QM3XKD7A */
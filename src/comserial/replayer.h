@@ -0,0 +1,188 @@
+/**
+* @file replayer.h
+* @brief Replay of captured traffic on a pseudo terminal.
+* @author Adrien Oliva
+* @date 2026-10-17
+*/
+#ifndef REPLAYER_H_D9KV4TXN
+#define REPLAYER_H_D9KV4TXN
+
+#include <comserial/capture.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace com {
+
+    /**
+    * @brief Result of a replay.
+    */
+    struct replay_stats {
+        /**
+        * @brief Number of records played.
+        */
+        uint64_t records;
+        /**
+        * @brief Number of bytes fed to device.
+        */
+        uint64_t bytes;
+        /**
+        * @brief Number of bytes written by device user, and discarded.
+        */
+        uint64_t discarded;
+        /**
+        * @brief Duration of replay in ns.
+        */
+        uint64_t elapsed;
+        /**
+        * @brief Longest delay of a record behind its scheduled time in ns,
+        *        when device user does not read fast enough.
+        */
+        uint64_t max_lag;
+    };
+
+    /**
+    * @brief Feed data received by a captured device (see com::capture) to
+    *        a pseudo terminal, at recorded pace or faster.
+    *
+    * Replayer opens a pseudo terminal pair: code under test opens its slave
+    * side, with com::serial like a real device, and reads exactly what the
+    * captured device received. Anything written by code under test is read
+    * and discarded so that it never blocks.
+    *
+    * Record times are divided by a time scale: 1 replays at recorded pace,
+    * 10 ten times faster, and 0 as fast as device is read.
+    */
+    class replayer {
+
+        public:
+            /**
+            * @brief Load captured traffic and open a pseudo terminal.
+            *
+            * @param files Capture files, oldest first (`<path>.1` before
+            *        `<path>` for a rotated capture).
+            * @param port Path name of captured device to replay, empty for
+            *        first device of capture.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when no file is given or
+            *     port is not found in capture.
+            *   - com::exception::runtime_error when a file is not a capture
+            *     or pseudo terminal can not be opened.
+            */
+            explicit replayer(const std::vector<std::string> &files,
+                              const std::string &port = std::string());
+            ~replayer();
+
+            /**
+            * @brief Get path name of slave side, to open with com::serial.
+            *
+            * @return Path name.
+            */
+            const std::string &device_path() const;
+
+            /**
+            * @brief Get number of records to replay.
+            *
+            * @return Number of records.
+            */
+            size_t records() const;
+
+            /**
+            * @brief Replay all records, blocking until last one is fed.
+            *
+            * @param scale Time scale, 0 for no delay between records.
+            *
+            * @return Result of replay.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when scale is negative.
+            *   - com::exception::runtime_error when pseudo terminal fails.
+            */
+            replay_stats run(double scale = 1.0);
+
+            /**
+            * @brief Stop a replay running in another thread.
+            */
+            void stop();
+
+            /**
+            * @brief Wait until data fed to device have been read.
+            *
+            * @param timeout Maximum time to wait in ms.
+            *
+            * @return false on timeout.
+            */
+            bool wait_drained(unsigned int timeout);
+
+        private:
+            replayer(const replayer &) = delete;
+            replayer &operator=(const replayer &) = delete;
+
+            /**
+            * @brief Data of a record to replay.
+            */
+            struct chunk {
+                /**
+                * @brief Time of record relative to first one in ns.
+                */
+                uint64_t time;
+                /**
+                * @brief Offset of data in m_data.
+                */
+                size_t offset;
+                /**
+                * @brief Number of bytes.
+                */
+                size_t size;
+            };
+
+            /**
+            * @brief Write a chunk on master side, discarding data written by
+            *        device user meanwhile.
+            *
+            * @param c Chunk to write.
+            * @param stats Replay statistics to update.
+            *
+            * @return false when replay is stopped.
+            */
+            bool feed(const chunk &c, replay_stats &stats);
+            /**
+            * @brief Read and discard data written by device user.
+            *
+            * @param stats Replay statistics to update.
+            */
+            void discard(replay_stats &stats);
+
+            /**
+            * @brief Received data of replayed device, in record order.
+            */
+            std::vector<uint8_t> m_data;
+            /**
+            * @brief Records to replay.
+            */
+            std::vector<chunk> m_chunks;
+            /**
+            * @brief Master side of pseudo terminal.
+            */
+            int m_master;
+            /**
+            * @brief Slave side, kept open so that master never sees a
+            *        hang up when device user closes it.
+            */
+            int m_slave;
+            /**
+            * @brief Path name of slave side.
+            */
+            std::string m_path;
+            /**
+            * @brief Replay is stopped.
+            */
+            std::atomic<bool> m_stopped;
+    };
+
+};
+
+#endif /* end of include guard: REPLAYER_H_D9KV4TXN */
@@ -0,0 +1,241 @@
+/**
+* @file slip.h
+* @brief SLIP framing (RFC 1055) over a serial device.
+* @author Adrien Oliva
+* @date 2026-10-17
+*/
+#ifndef SLIP_H_T6NB4RXE
+#define SLIP_H_T6NB4RXE
+
+#include <comserial/cppcomserial.h>
+#include <comserial/frame.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <vector>
+
+namespace com {
+
+    /**
+    * @brief SLIP byte stuffing.
+    *
+    * Frames are terminated by END. END and ESC bytes inside a frame are
+    * sent as ESC ESC_END and ESC ESC_ESC. Encoded frames also start with
+    * END to flush line noise at receiver, and empty frames are ignored.
+    *
+    * Data are not processed byte per byte: runs of bytes without END nor
+    * ESC are found with a vectorized search and copied at once.
+    */
+    class slip_codec {
+
+        public:
+            /**
+            * @brief Frame delimiter.
+            */
+            static const uint8_t END = 0xc0;
+            /**
+            * @brief Escape byte.
+            */
+            static const uint8_t ESC = 0xdb;
+            /**
+            * @brief Escaped END.
+            */
+            static const uint8_t ESC_END = 0xdc;
+            /**
+            * @brief Escaped ESC.
+            */
+            static const uint8_t ESC_ESC = 0xdd;
+
+            /**
+            * @brief Get largest size of an encoded frame.
+            *
+            * @param size Size of frame.
+            *
+            * @return Size of buffer needed by encode().
+            */
+            static size_t max_encoded_size(size_t size)
+            {
+                return 2 * size + 2;
+            }
+            /**
+            * @brief Encode a frame.
+            *
+            * @param data Frame content.
+            * @param size Size of frame.
+            * @param buffer Output buffer, at least max_encoded_size(size)
+            *        bytes long.
+            *
+            * @return Size of encoded frame, END bytes included.
+            */
+            static size_t encode(const uint8_t *data, size_t size,
+                                 uint8_t *buffer);
+
+            slip_codec();
+
+            /**
+            * @brief Decode received data until end of a frame.
+            *
+            * @param data Received data.
+            * @param size Size of data.
+            * @param out Frame being decoded: content is appended after its
+            *        current size, up to its capacity.
+            * @param consumed Output amount of data used.
+            *
+            * @return true when out holds a complete frame, false when all
+            *         data were used without reaching end of a frame.
+            *
+            * A frame larger than out capacity, or interrupted by END right
+            * after ESC, is dropped (see dropped()) and decoding goes on
+            * with next frame. Unknown escaped bytes are kept as is, as
+            * advised by RFC 1055.
+            */
+            bool decode(const uint8_t *data, size_t size, frame &out,
+                        size_t &consumed);
+            /**
+            * @brief Forget about a partially decoded frame.
+            */
+            void reset();
+
+            /**
+            * @brief Get number of frames dropped by decode().
+            *
+            * @return Number of frames.
+            */
+            uint64_t dropped() const;
+
+        private:
+            /**
+            * @brief Set when last decoded byte is ESC.
+            */
+            bool m_escape;
+            /**
+            * @brief Set when current frame is dropped at its END.
+            */
+            bool m_discard;
+            /**
+            * @brief Number of dropped frames.
+            */
+            uint64_t m_dropped;
+    };
+
+    /**
+    * @brief Read and write SLIP frames on a serial device.
+    *
+    * Frames are decoded in place from read ahead buffer of device (see
+    * serial::peek()) into frames of a pool allocated at construction, so
+    * reading does not allocate any memory. A frame returned by read_frame()
+    * belongs to caller until it is given back with release().
+    *
+    * Like com::serial, an instance must only be used by one thread at a
+    * time.
+    */
+    class slip_serial {
+
+        public:
+            /**
+            * @brief Start framing a device.
+            *
+            * @param device Device to use. Device must outlive this instance
+            *        and must not be read directly anymore.
+            * @param mtu Largest frame size (default to 1006, see RFC 1055).
+            * @param frames Number of frames of pool, that is how many frames
+            *        caller can hold at the same time (default to 8).
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when mtu or frames is 0.
+            */
+            explicit slip_serial(serial &device, size_t mtu = 1006,
+                                 size_t frames = 8);
+
+            /**
+            * @brief Read next frame.
+            *
+            * @return Frame, to give back with release().
+            *
+            * Each wait for data is bounded by read timeout of device. A
+            * frame partially received on timeout is completed by next call.
+            *
+            * The following exception may occur:
+            *   - com::exception::timeout when read timeout is reached.
+            *   - com::exception::runtime_error when all frames of pool are
+            *     held by caller, or on a device error.
+            */
+            frame *read_frame();
+            /**
+            * @brief Read next frame without throwing.
+            *
+            * @param ec Output error code, cleared on success. It is
+            *        std::errc::no_buffer_space when all frames of pool are
+            *        held by caller.
+            *
+            * @return Frame, to give back with release(), or NULL on error.
+            */
+            frame *try_read_frame(std::error_code &ec);
+            /**
+            * @brief Give back a frame returned by read_frame().
+            *
+            * @param f Frame.
+            */
+            void release(frame *f);
+
+            /**
+            * @brief Encode and write a frame.
+            *
+            * @param data Frame content.
+            * @param size Size of frame.
+            *
+            * @return Size of frame.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when data is NULL, or size is
+            *     0 or larger than mtu.
+            *   - See serial::write_buffer() for write errors.
+            */
+            size_t write_frame(const uint8_t *data, size_t size);
+
+            /**
+            * @brief Get number of received frames dropped because they are
+            *        larger than mtu or malformed.
+            *
+            * @return Number of frames.
+            */
+            uint64_t dropped() const;
+
+            /**
+            * @brief Retrieve framed device.
+            *
+            * @return Device given at construction.
+            */
+            serial &device();
+
+        private:
+            /**
+            * @brief Framed device.
+            */
+            serial &m_device;
+            /**
+            * @brief Largest frame size.
+            */
+            size_t m_mtu;
+            /**
+            * @brief Decoder state.
+            */
+            slip_codec m_codec;
+            /**
+            * @brief Frames handed to caller.
+            */
+            frame_pool m_pool;
+            /**
+            * @brief Frame being decoded, NULL between frames.
+            */
+            frame *m_current;
+            /**
+            * @brief Buffer of encoded frames.
+            */
+            std::vector<uint8_t> m_output;
+    };
+
+};
+
+#endif /* end of include guard: SLIP_H_T6NB4RXE */
@@ -0,0 +1,207 @@
+/**
+* @file stats.h
+* @brief I/O statistics of a serial device.
+* @author Adrien Oliva
+* @date 2026-10-17
+*/
+#ifndef STATS_H_B6RKW3PN
+#define STATS_H_B6RKW3PN
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <system_error>
+
+namespace com {
+
+    /**
+    * @brief Snapshot of I/O statistics of a serial device in one direction.
+    */
+    struct io_stats {
+        /**
+        * @brief Number of latency histogram buckets.
+        */
+        static const size_t LATENCY_BUCKETS = 32;
+
+        /**
+        * @brief Number of bytes transferred.
+        */
+        uint64_t bytes;
+        /**
+        * @brief Number of I/O calls on device (read_buffer(), read_some(),
+        *        read_available()…), including failed ones.
+        */
+        uint64_t calls;
+        /**
+        * @brief Number of system calls done on device by I/O calls (ppoll(),
+        *        readv(), writev()…), splice transfers excepted.
+        */
+        uint64_t syscalls;
+        /**
+        * @brief Number of calls ended by a timeout.
+        */
+        uint64_t timeouts;
+        /**
+        * @brief Number of bytes transferred by calls ended by a timeout.
+        */
+        uint64_t timeout_bytes;
+        /**
+        * @brief Number of calls ended by any other error.
+        */
+        uint64_t errors;
+        /**
+        * @brief Histogram of call durations: bucket 0 counts calls shorter
+        *        than 1us, bucket i counts calls from 2^(i-1) to 2^i us and
+        *        last bucket also counts any longer call.
+        */
+        uint64_t latency[LATENCY_BUCKETS];
+    };
+
+    /**
+    * @brief Snapshot of I/O statistics of a serial device.
+    */
+    struct serial_stats {
+        /**
+        * @brief Statistics of data received from device.
+        */
+        io_stats read;
+        /**
+        * @brief Statistics of data sent to device.
+        */
+        io_stats write;
+    };
+
+    /**
+    * @brief Live I/O statistics of a serial device in one direction.
+    *
+    * Counters are updated with relaxed atomic operations only, so they can
+    * always be kept enabled and read from any thread. A snapshot is not
+    * atomic as a whole: counters of a call running concurrently may be
+    * partially taken into account.
+    */
+    class io_counters {
+        public:
+            io_counters() : m_bytes(0), m_calls(0), m_syscalls(0)
+                          , m_timeouts(0), m_timeout_bytes(0), m_errors(0)
+                          , m_latency()
+            {
+                for (auto &bucket: m_latency)
+                    bucket.store(0, std::memory_order_relaxed);
+            }
+
+            /**
+            * @brief Get current time to measure call duration.
+            *
+            * @return Time in ns on CLOCK_MONOTONIC.
+            */
+            static uint64_t now()
+            {
+                struct timespec ts;
+                clock_gettime(CLOCK_MONOTONIC, &ts);
+                return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL
+                     + static_cast<uint64_t>(ts.tv_nsec);
+            }
+
+            /**
+            * @brief Account for system calls done on device.
+            *
+            * @param count Number of system calls.
+            */
+            void syscall(uint64_t count = 1)
+            {
+                m_syscalls.fetch_add(count, std::memory_order_relaxed);
+            }
+
+            /**
+            * @brief Account for a completed I/O call.
+            *
+            * @param bytes Number of bytes transferred.
+            * @param ec Error reported by call.
+            * @param start Start time of call, from now().
+            */
+            void call(uint64_t bytes, const std::error_code &ec,
+                      uint64_t start)
+            {
+                m_calls.fetch_add(1, std::memory_order_relaxed);
+                if (bytes != 0)
+                    m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+                if (ec == std::errc::timed_out) {
+                    m_timeouts.fetch_add(1, std::memory_order_relaxed);
+                    m_timeout_bytes.fetch_add(bytes,
+                                              std::memory_order_relaxed);
+                } else if (ec) {
+                    m_errors.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                uint64_t us = (now() - start) / 1000;
+                size_t bucket = us == 0 ? 0
+                              : static_cast<size_t>(64 - __builtin_clzll(us));
+                if (bucket >= io_stats::LATENCY_BUCKETS)
+                    bucket = io_stats::LATENCY_BUCKETS - 1;
+                m_latency[bucket].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            /**
+            * @brief Account for bytes delivered outside of an I/O call.
+            *
+            * @param bytes Number of bytes.
+            */
+            void transferred(uint64_t bytes)
+            {
+                m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            }
+
+            /**
+            * @brief Take a snapshot of counters.
+            *
+            * @param stats Output snapshot.
+            */
+            void snapshot(io_stats &stats) const
+            {
+                stats.bytes = m_bytes.load(std::memory_order_relaxed);
+                stats.calls = m_calls.load(std::memory_order_relaxed);
+                stats.syscalls = m_syscalls.load(std::memory_order_relaxed);
+                stats.timeouts = m_timeouts.load(std::memory_order_relaxed);
+                stats.timeout_bytes =
+                            m_timeout_bytes.load(std::memory_order_relaxed);
+                stats.errors = m_errors.load(std::memory_order_relaxed);
+                for (size_t i = 0; i < io_stats::LATENCY_BUCKETS; i++)
+                    stats.latency[i] =
+                                m_latency[i].load(std::memory_order_relaxed);
+            }
+
+        private:
+            /**
+            * @brief See io_stats::bytes.
+            */
+            std::atomic<uint64_t> m_bytes;
+            /**
+            * @brief See io_stats::calls.
+            */
+            std::atomic<uint64_t> m_calls;
+            /**
+            * @brief See io_stats::syscalls.
+            */
+            std::atomic<uint64_t> m_syscalls;
+            /**
+            * @brief See io_stats::timeouts.
+            */
+            std::atomic<uint64_t> m_timeouts;
+            /**
+            * @brief See io_stats::timeout_bytes.
+            */
+            std::atomic<uint64_t> m_timeout_bytes;
+            /**
+            * @brief See io_stats::errors.
+            */
+            std::atomic<uint64_t> m_errors;
+            /**
+            * @brief See io_stats::latency.
+            */
+            std::atomic<uint64_t> m_latency[io_stats::LATENCY_BUCKETS];
+    };
+
+};
+
+#endif /* end of include guard: STATS_H_B6RKW3PN */
@@ -0,0 +1,229 @@
+/**
+* @file uring.h
+* @brief Completion based I/O engine of serial devices built on io_uring.
+* @author Adrien Oliva
+* @date 2026-10-16
+*
+* This engine is optional and only available when library is built with
+* liburing support (see `--enable-uring` configure switch).
+*/
+#ifndef URING_H_H5TQZ0PB
+#define URING_H_H5TQZ0PB
+
+#include <comserial/cppcomserial.h>
+
+#include <map>
+#include <vector>
+#include <sys/types.h>
+
+struct io_uring;
+struct io_uring_sqe;
+
+namespace com {
+
+    /**
+    * @brief Share a single io_uring instance between many serial devices.
+    *
+    * Every attached device always has a read in flight: once data arrive,
+    * a read completion is reported by wait() and a new read is queued, so a
+    * single system call both harvests completions of all devices and submits
+    * the next requests. Writes are queued by write() and submitted in batch
+    * by submit() or wait().
+    *
+    * Devices are opened in non blocking mode, so each read or write is
+    * linked to a poll request that waits for the device to be ready.
+    *
+    * An engine instance is not thread safe and must be driven by a single
+    * thread.
+    */
+    class uring {
+
+        public:
+            /**
+            * @brief Kind of operation reported by a completion.
+            */
+            enum operation {
+                /**
+                * @brief Data were received from device.
+                */
+                received,
+                /**
+                * @brief Data queued with write() were sent to device.
+                */
+                sent,
+            };
+
+            /**
+            * @brief Result of a completed operation.
+            */
+            struct completion {
+                /**
+                * @brief Device on which operation completed.
+                */
+                serial *device;
+                /**
+                * @brief Kind of operation.
+                */
+                operation op;
+                /**
+                * @brief Data of operation.
+                *
+                * For a read, data point into an internal buffer that remains
+                * valid until the next call to wait(). For a write, this is the
+                * buffer given to write().
+                */
+                const uint8_t *data;
+                /**
+                * @brief Number of bytes transferred, or negative errno value
+                *        on failure.
+                */
+                ssize_t result;
+                /**
+                * @brief User data given to write() (NULL for reads).
+                */
+                void *user_data;
+            };
+
+            /**
+            * @brief Create a new io_uring engine.
+            *
+            * @param entries Size of submission queue (default to 256).
+            * @param read_size Size of read buffers of each device (default to
+            *        4096 bytes).
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when a size is 0.
+            *   - com::exception::runtime_error when io_uring instance can not
+            *     be created (e.g. not supported by running kernel).
+            */
+            explicit uring(unsigned int entries = 256, size_t read_size = 4096);
+            ~uring();
+
+            /**
+            * @brief Attach a device and start reading it.
+            *
+            * @param device Device to attach. Device must outlive its
+            *        attachment.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when device is already
+            *     attached.
+            */
+            void attach(serial &device);
+            /**
+            * @brief Stop reading a device and forget it.
+            *
+            * @param device Device to detach.
+            *
+            * @return true if device was attached, false otherwise.
+            *
+            * @note No more completion of this device is reported once
+            *       detached, even for pending writes.
+            */
+            bool detach(serial &device);
+
+            /**
+            * @brief Queue a write request on a device.
+            *
+            * @param device Attached device where data is written.
+            * @param buffer Data to write, that must remain valid until its
+            *        completion is reported.
+            * @param length Size of buffer.
+            * @param user_data Opaque value reported in completion.
+            *
+            * Request is only queued: it is sent to kernel with all other
+            * pending requests by the next call to submit() or wait(). Short
+            * writes are transparently continued, so completion reports
+            * either the whole length or an error.
+            *
+            * The following exception may occur:
+            *   - com::exception::invalid_input when input buffer is invalid
+            *     or when device is not attached.
+            */
+            void write(serial &device, const uint8_t *buffer, size_t length,
+                       void *user_data = NULL);
+
+            /**
+            * @brief Submit all queued requests with a single system call.
+            *
+            * @return Number of submitted requests.
+            *
+            * The following exception may occur:
+            *   - com::exception::runtime_error when submission fail.
+            */
+            size_t submit();
+            /**
+            * @brief Submit queued requests and wait for completions.
+            *
+            * @param completions Output vector, cleared and filled with all
+            *        available completions.
+            * @param min_completions Minimum number of completions to wait
+            *        for (default to 1).
+            * @param timeout Maximum time to wait in ms (-1 to wait forever).
+            *
+            * @return Number of completions, possibly lower than
+            *         min_completions when timeout is reached.
+            *
+            * The following exception may occur:
+            *   - com::exception::runtime_error when system call fail.
+            */
+            size_t wait(std::vector<completion> &completions,
+                        unsigned int min_completions = 1, int timeout = -1);
+
+        private:
+            /**
+            * @brief Internal state of an attached device.
+            */
+            struct port;
+            /**
+            * @brief Internal state of a read or write request.
+            */
+            struct request;
+
+            /**
+            * @brief Get a free submission queue entry, flushing the queue to
+            *        kernel when full.
+            *
+            * @return Submission queue entry.
+            */
+            struct io_uring_sqe *get_sqe();
+            /**
+            * @brief Queue a poll request linked to a read or write request.
+            *
+            * @param req Request to queue.
+            */
+            void queue(request *req);
+            /**
+            * @brief Handle a single completion queue entry.
+            *
+            * @param req Request that completes.
+            * @param res Result of request.
+            * @param completions Output vector of reported completions.
+            */
+            void complete(request *req, int res,
+                          std::vector<completion> &completions);
+            /**
+            * @brief Release a port once it is detached and idle.
+            *
+            * @param p Port to check.
+            */
+            void release_if_idle(port *p);
+
+        private:
+            /**
+            * @brief io_uring instance.
+            */
+            struct io_uring *m_ring;
+            /**
+            * @brief Size of read buffers.
+            */
+            size_t m_read_size;
+            /**
+            * @brief Attached devices, indexed by file descriptor.
+            */
+            std::map<int, port *> m_ports;
+    };
+
+};
+
+#endif /* end of include guard: URING_H_H5TQZ0PB */
@@ -0,0 +1,337 @@
+/**
+* @file coroutine.cpp
+* @brief Implementation of com::executor and asynchronous operations.
+* @author Adrien Oliva
+* @date 2026-10-16
+*/
+#include "comserial/coroutine.h"
+#include "logger.h"
+#include "scan.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace com;
+
+executor::awaiter::awaiter(executor &owner, serial &device,
+                           unsigned int events, clock::time_point deadline)
+    : m_owner(owner)
+    , m_device(device)
+    , m_events(events)
+    , m_occurred(0)
+    , m_deadline(deadline)
+    , m_timer()
+    , m_handle()
+{
+}
+
+void executor::awaiter::await_suspend(std::coroutine_handle<> h)
+{
+    m_handle = h;
+    m_owner.suspend(this);
+}
+
+executor::executor(size_t batch_size)
+    : m_reactor(batch_size)
+    , m_waiters()
+    , m_timers()
+    , m_ready()
+    , m_tasks()
+    , m_stopped(false)
+{
+    ILOG() << "New coroutine executor";
+}
+
+executor::~executor()
+{
+    ILOG() << "Destroy coroutine executor";
+
+    // Suspended coroutines are destroyed with the tasks that own them.
+    for (auto &h: m_tasks)
+        h.destroy();
+}
+
+void executor::spawn(task<void> t)
+{
+    auto h = t.release();
+    if (!h) {
+        ELOG() << "Invalid task";
+        throw exception::invalid_input();
+    }
+
+    m_tasks.push_back(h);
+    m_ready.push_back(h);
+}
+
+size_t executor::run_once(int timeout)
+{
+    if (m_ready.empty())
+        m_reactor.run_once(next_timeout(timeout));
+
+    auto now = clock::now();
+    while (!m_timers.empty() && m_timers.begin()->first <= now)
+        wake(m_timers.begin()->second, 0);
+
+    std::vector<std::coroutine_handle<>> ready;
+    ready.swap(m_ready);
+    for (auto &h: ready)
+        h.resume();
+
+    std::exception_ptr error;
+    for (auto it = m_tasks.begin(); it != m_tasks.end(); ) {
+        if (it->done()) {
+            if (it->promise().error && !error)
+                error = it->promise().error;
+            it->destroy();
+            it = m_tasks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+
+    return ready.size();
+}
+
+void executor::run()
+{
+    ILOG() << "Executor starts running";
+    while (!m_stopped.load() && !m_tasks.empty())
+        run_once(-1);
+    m_stopped.store(false);
+    ILOG() << "Executor stopped";
+}
+
+void executor::stop()
+{
+    m_stopped.store(true);
+    m_reactor.stop();
+}
+
+size_t executor::size() const
+{
+    return m_tasks.size();
+}
+
+executor::awaiter executor::wait(serial &device, unsigned int events,
+                                 clock::time_point deadline)
+{
+    return awaiter(*this, device, events, deadline);
+}
+
+void executor::suspend(awaiter *op)
+{
+    waiters &w = m_waiters[op->m_device.get_fd()];
+    awaiter *&slot = (op->m_events & reactor::readable) ? w.reader : w.writer;
+
+    if (slot != NULL) {
+        ELOG() << "Device " << op->m_device.get_fd() << " already awaited";
+        // Exception is rethrown in awaiting coroutine.
+        throw exception::invalid_input();
+    }
+
+    slot = op;
+    op->m_timer = m_timers.insert(std::make_pair(op->m_deadline, op));
+    update(op->m_device, w);
+}
+
+void executor::wake(awaiter *op, unsigned int occurred)
+{
+    int fd = op->m_device.get_fd();
+    auto it = m_waiters.find(fd);
+    waiters &w = it->second;
+
+    if (w.reader == op)
+        w.reader = NULL;
+    if (w.writer == op)
+        w.writer = NULL;
+
+    m_timers.erase(op->m_timer);
+    op->m_occurred = occurred;
+    m_ready.push_back(op->m_handle);
+
+    update(op->m_device, w);
+    if (w.reader == NULL && w.writer == NULL)
+        m_waiters.erase(it);
+}
+
+void executor::on_event(serial &device, unsigned int events)
+{
+    auto it = m_waiters.find(device.get_fd());
+    if (it == m_waiters.end())
+        return;
+
+    awaiter *reader = it->second.reader;
+    awaiter *writer = it->second.writer;
+
+    if (reader != NULL && (events & (reactor::readable | reactor::error)))
+        wake(reader, events);
+    if (writer != NULL && (events & (reactor::writable | reactor::error)))
+        wake(writer, events);
+}
+
+void executor::update(serial &device, waiters &w)
+{
+    unsigned int events = 0;
+    if (w.reader != NULL)
+        events |= reactor::readable;
+    if (w.writer != NULL)
+        events |= reactor::writable;
+
+    if (events == w.events)
+        return;
+
+    if (w.events == 0)
+        m_reactor.add(device, [this](serial &d, unsigned int ev) {
+            on_event(d, ev);
+        }, events);
+    else if (events == 0)
+        m_reactor.remove(device);
+    else
+        m_reactor.modify(device, events);
+
+    w.events = events;
+}
+
+int executor::next_timeout(int timeout) const
+{
+    if (m_timers.empty())
+        return timeout;
+
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    m_timers.begin()->first - clock::now()).count() + 1;
+    if (delay < 0)
+        delay = 0;
+
+    if (timeout < 0 || delay < timeout)
+        return static_cast<int>(delay);
+    return timeout;
+}
+
+/**
+* @brief Compute deadline of an operation.
+*
+* @param timeout Timeout in ms.
+*
+* @return Deadline.
+*/
+static executor::clock::time_point deadline_from_now(unsigned int timeout)
+{
+    return executor::clock::now() + std::chrono::milliseconds(timeout);
+}
+
+task<size_t> com::async_read(executor &ex, serial &device, uint8_t *buffer,
+                             size_t length)
+{
+    if (buffer == NULL || length == 0)
+        throw exception::invalid_input();
+
+    auto deadline = deadline_from_now(device.get_read_timeout());
+    size_t size_read = 0;
+    unsigned int events = 0;
+
+    while (size_read != length) {
+        size_t r = device.read_available(buffer + size_read,
+                                         length - size_read);
+        if (r != 0) {
+            size_read += r;
+            continue;
+        }
+
+        if (events & reactor::error) {
+            ALOG() << "Fail to read buffer";
+            throw exception::runtime_error("Fail to read");
+        }
+
+        events = co_await ex.wait(device, reactor::readable, deadline);
+        if (events == 0) {
+            WLOG() << "Timeout error";
+            throw exception::timeout(size_read);
+        }
+    }
+
+    DLOG() << "Async read:" << logger::dump(buffer, size_read);
+    co_return size_read;
+}
+
+task<size_t> com::async_write(executor &ex, serial &device,
+                              const uint8_t *buffer, size_t length)
+{
+    if (buffer == NULL || length == 0) {
+        ELOG() << "Invalid buffer to write";
+        throw exception::invalid_input();
+    }
+
+    auto deadline = deadline_from_now(device.get_write_timeout());
+    size_t size_written = 0;
+    unsigned int events = 0;
+
+    while (size_written != length) {
+        size_t w = device.write_available(buffer + size_written,
+                                          length - size_written);
+        if (w != 0) {
+            size_written += w;
+            continue;
+        }
+
+        if (events & reactor::error) {
+            ALOG() << "Fail to write buffer";
+            throw exception::runtime_error("Fail to write");
+        }
+
+        events = co_await ex.wait(device, reactor::writable, deadline);
+        if (events == 0) {
+            WLOG() << "Timeout error";
+            throw exception::timeout(size_written);
+        }
+    }
+
+    DLOG() << "Async write:" << logger::dump(buffer, length);
+    co_return size_written;
+}
+
+task<size_t> com::async_read_until(executor &ex, serial &device,
+                                   uint8_t *buffer, size_t length,
+                                   uint8_t delimiter)
+{
+    if (buffer == NULL || length == 0)
+        throw exception::invalid_input();
+
+    auto deadline = deadline_from_now(device.get_read_timeout());
+    size_t size_read = 0;
+    unsigned int events = 0;
+
+    while (size_read != length) {
+        // Data beyond delimiter stay in read ahead buffer of device.
+        const uint8_t *data;
+        size_t available = std::min(device.peek_available(data),
+                                    length - size_read);
+        if (available != 0) {
+            size_t found = scan::find_any(data, available, &delimiter, 1);
+            size_t taken = found < available ? found + 1 : available;
+
+            memcpy(buffer + size_read, data, taken);
+            device.consume(taken);
+            size_read += taken;
+            if (found < available)
+                break;
+            continue;
+        }
+
+        if (events & reactor::error) {
+            ALOG() << "Fail to read buffer";
+            throw exception::runtime_error("Fail to read");
+        }
+
+        events = co_await ex.wait(device, reactor::readable, deadline);
+        if (events == 0) {
+            WLOG() << "Timeout error";
+            throw exception::timeout(size_read);
+        }
+    }
+
+    DLOG() << "Async read until:" << logger::dump(buffer, size_read);
+    co_return size_read;
+}
@@ -6,27 +6,66 @@
 */
 #include "comserial/cppcomserial.h"
 #include "logger.h"
+#include "scan.h"
+#include "shmstats.h"
+#include "termios2.h"
 
+#include <algorithm>
+#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <fcntl.h>
+#include <poll.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 using namespace com;
 
+/**
+* @brief Get lower case form of a valid parity, as reported by get_parity().
+*
+* @param parity Parity, in lower or upper case.
+*
+* @return Parity in lower case.
+*/
+static char lower_parity(char parity)
+{
+    return (parity < 'a') ? static_cast<char>(parity + ('a' - 'A')) : parity;
+}
+
 serial::serial(const std::string &device, unsigned int speed,
                                           unsigned int data_size,
                                           unsigned int stop_size,
                                           char parity)
     : m_fd(-1)
+    , m_device(device)
     , m_speed(speed)
     , m_datasize(data_size)
     , m_stopsize(stop_size)
     , m_parity(parity)
+    , m_flow_control(flow_none)
     , m_read_timeout(1000)
     , m_write_timeout(1000)
+    , m_custom_speed(false)
     , m_options()
+    , m_committed_options()
+    , m_committed_speed(0)
+    , m_committed_custom_speed(false)
+    , m_pipe()
+    , m_read_stats()
+    , m_stats_padding()
+    , m_write_stats()
+    , m_ahead()
+    , m_ahead_start(0)
+    , m_ahead_end(0)
+    , m_capture(NULL)
+    , m_capture_port(0)
 {
+    m_pipe[0] = -1;
+    m_pipe[1] = -1;
+
     // Set default termios configuration
     cfmakeraw(&m_options);
     m_options.c_cflag &= ~CRTSCTS;
@@ -42,21 +81,31 @@ serial::serial(const std::string &device, unsigned int speed,
     check_and_set_data_size(data_size);
     check_and_set_stop_size(stop_size);
     check_and_set_parity(parity);
+    m_parity = lower_parity(parity);
 
     open_device(device.c_str());
 
-    commit_termios_configuration();
+    // Destructor is not called when constructor throws.
+    try {
+        commit_termios_configuration();
+    } catch (...) {
+        close_device();
+        throw;
+    }
 
     NLOG() << "New serial device " << device;
     ILOG() << "@" << speed << "bps, "
                   << data_size
-                  << parity
+                  << m_parity
                   << stop_size;
+
+    shmstats::attach(*this, device);
 }
 
 serial::~serial()
 {
     ILOG() << "Destroy device";
+    shmstats::detach(*this);
     close_device();
 }
 
@@ -89,9 +138,8 @@ unsigned int serial::set_data_size(unsigned int data_size)
     check_and_set_data_size(data_size);
 
     unsigned int old_datasize = m_datasize;
-    m_datasize = data_size;
-
     commit_termios_configuration();
+    m_datasize = data_size;
 
     ILOG() << "New data size set: " << old_datasize << " -> " << m_datasize;
     return old_datasize;
@@ -107,9 +155,8 @@ unsigned int serial::set_stop_size(unsigned int stop_size)
     check_and_set_stop_size(stop_size);
 
     unsigned int old_stopsize = m_stopsize;
-    m_stopsize = stop_size;
-
     commit_termios_configuration();
+    m_stopsize = stop_size;
 
     ILOG() << "New stop size set: " << old_stopsize << " -> " << m_stopsize;
     return old_stopsize;
@@ -125,14 +172,84 @@ char serial::set_parity(char parity)
     check_and_set_parity(parity);
 
     char old_parity = m_parity;
-    m_parity = (parity < 'a') ? (parity + ('a' - 'A')) : parity;
-
     commit_termios_configuration();
+    m_parity = lower_parity(parity);
 
     ILOG() << "New parity set: " << old_parity << " -> " << m_parity;
     return old_parity;
 }
 
+flow_control serial::get_flow_control() const
+{
+    return m_flow_control;
+}
+
+flow_control serial::set_flow_control(flow_control mode)
+{
+    check_and_set_flow_control(mode);
+
+    flow_control old_mode = m_flow_control;
+    commit_termios_configuration();
+    m_flow_control = mode;
+
+    ILOG() << "New flow control set: " << old_mode << " -> " << m_flow_control;
+    return old_mode;
+}
+
+serial_config serial::get_config() const
+{
+    return serial_config(m_speed, m_datasize, m_stopsize, m_parity,
+                         m_flow_control);
+}
+
+serial_config serial::apply(const serial_config &config, apply_when when)
+{
+    if (when != apply_now && when != apply_drain && when != apply_flush) {
+        ELOG() << when << " is not a valid apply mode";
+        throw exception::invalid_input();
+    }
+
+    serial_config old_config = get_config();
+    serial_config new_config = config;
+    new_config.parity = lower_parity(new_config.parity);
+
+    if (new_config == old_config) {
+        DLOG() << "Configuration unchanged";
+        return old_config;
+    }
+
+    // Validate everything before touching device, so that an invalid field
+    // leaves previous configuration in place.
+    struct termios old_options = m_options;
+    speed_t old_termios_speed = m_termios_speed;
+    bool old_custom_speed = m_custom_speed;
+    try {
+        check_and_set_speed(config.speed);
+        check_and_set_data_size(config.data_size);
+        check_and_set_stop_size(config.stop_size);
+        check_and_set_parity(config.parity);
+        check_and_set_flow_control(config.flow);
+    } catch (...) {
+        m_options = old_options;
+        m_termios_speed = old_termios_speed;
+        m_custom_speed = old_custom_speed;
+        throw;
+    }
+
+    m_speed = new_config.speed;
+    commit_termios_configuration(when);
+
+    m_datasize = new_config.data_size;
+    m_stopsize = new_config.stop_size;
+    m_parity = new_config.parity;
+    m_flow_control = new_config.flow;
+
+    ILOG() << "New configuration set: " << m_speed << "bps, "
+           << m_datasize << m_parity << m_stopsize
+           << ", flow control " << m_flow_control;
+    return old_config;
+}
+
 unsigned int serial::get_read_timeout() const
 {
     return m_read_timeout;
@@ -163,90 +280,912 @@ unsigned int serial::set_write_timeout(unsigned int timeout)
     return old_timeout;
 }
 
+/**
+* @brief Maximum number of buffers given to a single readv() or writev()
+*        call.
+*/
+static const size_t IOVEC_WINDOW = 64;
+
+/**
+* @brief Maximum amount of data moved through splice pipe at once (default
+*        capacity of a pipe).
+*/
+static const size_t SPLICE_CHUNK = 65536;
+/**
+* @brief Size of bounce buffer used when splice is refused by kernel.
+*/
+static const size_t SPLICE_COPY_SIZE = 4096;
+/**
+* @brief Size of read ahead buffer of read_until(), enough for a line or a
+*        frame of most protocols in a single system call.
+*/
+static const size_t READ_AHEAD_SIZE = 4096;
+
+/**
+* @brief Compute total size of a buffer array.
+*
+* @param iov Buffer array.
+* @param count Number of buffers.
+*
+* @return Total size in bytes, or 0 if array is invalid.
+*/
+static size_t iovec_length(const struct iovec *iov, size_t count)
+{
+    size_t length = 0;
+
+    if (iov == NULL)
+        return 0;
+
+    for (size_t i = 0; i < count; i++) {
+        if (iov[i].iov_base == NULL && iov[i].iov_len != 0)
+            return 0;
+        length += iov[i].iov_len;
+    }
+
+    return length;
+}
+
+/**
+* @brief Fill a window of remaining non empty buffers.
+*
+* @param iov Buffer array.
+* @param count Number of buffers.
+* @param index Index of current buffer.
+* @param offset Offset in current buffer.
+* @param window Output window of at most IOVEC_WINDOW buffers.
+*
+* @return Number of buffers in window.
+*/
+static size_t iovec_window(const struct iovec *iov, size_t count,
+                           size_t index, size_t offset, struct iovec *window)
+{
+    size_t n = 0;
+
+    for (; index < count && n < IOVEC_WINDOW; index++, offset = 0) {
+        if (iov[index].iov_len == offset)
+            continue;
+        window[n].iov_base = static_cast<uint8_t *>(iov[index].iov_base)
+                           + offset;
+        window[n].iov_len = iov[index].iov_len - offset;
+        n++;
+    }
+
+    return n;
+}
+
+/**
+* @brief Move current position in a buffer array.
+*
+* @param iov Buffer array.
+* @param index Index of current buffer, updated.
+* @param offset Offset in current buffer, updated.
+* @param bytes Number of bytes to skip.
+*/
+static void iovec_advance(const struct iovec *iov, size_t &index,
+                          size_t &offset, size_t bytes)
+{
+    while (bytes > 0) {
+        size_t left = iov[index].iov_len - offset;
+        if (bytes < left) {
+            offset += bytes;
+            return;
+        }
+        bytes -= left;
+        index++;
+        offset = 0;
+    }
+}
+
+/**
+* @brief Convert error reported by non throwing I/O functions in exception.
+*
+* @param ec Error code to convert.
+* @param bytes Number of bytes transferred before error.
+* @param message Message of runtime error.
+*
+* Only argument checks report a generic invalid_argument: an EINVAL from a
+* system call, in system category, is a runtime error.
+*/
+static void throw_error(const std::error_code &ec, size_t bytes,
+                        const char *message)
+{
+    if (ec == std::make_error_code(std::errc::invalid_argument))
+        throw exception::invalid_input();
+    else if (ec == std::errc::timed_out)
+        throw exception::timeout(bytes);
+    else
+        throw exception::runtime_error(message);
+}
+
 size_t serial::write_buffer(const uint8_t *buffer, size_t length)
 {
+    std::error_code ec;
+    size_t size_written = try_write_exact(buffer, length, ec);
+
+    if (ec)
+        throw_error(ec, size_written, "Fail to write");
+
+    return size_written;
+}
+
+size_t serial::read_buffer(uint8_t *buffer, size_t length)
+{
+    std::error_code ec;
+    size_t size_read = try_read_exact(buffer, length, ec);
+
+    if (ec)
+        throw_error(ec, size_read, "Fail to read");
+
+    return size_read;
+}
+
+size_t serial::write_some(const uint8_t *buffer, size_t length,
+                          std::error_code &ec)
+{
+    uint64_t start = io_counters::now();
+    ec.clear();
     if (buffer == NULL || length == 0) {
         ELOG() << "Invalid buffer to write";
-        throw exception::invalid_input();
+        ec = std::make_error_code(std::errc::invalid_argument);
+        m_write_stats.call(0, ec, start);
+        return 0;
+    }
+
+    struct iovec iov = { const_cast<uint8_t *>(buffer), length };
+    size_t size_written = write_once(&iov, 1,
+                                     deadline_from_now(m_write_timeout), ec);
+    m_write_stats.call(size_written, ec, start);
+
+    DLOG() << "Write some:" << logger::dump(buffer, size_written);
+    return size_written;
+}
+
+size_t serial::read_some(uint8_t *buffer, size_t length, std::error_code &ec)
+{
+    uint64_t start = io_counters::now();
+    ec.clear();
+    if (buffer == NULL || length == 0) {
+        ec = std::make_error_code(std::errc::invalid_argument);
+        m_read_stats.call(0, ec, start);
+        return 0;
+    }
+
+    struct iovec iov = { buffer, length };
+    size_t size_read = read_once(&iov, 1,
+                                 deadline_from_now(m_read_timeout), ec);
+    m_read_stats.call(size_read, ec, start);
+
+    DLOG() << "Read some:" << logger::dump(buffer, size_read);
+    return size_read;
+}
+
+size_t serial::try_write_exact(const uint8_t *buffer, size_t length,
+                               std::error_code &ec)
+{
+    uint64_t start = io_counters::now();
+    ec.clear();
+    if (buffer == NULL || length == 0) {
+        ELOG() << "Invalid buffer to write";
+        ec = std::make_error_code(std::errc::invalid_argument);
+        m_write_stats.call(0, ec, start);
+        return 0;
     }
 
     size_t size_written = 0;
+    struct timespec deadline = deadline_from_now(m_write_timeout);
+
+    while (size_written != length && !ec) {
+        struct iovec iov = { const_cast<uint8_t *>(buffer) + size_written,
+                             length - size_written };
+        size_written += write_once(&iov, 1, deadline, ec);
+    }
+    m_write_stats.call(size_written, ec, start);
+
+    if (ec)
+        DLOG() << "Write only:" << logger::dump(buffer, size_written);
+    else
+        DLOG() << "Write success:" << logger::dump(buffer, length);
+
+    return size_written;
+}
+
+size_t serial::try_read_exact(uint8_t *buffer, size_t length,
+                              std::error_code &ec)
+{
+    uint64_t start = io_counters::now();
+    ec.clear();
+    if (buffer == NULL || length == 0) {
+        ec = std::make_error_code(std::errc::invalid_argument);
+        m_read_stats.call(0, ec, start);
+        return 0;
+    }
+
+    size_t size_read = 0;
+    struct timespec deadline = deadline_from_now(m_read_timeout);
+
+    while (size_read != length && !ec) {
+        struct iovec iov = { buffer + size_read, length - size_read };
+        size_read += read_once(&iov, 1, deadline, ec);
+    }
+    m_read_stats.call(size_read, ec, start);
+
+    if (ec)
+        DLOG() << "Read only:" << logger::dump(buffer, size_read);
+    else
+        DLOG() << "Read success:" << logger::dump(buffer, size_read);
+
+    return size_read;
+}
+
+size_t serial::write_buffers(const struct iovec *iov, size_t count)
+{
+    std::error_code ec;
+    size_t size_written = try_write_buffers(iov, count, ec);
+
+    if (ec)
+        throw_error(ec, size_written, "Fail to write");
+
+    return size_written;
+}
+
+size_t serial::read_buffers(const struct iovec *iov, size_t count)
+{
+    std::error_code ec;
+    size_t size_read = try_read_buffers(iov, count, ec);
+
+    if (ec)
+        throw_error(ec, size_read, "Fail to read");
+
+    return size_read;
+}
+
+size_t serial::try_write_buffers(const struct iovec *iov, size_t count,
+                               std::error_code &ec)
+{
+    uint64_t start = io_counters::now();
+    ec.clear();
+    size_t length = iovec_length(iov, count);
+    if (length == 0) {
+        ELOG() << "Invalid buffers to write";
+        ec = std::make_error_code(std::errc::invalid_argument);
+        m_write_stats.call(0, ec, start);
+        return 0;
+    }
+
+    size_t size_written = 0;
+    size_t index = 0;
+    size_t offset = 0;
+    struct timespec deadline = deadline_from_now(m_write_timeout);
+
+    while (size_written != length && !ec) {
+        struct iovec window[IOVEC_WINDOW];
+        size_t n = iovec_window(iov, count, index, offset, window);
+        size_t w = write_once(window, n, deadline, ec);
+        iovec_advance(iov, index, offset, w);
+        size_written += w;
+    }
+    m_write_stats.call(size_written, ec, start);
+
+    DLOG() << "Write " << size_written << "/" << length << " bytes from "
+           << count << " buffers";
+
+    return size_written;
+}
+
+size_t serial::try_read_buffers(const struct iovec *iov, size_t count,
+                              std::error_code &ec)
+{
+    uint64_t start = io_counters::now();
+    ec.clear();
+    size_t length = iovec_length(iov, count);
+    if (length == 0) {
+        ec = std::make_error_code(std::errc::invalid_argument);
+        m_read_stats.call(0, ec, start);
+        return 0;
+    }
+
+    size_t size_read = 0;
+    size_t index = 0;
+    size_t offset = 0;
+    struct timespec deadline = deadline_from_now(m_read_timeout);
+
+    while (size_read != length && !ec) {
+        struct iovec window[IOVEC_WINDOW];
+        size_t n = iovec_window(iov, count, index, offset, window);
+        size_t r = read_once(window, n, deadline, ec);
+        iovec_advance(iov, index, offset, r);
+        size_read += r;
+    }
+    m_read_stats.call(size_read, ec, start);
+
+    DLOG() << "Read " << size_read << "/" << length << " bytes in "
+           << count << " buffers";
+
+    return size_read;
+}
+
+size_t serial::read_until(uint8_t delimiter, uint8_t *buffer, size_t length)
+{
+    return read_until(&delimiter, 1, buffer, length);
+}
+
+size_t serial::read_until(const uint8_t *delimiters, size_t count,
+                          uint8_t *buffer, size_t length)
+{
+    std::error_code ec;
+    size_t size_read = try_read_until(delimiters, count, buffer, length, ec);
+
+    if (ec)
+        throw_error(ec, size_read, "Fail to read");
+
+    return size_read;
+}
+
+size_t serial::try_read_until(const uint8_t *delimiters, size_t count,
+                              uint8_t *buffer, size_t length,
+                              std::error_code &ec)
+{
+    uint64_t start = io_counters::now();
+    ec.clear();
+    if (buffer == NULL || length == 0 || delimiters == NULL || count == 0) {
+        ec = std::make_error_code(std::errc::invalid_argument);
+        m_read_stats.call(0, ec, start);
+        return 0;
+    }
+
+    if (m_ahead.empty())
+        m_ahead.resize(READ_AHEAD_SIZE);
+
+    size_t size_read = 0;
+    struct timespec deadline = deadline_from_now(m_read_timeout);
+
+    for (;;) {
+        size_t available = std::min(m_ahead_end - m_ahead_start,
+                                    length - size_read);
+        const uint8_t *ahead = m_ahead.data() + m_ahead_start;
+        size_t found = scan::find_any(ahead, available, delimiters, count);
+        size_t taken = found < available ? found + 1 : available;
+
+        memcpy(buffer + size_read, ahead, taken);
+        m_ahead_start += taken;
+        size_read += taken;
+        if (found < available || size_read == length)
+            break;
+
+        // Read ahead buffer is empty: refill it.
+        struct iovec iov = { m_ahead.data(), m_ahead.size() };
+        size_t r = read_device(&iov, 1, deadline, ec);
+        if (ec)
+            break;
+        m_ahead_start = 0;
+        m_ahead_end = r;
+    }
+    m_read_stats.call(size_read, ec, start);
+
+    DLOG() << "Read until:" << logger::dump(buffer, size_read);
+    return size_read;
+}
+
+size_t serial::peek(const uint8_t *&data, std::error_code &ec)
+{
+    ec.clear();
+    if (m_ahead.empty())
+        m_ahead.resize(READ_AHEAD_SIZE);
+
+    if (m_ahead_start == m_ahead_end) {
+        uint64_t start = io_counters::now();
+        struct iovec iov = { m_ahead.data(), m_ahead.size() };
+        size_t r = read_device(&iov, 1, deadline_from_now(m_read_timeout),
+                               ec);
+        // Bytes are accounted for once consumed.
+        m_read_stats.call(0, ec, start);
+        m_ahead_start = 0;
+        m_ahead_end = r;
+    }
 
-    fd_set write_set;
-    struct timeval tv = { m_write_timeout / 1000,
-                          (m_write_timeout % 1000) * 1000 };
+    data = m_ahead.data() + m_ahead_start;
+    return m_ahead_end - m_ahead_start;
+}
 
-    FD_ZERO(&write_set);
-    FD_SET(m_fd, &write_set);
+void serial::consume(size_t length)
+{
+    length = std::min(length, m_ahead_end - m_ahead_start);
+    m_ahead_start += length;
+    m_read_stats.transferred(length);
+}
 
-    while (size_written != length) {
-        int ret = select(m_fd + 1, NULL, &write_set, NULL, &tv);
+size_t serial::write_once(const struct iovec *iov, size_t count,
+                          const struct timespec &deadline, std::error_code &ec)
+{
+    for (;;) {
+        int ret = wait_device(POLLOUT, deadline);
+        m_write_stats.syscall();
         if (ret < 0) {
-            CLOG() << "Internal system function returns error (select)";
-            throw exception::runtime_error("Fail to select");
-        } else if (ret != 0) {
-            if (FD_ISSET(m_fd, &write_set)) {
-                ssize_t w = write(m_fd, buffer + size_written,
-                                        length - size_written);
-                if (w < 0) {
-                    ALOG() << "Fail to write buffer";
-                    throw exception::runtime_error("Fail to write");
-                }
+            ec = std::error_code(errno, std::system_category());
+            CLOG() << "Internal system function returns error (ppoll)";
+            return 0;
+        } else if (ret == 0) {
+            WLOG() << "Timeout error";
+            ec = std::make_error_code(std::errc::timed_out);
+            return 0;
+        }
+
+        ssize_t w = writev(m_fd, iov, static_cast<int>(count));
+        m_write_stats.syscall();
+        if (w < 0) {
+            if (errno == EAGAIN || errno == EINTR)
+                continue;
+            ec = std::error_code(errno, std::system_category());
+            ALOG() << "Fail to write buffer";
+            return 0;
+        }
+
+        if (m_capture != NULL)
+            m_capture->record(m_capture_port, capture::tx, iov, count, w);
+        return w;
+    }
+}
+
+size_t serial::read_once(const struct iovec *iov, size_t count,
+                         const struct timespec &deadline, std::error_code &ec)
+{
+    if (m_ahead_start != m_ahead_end)
+        return take_ahead(iov, count);
+    return read_device(iov, count, deadline, ec);
+}
+
+size_t serial::read_device(const struct iovec *iov, size_t count,
+                           const struct timespec &deadline,
+                           std::error_code &ec)
+{
+    for (;;) {
+        int ret = wait_device(POLLIN, deadline);
+        m_read_stats.syscall();
+        if (ret < 0) {
+            ec = std::error_code(errno, std::system_category());
+            CLOG() << "Internal system function returns error (ppoll)";
+            return 0;
+        } else if (ret == 0) {
+            ec = std::make_error_code(std::errc::timed_out);
+            return 0;
+        }
+
+        ssize_t r = readv(m_fd, iov, static_cast<int>(count));
+        m_read_stats.syscall();
+        if (r < 0) {
+            if (errno == EAGAIN || errno == EINTR)
+                continue;
+            ec = std::error_code(errno, std::system_category());
+            ALOG() << "Fail to read buffer";
+            return 0;
+        } else if (r == 0) {
+            // End of stream is reported as a timeout, like a silent device.
+            WLOG() << "Timeout error";
+            ec = std::make_error_code(std::errc::timed_out);
+            return 0;
+        }
+
+        if (m_capture != NULL)
+            m_capture->record(m_capture_port, capture::rx, iov, count, r);
+        return r;
+    }
+}
+
+size_t serial::take_ahead(const struct iovec *iov, size_t count)
+{
+    size_t moved = 0;
+
+    for (size_t i = 0; i < count && m_ahead_start != m_ahead_end; i++) {
+        size_t chunk = std::min(iov[i].iov_len, m_ahead_end - m_ahead_start);
+        memcpy(iov[i].iov_base, m_ahead.data() + m_ahead_start, chunk);
+        m_ahead_start += chunk;
+        moved += chunk;
+    }
+
+    return moved;
+}
+
+size_t serial::write_available(const uint8_t *buffer, size_t length)
+{
+    uint64_t start = io_counters::now();
+    if (buffer == NULL || length == 0) {
+        ELOG() << "Invalid buffer to write";
+        m_write_stats.call(0, std::make_error_code(std::errc::invalid_argument),
+                           start);
+        throw exception::invalid_input();
+    }
+
+    ssize_t w = write(m_fd, buffer, length);
+    m_write_stats.syscall();
+    if (w < 0) {
+        if (errno == EAGAIN || errno == EINTR) {
+            m_write_stats.call(0, std::error_code(), start);
+            return 0;
+        }
+        m_write_stats.call(0, std::error_code(errno, std::system_category()),
+                           start);
+        ALOG() << "Fail to write buffer";
+        throw exception::runtime_error("Fail to write");
+    }
+    m_write_stats.call(w, std::error_code(), start);
+    if (m_capture != NULL)
+        m_capture->record(m_capture_port, capture::tx, buffer, w);
+
+    DLOG() << "Write available:" << logger::dump(buffer, w);
+    return w;
+}
 
-                size_written += w;
+size_t serial::read_available(uint8_t *buffer, size_t length)
+{
+    uint64_t start = io_counters::now();
+    if (buffer == NULL || length == 0) {
+        m_read_stats.call(0, std::make_error_code(std::errc::invalid_argument),
+                          start);
+        throw exception::invalid_input();
+    }
+
+    if (m_ahead_start != m_ahead_end) {
+        struct iovec iov = { buffer, length };
+        size_t r = take_ahead(&iov, 1);
+        m_read_stats.call(r, std::error_code(), start);
+        return r;
+    }
+
+    ssize_t r = read(m_fd, buffer, length);
+    m_read_stats.syscall();
+    if (r < 0) {
+        if (errno == EAGAIN || errno == EINTR) {
+            m_read_stats.call(0, std::error_code(), start);
+            return 0;
+        }
+        m_read_stats.call(0, std::error_code(errno, std::system_category()),
+                          start);
+        ALOG() << "Fail to read buffer";
+        throw exception::runtime_error("Fail to read");
+    }
+    m_read_stats.call(r, std::error_code(), start);
+    if (m_capture != NULL)
+        m_capture->record(m_capture_port, capture::rx, buffer, r);
+
+    DLOG() << "Read available:" << logger::dump(buffer, r);
+    return r;
+}
+
+size_t serial::peek_available(const uint8_t *&data)
+{
+    if (m_ahead.empty())
+        m_ahead.resize(READ_AHEAD_SIZE);
+
+    if (m_ahead_start == m_ahead_end) {
+        uint64_t start = io_counters::now();
+        ssize_t r = read(m_fd, m_ahead.data(), m_ahead.size());
+        m_read_stats.syscall();
+        if (r < 0) {
+            if (errno != EAGAIN && errno != EINTR) {
+                m_read_stats.call(0, std::error_code(errno,
+                                                     std::system_category()),
+                                  start);
+                ALOG() << "Fail to read buffer";
+                throw exception::runtime_error("Fail to read");
+            }
+            r = 0;
+        }
+        // Bytes are accounted for once consumed.
+        m_read_stats.call(0, std::error_code(), start);
+        if (m_capture != NULL && r > 0)
+            m_capture->record(m_capture_port, capture::rx, m_ahead.data(), r);
+        m_ahead_start = 0;
+        m_ahead_end = r;
+    }
+
+    data = m_ahead.data() + m_ahead_start;
+    return m_ahead_end - m_ahead_start;
+}
+
+size_t serial::splice_to(int fd, size_t length)
+{
+    uint64_t start = io_counters::now();
+    if (fd < 0 || length == 0) {
+        ELOG() << "Invalid splice destination";
+        m_read_stats.call(0, std::make_error_code(std::errc::invalid_argument),
+                          start);
+        throw exception::invalid_input();
+    }
+
+    std::error_code ec;
+    size_t size_moved = 0;
+    bool use_pipe = open_pipe();
+    struct timespec deadline = deadline_from_now(m_read_timeout);
+
+    while (size_moved != length && !ec) {
+        size_t chunk = std::min(length - size_moved, SPLICE_CHUNK);
+
+        // Data kept ahead by read_until() are sent first with a copy.
+        if (use_pipe && m_ahead_start == m_ahead_end) {
+            ssize_t n = fill_pipe(m_fd, chunk, deadline);
+            if (n < 0 && errno == EINVAL) {
+                DLOG() << "Device does not support splice, copy data";
+                use_pipe = false;
+            } else if (n < 0) {
+                ec = std::error_code(errno, std::system_category());
+            } else if (n == 0) {
+                ec = std::make_error_code(std::errc::timed_out);
+            } else {
+                drain_pipe(fd, n, deadline, ec);
+                if (!ec)
+                    size_moved += n;
             }
         } else {
-            WLOG() << "Timeout error";
-            throw exception::timeout(size_written);
+            uint8_t buffer[SPLICE_COPY_SIZE];
+            struct iovec iov = { buffer, std::min(chunk, sizeof(buffer)) };
+            size_t r = read_once(&iov, 1, deadline, ec);
+            if (!ec)
+                write_fd(fd, buffer, r, deadline, ec);
+            if (!ec)
+                size_moved += r;
         }
     }
 
-    DLOG() << "Write success:" << logger::dump(buffer, length);
+    DLOG() << "Splice " << size_moved << "/" << length << " bytes to " << fd;
+    m_read_stats.call(size_moved, ec, start);
 
-    return size_written;
+    if (ec)
+        throw_error(ec, size_moved, "Fail to splice");
+
+    return size_moved;
 }
 
-size_t serial::read_buffer(uint8_t *buffer, size_t length)
+size_t serial::splice_from(int fd, size_t length)
 {
-    if (buffer == NULL || length == 0)
+    uint64_t start = io_counters::now();
+    if (fd < 0 || length == 0) {
+        ELOG() << "Invalid splice source";
+        m_write_stats.call(0, std::make_error_code(std::errc::invalid_argument),
+                           start);
         throw exception::invalid_input();
+    }
 
-    size_t size_read = 0;
+    std::error_code ec;
+    size_t size_moved = 0;
+    bool use_pipe = open_pipe();
+    struct timespec deadline = deadline_from_now(m_write_timeout);
+
+    while (size_moved != length && !ec) {
+        size_t chunk = std::min(length - size_moved, SPLICE_CHUNK);
+
+        if (use_pipe) {
+            ssize_t n = fill_pipe(fd, chunk, deadline);
+            if (n < 0 && errno == EINVAL) {
+                DLOG() << "Source does not support splice, copy data";
+                use_pipe = false;
+            } else if (n < 0) {
+                ec = std::error_code(errno, std::system_category());
+            } else if (n == 0) {
+                break;
+            } else {
+                drain_pipe(m_fd, n, deadline, ec);
+                if (!ec)
+                    size_moved += n;
+            }
+        } else {
+            uint8_t buffer[SPLICE_COPY_SIZE];
+            int ret = wait_fd(fd, POLLIN, deadline);
+            if (ret < 0) {
+                ec = std::error_code(errno, std::system_category());
+                break;
+            } else if (ret == 0) {
+                ec = std::make_error_code(std::errc::timed_out);
+                break;
+            }
+
+            ssize_t r = read(fd, buffer, std::min(chunk, sizeof(buffer)));
+            if (r < 0) {
+                if (errno == EAGAIN || errno == EINTR)
+                    continue;
+                ec = std::error_code(errno, std::system_category());
+            } else if (r == 0) {
+                break;
+            } else {
+                write_fd(m_fd, buffer, r, deadline, ec);
+                if (!ec)
+                    size_moved += r;
+            }
+        }
+    }
+
+    DLOG() << "Splice " << size_moved << "/" << length << " bytes from " << fd;
+    m_write_stats.call(size_moved, ec, start);
+
+    if (ec)
+        throw_error(ec, size_moved, "Fail to splice");
+
+    return size_moved;
+}
+
+bool serial::open_pipe()
+{
+    if (m_pipe[0] != -1)
+        return true;
+
+    if (pipe2(m_pipe, O_CLOEXEC | O_NONBLOCK) < 0) {
+        WLOG() << "Fail to create splice pipe, copy data";
+        m_pipe[0] = -1;
+        m_pipe[1] = -1;
+        return false;
+    }
+
+    return true;
+}
+
+ssize_t serial::fill_pipe(int fd, size_t length,
+                          const struct timespec &deadline)
+{
+    for (;;) {
+        int ret = wait_fd(fd, POLLIN, deadline);
+        if (ret < 0)
+            return -1;
+        if (ret == 0) {
+            errno = ETIMEDOUT;
+            return -1;
+        }
 
-    fd_set read_set;
-    struct timeval tv = { m_read_timeout / 1000,
-                          (m_read_timeout % 1000) * 1000 };
+        ssize_t n = splice(fd, NULL, m_pipe[1], NULL, length,
+                           SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (n < 0 && (errno == EAGAIN || errno == EINTR))
+            continue;
+        return n;
+    }
+}
 
-    FD_ZERO(&read_set);
-    FD_SET(m_fd, &read_set);
+void serial::drain_pipe(int fd, size_t length,
+                        const struct timespec &deadline, std::error_code &ec)
+{
+    bool use_splice = true;
 
-    while (size_read != length) {
-        int ret = select(m_fd + 1, &read_set, NULL, NULL, &tv);
+    while (length > 0 && !ec) {
+        int ret = wait_fd(fd, POLLOUT, deadline);
         if (ret < 0) {
-            CLOG() << "Internal system function returns error (select)";
-            throw exception::runtime_error("Fail to select");
-        } else if (ret != 0) {
-            if (FD_ISSET(m_fd, &read_set)) {
-                ssize_t r = read(m_fd, buffer + size_read,
-                                       length - size_read);
-                if (r < 0) {
-                    ALOG() << "Fail to read buffer";
-                    throw exception::runtime_error("Fail to read");
-                } else if (r == 0) {
-                    WLOG() << "Timeout error";
-                    DLOG() << "Read only:" << logger::dump(buffer, size_read);
-                    throw exception::timeout(size_read);
-                }
+            ec = std::error_code(errno, std::system_category());
+            break;
+        } else if (ret == 0) {
+            ec = std::make_error_code(std::errc::timed_out);
+            break;
+        }
 
-                size_read += r;
+        if (use_splice) {
+            ssize_t n = splice(m_pipe[0], NULL, fd, NULL, length,
+                               SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (n < 0) {
+                if (errno == EINVAL) {
+                    DLOG() << "Destination does not support splice, copy data";
+                    use_splice = false;
+                } else if (errno != EAGAIN && errno != EINTR) {
+                    ec = std::error_code(errno, std::system_category());
+                }
+                continue;
             }
+            length -= n;
         } else {
-            throw exception::timeout(size_read);
+            uint8_t buffer[SPLICE_COPY_SIZE];
+            ssize_t r = read(m_pipe[0], buffer,
+                             std::min(length, sizeof(buffer)));
+            if (r <= 0) {
+                ec = std::error_code(r < 0 ? errno : EIO,
+                                     std::system_category());
+                break;
+            }
+            write_fd(fd, buffer, r, deadline, ec);
+            length -= r;
         }
     }
 
-    DLOG() << "Read success:" << logger::dump(buffer, size_read);
-    return size_read;
+    // Data left in pipe would be sent by next transfer: drop them.
+    if (ec)
+        close_pipe();
+}
+
+void serial::write_fd(int fd, const uint8_t *buffer, size_t length,
+                      const struct timespec &deadline, std::error_code &ec)
+{
+    while (length > 0) {
+        int ret = wait_fd(fd, POLLOUT, deadline);
+        if (ret < 0) {
+            ec = std::error_code(errno, std::system_category());
+            return;
+        } else if (ret == 0) {
+            ec = std::make_error_code(std::errc::timed_out);
+            return;
+        }
+
+        ssize_t w = write(fd, buffer, length);
+        if (w < 0) {
+            if (errno == EAGAIN || errno == EINTR)
+                continue;
+            ec = std::error_code(errno, std::system_category());
+            return;
+        }
+
+        buffer += w;
+        length -= w;
+    }
+}
+
+void serial::close_pipe()
+{
+    if (m_pipe[0] != -1) {
+        close(m_pipe[0]);
+        close(m_pipe[1]);
+        m_pipe[0] = -1;
+        m_pipe[1] = -1;
+    }
+}
+
+int serial::get_fd() const
+{
+    return m_fd;
+}
+
+serial_stats serial::stats() const
+{
+    serial_stats stats;
+    m_read_stats.snapshot(stats.read);
+    m_write_stats.snapshot(stats.write);
+    return stats;
+}
+
+void serial::set_capture(capture *c)
+{
+    if (c != NULL)
+        m_capture_port = c->add_port(m_device);
+    m_capture = c;
+    ILOG() << (c != NULL ? "Start" : "Stop") << " capture";
+}
+
+struct timespec serial::deadline_from_now(unsigned int timeout)
+{
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout / 1000;
+    deadline.tv_nsec += (timeout % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    return deadline;
+}
+
+int serial::wait_device(short events, const struct timespec &deadline) const
+{
+    return wait_fd(m_fd, events, deadline);
+}
+
+int serial::wait_fd(int fd, short events, const struct timespec &deadline)
+{
+    struct pollfd pfd = { fd, events, 0 };
+    int ret;
+
+    do {
+        struct timespec now;
+        struct timespec remaining = { 0, 0 };
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec < deadline.tv_sec
+            || (now.tv_sec == deadline.tv_sec
+                && now.tv_nsec < deadline.tv_nsec)) {
+            remaining.tv_sec = deadline.tv_sec - now.tv_sec;
+            remaining.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+            if (remaining.tv_nsec < 0) {
+                remaining.tv_sec--;
+                remaining.tv_nsec += 1000000000L;
+            }
+        }
+
+        ret = ppoll(&pfd, 1, &remaining, NULL);
+    } while (ret < 0 && errno == EINTR);
+
+    return ret;
 }
 
 void serial::open_device(const char *device)
@@ -267,72 +1206,107 @@ void serial::open_device(const char *device)
 
 void serial::close_device()
 {
+    close_pipe();
     if (m_fd != -1) {
         close(m_fd);
         m_fd = -1;
     }
 }
 
+/**
+* @brief Termios constant of a standard speed.
+*/
+struct standard_speed {
+    /**
+    * @brief Speed in bps.
+    */
+    unsigned int bps;
+    /**
+    * @brief Termios constant of speed.
+    */
+    speed_t code;
+};
+
+/**
+* @brief Every standard speed known by system, sorted by increasing speed.
+*/
+static const struct standard_speed SPEEDS[] = {
+    { 50, B50 },
+    { 75, B75 },
+    { 110, B110 },
+    { 134, B134 },
+    { 150, B150 },
+    { 200, B200 },
+    { 300, B300 },
+    { 600, B600 },
+    { 1200, B1200 },
+    { 1800, B1800 },
+    { 2400, B2400 },
+    { 4800, B4800 },
+    { 9600, B9600 },
+    { 19200, B19200 },
+    { 38400, B38400 },
+    { 57600, B57600 },
+    { 115200, B115200 },
+    { 230400, B230400 },
+#ifdef B460800
+    { 460800, B460800 },
+#endif
+#ifdef B500000
+    { 500000, B500000 },
+#endif
+#ifdef B576000
+    { 576000, B576000 },
+#endif
+#ifdef B921600
+    { 921600, B921600 },
+#endif
+#ifdef B1000000
+    { 1000000, B1000000 },
+#endif
+#ifdef B1152000
+    { 1152000, B1152000 },
+#endif
+#ifdef B1500000
+    { 1500000, B1500000 },
+#endif
+#ifdef B2000000
+    { 2000000, B2000000 },
+#endif
+#ifdef B2500000
+    { 2500000, B2500000 },
+#endif
+#ifdef B3000000
+    { 3000000, B3000000 },
+#endif
+#ifdef B3500000
+    { 3500000, B3500000 },
+#endif
+#ifdef B4000000
+    { 4000000, B4000000 },
+#endif
+};
+
 void serial::check_and_set_speed(unsigned int new_speed)
 {
-    switch (new_speed) {
-        case 50:
-            m_termios_speed = B50;
-            break;
-        case 75:
-            m_termios_speed = B75;
-            break;
-        case 110:
-            m_termios_speed = B110;
-            break;
-        case 134:
-            m_termios_speed = B134;
-            break;
-        case 150:
-            m_termios_speed = B150;
-            break;
-        case 200:
-            m_termios_speed = B200;
-            break;
-        case 300:
-            m_termios_speed = B300;
-            break;
-        case 600:
-            m_termios_speed = B600;
-            break;
-        case 1200:
-            m_termios_speed = B1200;
-            break;
-        case 1800:
-            m_termios_speed = B1800;
-            break;
-        case 2400:
-            m_termios_speed = B2400;
-            break;
-        case 4800:
-            m_termios_speed = B4800;
-            break;
-        case 9600:
-            m_termios_speed = B9600;
-            break;
-        case 19200:
-            m_termios_speed = B19200;
-            break;
-        case 38400:
-            m_termios_speed = B38400;
-            break;
-        case 57600:
-            m_termios_speed = B57600;
-            break;
-        case 115200:
-            m_termios_speed = B115200;
-            break;
-        case 230400:
-            m_termios_speed = B230400;
-            break;
-        default:
-            ELOG() << new_speed << " is not a valid speed";
-            throw com::exception::invalid_speed(new_speed);
+    const struct standard_speed *last = SPEEDS
+                                      + sizeof(SPEEDS) / sizeof(SPEEDS[0]);
+    const struct standard_speed *found = std::lower_bound(SPEEDS, last,
+            new_speed, [](const struct standard_speed &s, unsigned int bps) {
+                return s.bps < bps;
+            });
+
+    if (found != last && found->bps == new_speed) {
+        m_termios_speed = found->code;
+        m_custom_speed = false;
+    } else if (new_speed != 0 && termios2::supported()) {
+        // Placeholder kept in termios structure: real speed is committed
+        // along with every other setting with termios2.
+        m_termios_speed = B38400;
+        m_custom_speed = true;
+    } else {
+        ELOG() << new_speed << " is not a valid speed";
+        throw com::exception::invalid_speed(new_speed);
     }
 
     cfsetispeed(&m_options, m_termios_speed);
@@ -405,12 +1379,67 @@ void serial::check_and_set_parity(char new_parity)
     }
 }
 
-void serial::commit_termios_configuration()
+void serial::check_and_set_flow_control(flow_control mode)
 {
-    if (tcsetattr(m_fd, TCSAFLUSH, &m_options) < 0) {
+    switch (mode)
+    {
+        case flow_none:
+            m_options.c_cflag &= ~CRTSCTS;
+            m_options.c_iflag &= ~(IXON | IXOFF | IXANY);
+            break;
+        case flow_hardware:
+            m_options.c_cflag |= CRTSCTS;
+            m_options.c_iflag &= ~(IXON | IXOFF | IXANY);
+            break;
+        case flow_software:
+            m_options.c_cflag &= ~CRTSCTS;
+            m_options.c_iflag |= (IXON | IXOFF);
+            m_options.c_iflag &= ~IXANY;
+            m_options.c_cc[VSTART] = 0x11;
+            m_options.c_cc[VSTOP] = 0x13;
+            break;
+        default:
+            ELOG() << mode << " is not a valid flow control";
+            throw com::exception::invalid_flow_control(mode);
+    }
+}
+
+void serial::commit_termios_configuration(int when)
+{
+    bool committed;
+    if (m_custom_speed) {
+        termios2::settings options = {
+            m_options.c_iflag, m_options.c_oflag, m_options.c_cflag,
+            m_options.c_lflag, m_options.c_line, m_options.c_cc, NCCS
+        };
+        committed = termios2::set_custom_speed(m_fd, options, m_speed, when);
+    } else {
+        committed = tcsetattr(m_fd, when, &m_options) == 0;
+    }
+
+    if (!committed) {
+        int error = errno;
+        unsigned int rejected_speed = m_speed;
+        bool custom_speed = m_custom_speed;
+
+        // Keep configuration of instance in line with device
+        m_options = m_committed_options;
+        m_termios_speed = cfgetospeed(&m_options);
+        m_speed = m_committed_speed;
+        m_custom_speed = m_committed_custom_speed;
+
+        if (custom_speed) {
+            ALOG() << "Device rejects " << rejected_speed << " bps ("
+                   << error << ")";
+            throw exception::invalid_speed(rejected_speed);
+        }
         // Fail to apply configuration
         // This shall never happen due to all checks before
         ALOG() << "Inconsistant configuration";
         throw exception::invalid_configuration();
     }
+
+    m_committed_options = m_options;
+    m_committed_speed = m_speed;
+    m_committed_custom_speed = m_custom_speed;
 }
@@ -0,0 +1,59 @@
+/**
+* @file frame.cpp
+* @brief Implementation of com::frame_pool.
+* @author Adrien Oliva
+* @date 2026-10-17
+*/
+#include "comserial/frame.h"
+#include "comserial/exceptions.h"
+#include "logger.h"
+
+using namespace com;
+
+frame_pool::frame_pool(size_t count, size_t capacity)
+    : m_storage()
+    , m_frames()
+    , m_free()
+{
+    if (count == 0 || capacity == 0) {
+        ELOG() << "Invalid frame pool size";
+        throw exception::invalid_input();
+    }
+
+    m_storage.resize(count * capacity);
+    m_frames.resize(count);
+    m_free.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        m_frames[i].data = m_storage.data() + i * capacity;
+        m_frames[i].size = 0;
+        m_frames[i].capacity = capacity;
+        m_free.push_back(&m_frames[count - 1 - i]);
+    }
+}
+
+frame *frame_pool::acquire()
+{
+    if (m_free.empty())
+        return NULL;
+
+    frame *f = m_free.back();
+    m_free.pop_back();
+    f->size = 0;
+    return f;
+}
+
+void frame_pool::release(frame *f)
+{
+    if (f != NULL)
+        m_free.push_back(f);
+}
+
+size_t frame_pool::available() const
+{
+    return m_free.size();
+}
+
+size_t frame_pool::frame_capacity() const
+{
+    return m_storage.size() / m_frames.size();
+}
@@ -16,9 +16,19 @@
 #include <iomanip>
 #include <cstring>
 #include <fstream>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <unistd.h>
 
+#include "binlog.h"
+
 namespace logger {
     /**
     * @brief Allow a human readable representation of a data buffer
@@ -37,6 +47,21 @@ namespace logger {
             */
             dump(const void *data, const size_t size) : m_data(data)
                                                       , m_size(size)
+                                                      , m_address(data)
+            { }
+
+            /**
+            * @brief Create a human readable representation of a buffer
+            *        copied from another place.
+            *
+            * @param data Object based buffer.
+            * @param size Size of data buffer.
+            * @param address Original address of buffer, shown in dump.
+            */
+            dump(const void *data, const size_t size, const void *address)
+                : m_data(data)
+                , m_size(size)
+                , m_address(address)
             { }
 
             ~dump()
@@ -49,70 +74,67 @@ namespace logger {
             */
             std::string get_formatted_string() const
             {
+                static const char hex[] = "0123456789abcdef";
                 const unsigned char *data_ptr =
                                     static_cast<const unsigned char *>(m_data);
 
-                std::stringstream output;
-                output << "Dump " << m_size
-                       << " byte(s) starting at " << m_data << ":";
-
-                std::stringstream offset;
-                std::stringstream hexa;
-                std::stringstream ascii;
-
-                size_t i = 0;
-
-                offset.str("");
-                offset << "\n";
-                offset << std::setw(8) << std::setfill('0')
-                       << std::hex << (i);
-                offset << " ";
-                hexa.str("");
-                ascii.str("");
-                for (i = 0; i < m_size; i++) {
-                    // Add one extra space after 8 bytes.
-                    if (i % 16 == 8) {
-                        ascii << " ";
-                        hexa << " ";
-                    }
+                std::stringstream header;
+                header << "Dump " << m_size
+                       << " byte(s) starting at " << m_address << ":";
+
+                std::string output = header.str();
+                output.reserve(output.size() + (m_size + 15) / 16 * LINE_SIZE);
 
-                    hexa << std::hex << std::setfill('0') << std::setw(2)
-                         << static_cast<unsigned int>(*data_ptr);
-                    hexa << " ";
+                // Line layout: "\n" offset " " hexa(49) "|" ascii(17) "|"
+                char line[LINE_SIZE + 8];
+                for (size_t offset = 0; offset < m_size; offset += 16) {
+                    char *p = line;
+                    *p++ = '\n';
 
-                    if (isprint(*data_ptr))
-                        ascii << (*data_ptr);
-                    else
-                        ascii << ".";
+                    unsigned int digits = 8;
+                    while (digits < 2 * sizeof(size_t)
+                            && (offset >> (4 * digits)) != 0)
+                        digits++;
+                    while (digits-- > 0)
+                        *p++ = hex[(offset >> (4 * digits)) & 0xf];
+                    *p++ = ' ';
 
-                    data_ptr++;
+                    // Padding of last line and extra space after 8 bytes
+                    // come from spaces set here.
+                    memset(p, ' ', 49 + 1 + 17 + 1);
+                    char *hexa = p;
+                    char *ascii = p + 50;
+                    p[49] = '|';
+                    p[67] = '|';
 
-                    if (i % 16 == 15) {
-                        output << offset.str() << hexa.str()
-                               << "|" << ascii.str() << "|";
+                    size_t count = m_size - offset < 16 ? m_size - offset : 16;
+                    for (size_t i = 0; i < count; i++) {
+                        if (i == 8) {
+                            hexa++;
+                            ascii++;
+                        }
 
-                        offset.str("");
-                        offset << "\n";
-                        offset << std::setw(8) << std::setfill('0')
-                               << std::hex << (i + 1);
-                        offset << " ";
-                        hexa.str("");
-                        ascii.str("");
+                        unsigned char c = data_ptr[offset + i];
+                        hexa[0] = hex[c >> 4];
+                        hexa[1] = hex[c & 0xf];
+                        hexa += 3;
+                        *ascii++ = (c >= 0x20 && c < 0x7f)
+                                 ? static_cast<char>(c) : '.';
                     }
-                }
 
-                if (i % 16 != 0) {
-                    output << offset.str();
-                    output << std::setw(49) << std::setfill(' ') << std::left << hexa.str();
-                    output << "|";
-                    output << std::setw(17) << std::setfill(' ') << std::left << ascii.str();
-                    output << "|";
+                    p += 68;
+                    output.append(line, p - line);
                 }
 
-                return output.str();
+                return output;
             }
 
         private:
+            /**
+            * @brief Size of a complete line of dump.
+            */
+            static const size_t LINE_SIZE = 1 + 8 + 1 + 49 + 1 + 17 + 1;
+
             /**
             * @brief Pointer to linked data in instance.
             */
@@ -121,6 +143,31 @@ namespace logger {
             * @brief Size of buffer.
             */
             const size_t m_size;
+            /**
+            * @brief Address shown in dump.
+            */
+            const void *m_address;
+
+        public:
+            /**
+            * @brief Get dumped buffer.
+            *
+            * @return Pointer to buffer.
+            */
+            const void *data() const
+            {
+                return m_data;
+            }
+
+            /**
+            * @brief Get size of dumped buffer.
+            *
+            * @return Size in bytes.
+            */
+            size_t size() const
+            {
+                return m_size;
+            }
     };
 
     /**
@@ -138,6 +185,22 @@ namespace logger {
         return out;
     }
 
+    /**
+    * @brief Id of a log statement in binary logs.
+    *
+    * Every log statement owns a static instance, so that its id is looked
+    * up without allocation nor lock. State holds generation of log header
+    * the id belongs to (high 32 bits) and id itself (low 32 bits): an id of
+    * an older generation is not defined in current log yet. Zero
+    * initialization of static storage gives such a stale state.
+    */
+    struct call_site {
+        /**
+        * @brief Generation and id of call site.
+        */
+        std::atomic<uint64_t> state;
+    };
+
     /**
     * @brief Contains all information needed to localize a given point in
     *        codebase.
@@ -153,12 +216,15 @@ namespace logger {
         * @param function Function name.
         * @param file File name.
         * @param line Line number.
+        * @param site Call site id storage of log statement, if any.
         */
         log_location(const char *function,
                      const char *file,
-                     const size_t line) : m_function(function)
-                                        , m_file(file)
-                                        , m_line(line)
+                     const size_t line,
+                     call_site *site = NULL) : m_function(function)
+                                             , m_file(file)
+                                             , m_line(line)
+                                             , m_site(site)
         { }
 
         /**
@@ -173,6 +239,11 @@ namespace logger {
         * @brief Line number.
         */
         const size_t m_line;
+        /**
+        * @brief Call site id storage, NULL when location is not a static
+        *        log statement.
+        */
+        call_site *const m_site;
     };
 
     /**
@@ -191,6 +262,547 @@ namespace logger {
         trace,
     };
 
+    /**
+    * @brief Storage of process wide log level, defined in header thanks to
+    *        template static member.
+    *
+    * @tparam T Unused.
+    */
+    template<typename T>
+    struct level_storage {
+        /**
+        * @brief Current system log level, or INT_MAX until context is
+        *        loaded so that first log goes through context loading.
+        */
+        static std::atomic<int> value;
+    };
+
+    template<typename T>
+    std::atomic<int> level_storage<T>::value(INT_MAX);
+
+    /**
+    * @brief Asynchronous log sink: producers push preformatted records in a
+    *        bounded lock free ring, a flusher thread writes them by batch.
+    *
+    * Ring is a multiple producers / single consumer queue where each slot
+    * carries a sequence number telling whether it is free or filled. When
+    * ring is full, record is dropped and counted, and a notice with number
+    * of dropped records is written with next batch.
+    */
+    class async_sink
+    {
+        public:
+            /**
+            * @brief Start flusher thread.
+            *
+            * @param output Destination of records, must outlive sink.
+            * @param capacity Number of records in ring, rounded up to next
+            *        power of two.
+            * @param binary Records are binary log records (see binlog.h),
+            *        so that dropped records notice must be one too.
+            */
+            async_sink(std::ostream *output, size_t capacity = 4096,
+                       bool binary = false)
+                : m_slots(round_up(capacity))
+                , m_mask(m_slots.size() - 1)
+                , m_enqueue(0)
+                , m_dropped(0)
+                , m_output(output)
+                , m_binary(binary)
+                , m_dequeue(0)
+                , m_reported(0)
+                , m_written(0)
+                , m_running(true)
+                , m_stop(false)
+                , m_sleeping(false)
+                , m_mutex()
+                , m_wake()
+                , m_flushed()
+                , m_thread()
+            {
+                for (size_t i = 0; i < m_slots.size(); i++)
+                    m_slots[i].sequence.store(i, std::memory_order_relaxed);
+                m_thread = std::thread(&async_sink::flusher, this);
+            }
+
+            /**
+            * @brief Write every pending record and stop flusher thread.
+            */
+            ~async_sink()
+            {
+                stop();
+            }
+
+            async_sink(const async_sink &) = delete;
+            async_sink &operator=(const async_sink &) = delete;
+
+            /**
+            * @brief Queue a record without blocking.
+            *
+            * @param record Complete record to write.
+            *
+            * @return false if ring is full and record is dropped.
+            */
+            bool push(std::string record)
+            {
+                size_t pos = m_enqueue.load(std::memory_order_relaxed);
+                slot *s;
+                for (;;) {
+                    s = &m_slots[pos & m_mask];
+                    size_t seq = s->sequence.load(std::memory_order_acquire);
+                    if (seq == pos) {
+                        if (m_enqueue.compare_exchange_weak(
+                                    pos, pos + 1, std::memory_order_relaxed))
+                            break;
+                    } else if (seq < pos) {
+                        m_dropped.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    } else {
+                        pos = m_enqueue.load(std::memory_order_relaxed);
+                    }
+                }
+
+                s->record = std::move(record);
+                s->sequence.store(pos + 1, std::memory_order_release);
+
+                // Pairs with fence of flusher: either it sees this record
+                // before sleeping, or this sees it sleeping.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (m_sleeping.load(std::memory_order_relaxed))
+                    wake();
+                return true;
+            }
+
+            /**
+            * @brief Wait until every record queued so far is written.
+            */
+            void flush()
+            {
+                size_t target = m_enqueue.load(std::memory_order_acquire);
+                wake();
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_flushed.wait(lock, [this, target] {
+                    return m_written >= target || !m_running;
+                });
+            }
+
+            /**
+            * @brief Write every pending record and stop flusher thread.
+            */
+            void stop()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_stop)
+                        return;
+                    m_stop = true;
+                }
+                m_wake.notify_one();
+                m_thread.join();
+            }
+
+            /**
+            * @brief Check if records are still accepted.
+            *
+            * @return false once sink is stopped.
+            */
+            bool running() const
+            {
+                return m_running.load(std::memory_order_acquire);
+            }
+
+            /**
+            * @brief Get number of records dropped because ring was full.
+            *
+            * @return Number of records.
+            */
+            uint64_t dropped() const
+            {
+                return m_dropped.load(std::memory_order_relaxed);
+            }
+
+        private:
+            /**
+            * @brief Slot of ring.
+            */
+            struct slot {
+                slot() : sequence(0), record() { }
+
+                /**
+                * @brief Position for which slot is free, or position + 1
+                *        once record is filled.
+                */
+                std::atomic<size_t> sequence;
+                /**
+                * @brief Queued record.
+                */
+                std::string record;
+            };
+
+            /**
+            * @brief Round a capacity up to next power of two.
+            *
+            * @param capacity Requested capacity.
+            *
+            * @return Ring size.
+            */
+            static size_t round_up(size_t capacity)
+            {
+                size_t size = 2;
+                while (size < capacity)
+                    size <<= 1;
+                return size;
+            }
+
+            /**
+            * @brief Wake flusher thread up if it sleeps.
+            */
+            void wake()
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_sleeping.load(std::memory_order_relaxed)) {
+                    m_sleeping.store(false, std::memory_order_relaxed);
+                    m_wake.notify_one();
+                }
+            }
+
+            /**
+            * @brief Check if oldest record of ring is ready to be taken.
+            *
+            * @return false if ring is empty.
+            */
+            bool ready() const
+            {
+                const slot &s = m_slots[m_dequeue & m_mask];
+                return s.sequence.load(std::memory_order_acquire)
+                    == m_dequeue + 1;
+            }
+
+            /**
+            * @brief Take oldest record out of ring.
+            *
+            * @param record Output record.
+            *
+            * @return false if ring is empty.
+            */
+            bool pop(std::string &record)
+            {
+                if (!ready())
+                    return false;
+
+                slot &s = m_slots[m_dequeue & m_mask];
+                record.swap(s.record);
+                s.record.clear();
+                s.sequence.store(m_dequeue + m_slots.size(),
+                                 std::memory_order_release);
+                m_dequeue++;
+                return true;
+            }
+
+            /**
+            * @brief Main loop of flusher thread.
+            */
+            void flusher()
+            {
+                std::string batch;
+                std::string record;
+
+                for (;;) {
+                    size_t count = 0;
+                    batch.clear();
+                    while (batch.size() < 65536 && pop(record)) {
+                        batch += record;
+                        count++;
+                    }
+
+                    uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+                    if (dropped != m_reported) {
+                        std::ostringstream notice;
+                        notice << "logger: " << dropped - m_reported
+                               << " message(s) dropped";
+                        if (m_binary) {
+                            std::string chunks;
+                            binlog::text_chunk(chunks, notice.str());
+                            binlog::write_message(batch, binlog::now(), 0,
+                                                  log_level::warn, chunks);
+                        } else {
+                            batch += "[W] " + notice.str() + "\n";
+                        }
+                        m_reported = dropped;
+                    }
+
+                    if (!batch.empty()) {
+                        m_output->write(batch.data(), batch.size());
+                        m_output->flush();
+                    }
+
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_written += count;
+                    m_flushed.notify_all();
+                    if (count != 0)
+                        continue;
+                    if (m_stop)
+                        break;
+
+                    // Producers only lock mutex to wake flusher up once it
+                    // announced it sleeps, so check ring again afterwards.
+                    m_sleeping.store(true, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (ready()) {
+                        m_sleeping.store(false, std::memory_order_relaxed);
+                        continue;
+                    }
+                    m_wake.wait(lock, [this] {
+                        return m_stop
+                            || !m_sleeping.load(std::memory_order_relaxed);
+                    });
+                }
+
+                m_running.store(false, std::memory_order_release);
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_flushed.notify_all();
+            }
+
+            /**
+            * @brief Ring storage.
+            */
+            std::vector<slot> m_slots;
+            /**
+            * @brief Mask to convert a position in ring index.
+            */
+            size_t m_mask;
+            /**
+            * @brief Next position reserved by producers.
+            */
+            std::atomic<size_t> m_enqueue;
+            /**
+            * @brief Number of dropped records.
+            */
+            std::atomic<uint64_t> m_dropped;
+            /**
+            * @brief Destination of records.
+            */
+            std::ostream *m_output;
+            /**
+            * @brief Records are binary log records.
+            */
+            bool m_binary;
+            /**
+            * @brief Next position read by flusher thread.
+            */
+            size_t m_dequeue;
+            /**
+            * @brief Number of dropped records already reported.
+            */
+            uint64_t m_reported;
+            /**
+            * @brief Number of records written, protected by m_mutex.
+            */
+            size_t m_written;
+            /**
+            * @brief Cleared when flusher thread exits.
+            */
+            std::atomic<bool> m_running;
+            /**
+            * @brief Stop request, protected by m_mutex.
+            */
+            bool m_stop;
+            /**
+            * @brief Set by flusher thread before waiting for records, only
+            *        changed with m_mutex held.
+            */
+            std::atomic<bool> m_sleeping;
+            /**
+            * @brief Mutex protecting flusher sleep.
+            */
+            std::mutex m_mutex;
+            /**
+            * @brief Condition to wake up flusher thread.
+            */
+            std::condition_variable m_wake;
+            /**
+            * @brief Condition signaled after each batch.
+            */
+            std::condition_variable m_flushed;
+            /**
+            * @brief Flusher thread.
+            */
+            std::thread m_thread;
+    };
+
+    /**
+    * @brief Process wide logger configuration, loaded once from
+    *        environment.
+    *
+    * Context holds the shared output stream and system log level, so that
+    * a disabled log statement only costs a comparison with an atomic.
+    */
+    class context
+    {
+        public:
+            /**
+            * @brief Get process wide context, loaded on first call.
+            *
+            * @return Logger context.
+            */
+            static context &instance()
+            {
+                // Never destroyed: logs may still be emitted while static
+                // objects are destroyed.
+                static context *ctx = new context();
+                return *ctx;
+            }
+
+            /**
+            * @brief Check if a log level must be printed.
+            *
+            * @param level Level of log statement.
+            *
+            * @return true if log statement must be evaluated.
+            */
+            static bool enabled(log_level level)
+            {
+                return static_cast<int>(level)
+                    <= level_storage<void>::value.load(std::memory_order_relaxed);
+            }
+
+            /**
+            * @brief Get system log level.
+            *
+            * @return Log level loaded from `CSER_LOGLEVEL`.
+            */
+            log_level level() const
+            {
+                return static_cast<log_level>(
+                    level_storage<void>::value.load(std::memory_order_relaxed));
+            }
+
+            /**
+            * @brief Load again configuration from `CSER_LOGDESTINATION` and
+            *        `CSER_LOGLEVEL` environment variables.
+            */
+            void reload();
+
+            /**
+            * @brief Write a complete log message on shared output stream.
+            *
+            * @param message Message to write.
+            */
+            void write(std::string message)
+            {
+                if (m_async != NULL && m_async->running()) {
+                    m_async->push(std::move(message));
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_sink->write(message.data(), message.size());
+                m_sink->flush();
+            }
+
+            /**
+            * @brief Check if messages are written in binary format.
+            *
+            * @return true when `CSER_LOGFORMAT` is `binary`.
+            */
+            bool binary() const
+            {
+                return m_binary;
+            }
+
+            /**
+            * @brief Write a message as a binary log record.
+            *
+            * @param level Level of message.
+            * @param loc Location of log statement.
+            * @param timestamp Time of message in ns since epoch.
+            * @param chunks Content of message (see binlog.h).
+            */
+            void write_binary(log_level level, const log_location &loc,
+                              uint64_t timestamp, const std::string &chunks);
+
+            /**
+            * @brief Wait until every message is written.
+            */
+            void flush()
+            {
+                if (m_async != NULL)
+                    m_async->flush();
+            }
+
+            /**
+            * @brief Get number of messages dropped by asynchronous sink.
+            *
+            * @return Number of messages.
+            */
+            uint64_t dropped() const
+            {
+                return m_async != NULL ? m_async->dropped() : 0;
+            }
+
+        private:
+            context() : m_mutex(), m_sink(NULL), m_async(NULL)
+                      , m_binary(false), m_sites_mutex(), m_generation(0)
+                      , m_last_site(0)
+            {
+                reload();
+            }
+
+            /**
+            * @brief Get id of a call site, defining it when it is not yet.
+            *
+            * @param loc Location of log statement.
+            * @param record Output buffer, where definition is appended if
+            *        any.
+            *
+            * @return Id of call site.
+            */
+            uint32_t site_id(const log_location &loc, std::string &record);
+
+            /**
+            * @brief Write pending messages when process exits.
+            */
+            static void at_exit()
+            {
+                context &ctx = instance();
+                if (ctx.m_async != NULL)
+                    ctx.m_async->stop();
+            }
+
+            context(const context &) = delete;
+            context &operator=(const context &) = delete;
+
+            /**
+            * @brief Serialize access to output stream.
+            */
+            std::mutex m_mutex;
+            /**
+            * @brief Shared output stream.
+            */
+            std::ostream *m_sink;
+            /**
+            * @brief Asynchronous sink writing to m_sink, or NULL when
+            *        messages are written synchronously.
+            */
+            async_sink *m_async;
+            /**
+            * @brief Messages are written as binary log records.
+            */
+            bool m_binary;
+            /**
+            * @brief Serialize call site definitions.
+            */
+            std::mutex m_sites_mutex;
+            /**
+            * @brief Generation of current log header (see call_site).
+            */
+            std::atomic<uint32_t> m_generation;
+            /**
+            * @brief Last call site id defined since current header.
+            */
+            uint32_t m_last_site;
+    };
+
     /**
     * @brief Main class that allow logging to a given ostream destination.
     */
@@ -213,17 +825,70 @@ namespace logger {
                 , m_location(loc)
                 , m_output(destination)
                 , m_systemlevel(system_level)
+                , m_context(NULL)
+                , m_buffer()
+                , m_binary(false)
+                , m_timestamp(0)
+                , m_chunks()
             {
                 if (m_level <= m_systemlevel)
                     print_header();
             }
 
+            /**
+            * @brief Contructor of a logger writing to process wide context.
+            *
+            * @param level The log level of the given logger.
+            * @param loc Information of location of log in code base.
+            * @param ctx Logger context giving output stream and system
+            *        level.
+            *
+            * Message is built in a local buffer and written at once on
+            * shared output stream when logger is destroyed.
+            */
+            InternalLog(log_level level, const log_location &loc,
+                        context &ctx)
+                : m_level(level)
+                , m_location(loc)
+                , m_output(NULL)
+                , m_systemlevel(ctx.level())
+                , m_context(&ctx)
+                , m_buffer()
+                , m_binary(ctx.binary())
+                , m_timestamp(0)
+                , m_chunks()
+            {
+                m_output = &m_buffer;
+                if (m_level > m_systemlevel)
+                    return;
+
+                // Binary records carry location and time instead of header.
+                if (m_binary)
+                    m_timestamp = binlog::now();
+                else
+                    print_header();
+            }
+
             virtual ~InternalLog()
             {
+                if (m_binary) {
+                    if (m_level <= m_systemlevel) {
+                        binlog::text_chunk(m_chunks, m_buffer.str());
+                        m_context->write_binary(m_level, m_location,
+                                                m_timestamp, m_chunks);
+                    }
+                    return;
+                }
+
                 if (m_level <= m_systemlevel) {
                     (*this) << "\n";
                 }
-                closeOstream(m_output);
+                if (m_context != NULL) {
+                    if (m_level <= m_systemlevel)
+                        m_context->write(m_buffer.str());
+                } else {
+                    closeOstream(m_output);
+                }
             }
 
             template<typename T>
@@ -239,8 +904,15 @@ namespace logger {
             */
             friend const InternalLog &operator<<(const InternalLog &out,
                                                  std::ostream &(*f)(std::ostream &));
+            /**
+            * @brief Additional overload to keep raw data of a dump in
+            *        binary logs.
+            *
+            * @return Internal logger instance.
+            */
+            friend const InternalLog &operator<<(const InternalLog &out,
+                                                 const dump &data);
 
-        private:
             /**
             * @brief Convert a log level to a single character.
             *
@@ -248,7 +920,7 @@ namespace logger {
             *
             * @return Single character symbolizes log level.
             */
-            char char_from_level(enum log_level l)
+            static char char_from_level(enum log_level l)
             {
                 switch (l) {
                     case fatal:
@@ -274,6 +946,7 @@ namespace logger {
                 }
             }
 
+        private:
             /**
             * @brief Prepare and print log prefix.
             *
@@ -389,8 +1062,117 @@ namespace logger {
             * @brief System log level.
             */
             log_level m_systemlevel;
+            /**
+            * @brief Logger context, or NULL when writing to a dedicated
+            *        output stream.
+            */
+            context *m_context;
+            /**
+            * @brief Message buffer used with logger context.
+            */
+            std::ostringstream m_buffer;
+            /**
+            * @brief Message is written as a binary log record.
+            */
+            bool m_binary;
+            /**
+            * @brief Time of binary message in ns since epoch.
+            */
+            uint64_t m_timestamp;
+            /**
+            * @brief Chunks of binary message completed so far.
+            */
+            mutable std::string m_chunks;
     };
 
+    /**
+    * Reloading must not happen while other threads are logging.
+    *
+    * When `CSER_LOGASYNC` is set to a non null number, messages are written
+    * by a background thread through an async_sink, so that logging threads
+    * never block on output stream.
+    */
+    inline void context::reload()
+    {
+        static std::once_flag registered;
+
+        // Pending messages are written to previous destination first.
+        delete m_async;
+        m_async = NULL;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        delete m_sink;
+        m_sink = InternalLog::getOstream();
+        level_storage<void>::value.store(InternalLog::getSystemLevel(),
+                                         std::memory_order_relaxed);
+
+        const char *cser_logformat = std::getenv("CSER_LOGFORMAT");
+        m_binary = cser_logformat != NULL
+                && strcmp(cser_logformat, "binary") == 0;
+        if (m_binary) {
+            // Call site ids restart from scratch after each header.
+            std::lock_guard<std::mutex> sites_lock(m_sites_mutex);
+            m_generation.fetch_add(1, std::memory_order_release);
+            m_last_site = 0;
+            std::string header;
+            binlog::write_header(header);
+            m_sink->write(header.data(), header.size());
+            m_sink->flush();
+        }
+
+        const char *cser_logasync = std::getenv("CSER_LOGASYNC");
+        if (cser_logasync != NULL && std::atoi(cser_logasync) != 0) {
+            m_async = new async_sink(m_sink, 4096, m_binary);
+            std::call_once(registered, [] { std::atexit(&context::at_exit); });
+        }
+    }
+
+    /**
+    * A call site is defined in log the first time it is used, along with
+    * its message, so records of a site may precede its definition when
+    * written asynchronously by several threads.
+    */
+    inline void context::write_binary(log_level level, const log_location &loc,
+                                      uint64_t timestamp,
+                                      const std::string &chunks)
+    {
+        std::string record;
+        uint32_t site = site_id(loc, record);
+
+        binlog::write_message(record, timestamp, site, level, chunks);
+        write(std::move(record));
+    }
+
+    /**
+    * Only the first message of a statement after a header takes the lock.
+    * A location without call site storage is defined again each time.
+    */
+    inline uint32_t context::site_id(const log_location &loc,
+                                     std::string &record)
+    {
+        uint64_t generation = m_generation.load(std::memory_order_acquire);
+        if (loc.m_site != NULL) {
+            uint64_t state = loc.m_site->state.load(std::memory_order_acquire);
+            if (state >> 32 == generation)
+                return static_cast<uint32_t>(state);
+        }
+
+        std::lock_guard<std::mutex> lock(m_sites_mutex);
+        if (loc.m_site != NULL) {
+            // Another thread may have defined it meanwhile.
+            uint64_t state = loc.m_site->state.load(std::memory_order_relaxed);
+            if (state >> 32 == generation)
+                return static_cast<uint32_t>(state);
+        }
+
+        uint32_t id = ++m_last_site;
+        binlog::write_site(record, id, loc.m_file, loc.m_line, loc.m_function);
+        if (loc.m_site != NULL)
+            loc.m_site->state.store(generation << 32 | id,
+                                    std::memory_order_release);
+        return id;
+    }
+
     /**
     * @brief Print any type to an internal logger instance.
     *
@@ -440,91 +1222,183 @@ namespace logger {
         return out;
     }
 
+    /**
+    * @brief Print a dump to an internal logger instance.
+    *
+    * @param out Internal logger instance where data will be printed
+    * @param data Dump to print
+    *
+    * @return Internal logger instance used.
+    *
+    * Binary logs keep raw data instead of its hexdump.
+    */
+    inline const InternalLog &operator<<(const InternalLog &out,
+                                         const dump &data)
+    {
+        if (out.m_level > out.m_systemlevel)
+            return out;
+
+        if (out.m_binary) {
+            std::ostringstream &text = static_cast<std::ostringstream &>(
+                                                                *out.m_output);
+            binlog::text_chunk(out.m_chunks, text.str());
+            text.str("");
+            binlog::binary_chunk(out.m_chunks, data.data(), data.size());
+        } else {
+            (*out.m_output) << data;
+        }
+        return out;
+    }
+
+    /**
+    * @brief Logger of statements removed at compile time, accepting
+    *        anything streamed into it.
+    */
+    class null_log {
+        public:
+            template<typename T>
+            const null_log &operator<<(const T &) const
+            {
+                return *this;
+            }
+
+            const null_log &operator<<(std::ostream &(*)(std::ostream &)) const
+            {
+                return *this;
+            }
+    };
+
+    /**
+    * @brief Turn a complete log statement into a void expression, to match
+    *        disabled branch of LOGGER_STATEMENT().
+    *
+    * Operator & has a lower precedence than <<, so the whole statement is
+    * streamed before being discarded.
+    */
+    struct voidify {
+        void operator&(const InternalLog &) const { }
+        void operator&(const null_log &) const { }
+    };
+
 };
 
+/**
+ * @brief Build a log statement of a given level.
+ *
+ * When level is disabled, only a comparison is done and streamed values are
+ * not evaluated. Statement is a single expression, so that macro is safe
+ * inside an unbraced if.
+ */
+#define LOGGER_STATEMENT(level) \
+    !logger::context::enabled(level) ? static_cast<void>(0) : \
+        logger::voidify() & \
+        logger::InternalLog(level, \
+                            logger::log_location(__func__, __FILE__, __LINE__, \
+                                                 LOGGER_CALL_SITE()), \
+                            logger::context::instance())
+
+/**
+ * @brief Get call site id storage of a log statement.
+ *
+ * A lambda gives each statement its own static storage inside an
+ * expression. Storage is zero initialized, so no guard is involved.
+ */
+#define LOGGER_CALL_SITE() \
+    ([]() -> logger::call_site * { \
+        static logger::call_site logger_site; \
+        return &logger_site; \
+    }())
+
+/**
+ * @brief Log statement removed at compile time.
+ *
+ * Streamed values are still type checked, but never evaluated: the whole
+ * statement is folded to nothing by compiler.
+ */
+#define LOGGER_DISABLED() \
+    true ? static_cast<void>(0) : logger::voidify() & logger::null_log()
+
+#ifndef LOGGER_COMPILED_LEVEL
+/**
+ * @brief Most verbose log level compiled in, every level by default.
+ */
+#define LOGGER_COMPILED_LEVEL 9
+#endif
+
 /**
  * @brief Fatal log macro utility to print a fatal message on stderr.
  */
-#define FLOG() logger::InternalLog(logger::log_level::fatal, \
-                                   logger::log_location(__func__, \
-                                                        __FILE__, \
-                                                        __LINE__), \
-                                   logger::InternalLog::getOstream(), \
-                                   logger::InternalLog::getSystemLevel())
+#if LOGGER_COMPILED_LEVEL >= 1
+#define FLOG() LOGGER_STATEMENT(logger::log_level::fatal)
+#else
+#define FLOG() LOGGER_DISABLED()
+#endif
 
 /**
  * @brief Alert log macro utility to print an alert message on stderr.
  */
-#define ALOG() logger::InternalLog(logger::log_level::alert, \
-                                   logger::log_location(__func__, \
-                                                        __FILE__, \
-                                                        __LINE__), \
-                                   logger::InternalLog::getOstream(), \
-                                   logger::InternalLog::getSystemLevel())
+#if LOGGER_COMPILED_LEVEL >= 2
+#define ALOG() LOGGER_STATEMENT(logger::log_level::alert)
+#else
+#define ALOG() LOGGER_DISABLED()
+#endif
 /**
  * @brief Critical log macro utility to print a critical message on stderr.
  */
-#define CLOG() logger::InternalLog(logger::log_level::crit, \
-                                   logger::log_location(__func__, \
-                                                        __FILE__, \
-                                                        __LINE__), \
-                                   logger::InternalLog::getOstream(), \
-                                   logger::InternalLog::getSystemLevel())
+#if LOGGER_COMPILED_LEVEL >= 3
+#define CLOG() LOGGER_STATEMENT(logger::log_level::crit)
+#else
+#define CLOG() LOGGER_DISABLED()
+#endif
 /**
  * @brief Error log macro utility to print an error message on stderr.
  */
-#define ELOG() logger::InternalLog(logger::log_level::error, \
-                                   logger::log_location(__func__, \
-                                                        __FILE__, \
-                                                        __LINE__), \
-                                   logger::InternalLog::getOstream(), \
-                                   logger::InternalLog::getSystemLevel())
+#if LOGGER_COMPILED_LEVEL >= 4
+#define ELOG() LOGGER_STATEMENT(logger::log_level::error)
+#else
+#define ELOG() LOGGER_DISABLED()
+#endif
 /**
  * @brief Warning log macro utility to print a warning message on stderr.
  */
-#define WLOG() logger::InternalLog(logger::log_level::warn, \
-                                   logger::log_location(__func__, \
-                                                        __FILE__, \
-                                                        __LINE__), \
-                                   logger::InternalLog::getOstream(), \
-                                   logger::InternalLog::getSystemLevel())
+#if LOGGER_COMPILED_LEVEL >= 5
+#define WLOG() LOGGER_STATEMENT(logger::log_level::warn)
+#else
+#define WLOG() LOGGER_DISABLED()
+#endif
 /**
  * @brief Notice log macro utility to print a notice message on stderr.
  */
-#define NLOG() logger::InternalLog(logger::log_level::notice, \
-                                   logger::log_location(__func__, \
-                                                        __FILE__, \
-                                                        __LINE__), \
-                                   logger::InternalLog::getOstream(), \
-                                   logger::InternalLog::getSystemLevel())
+#if LOGGER_COMPILED_LEVEL >= 6
+#define NLOG() LOGGER_STATEMENT(logger::log_level::notice)
+#else
+#define NLOG() LOGGER_DISABLED()
+#endif
 /**
  * @brief Information log macro utility to print an information message on
  *        stderr.
  */
-#define ILOG() logger::InternalLog(logger::log_level::info, \
-                                   logger::log_location(__func__, \
-                                                        __FILE__, \
-                                                        __LINE__), \
-                                   logger::InternalLog::getOstream(), \
-                                   logger::InternalLog::getSystemLevel())
+#if LOGGER_COMPILED_LEVEL >= 7
+#define ILOG() LOGGER_STATEMENT(logger::log_level::info)
+#else
+#define ILOG() LOGGER_DISABLED()
+#endif
 /**
  * @brief Debug log macro utility to print a debug message on stderr.
  */
-#define DLOG() logger::InternalLog(logger::log_level::debug, \
-                                   logger::log_location(__func__, \
-                                                        __FILE__, \
-                                                        __LINE__), \
-                                   logger::InternalLog::getOstream(), \
-                                   logger::InternalLog::getSystemLevel())
+#if LOGGER_COMPILED_LEVEL >= 8
+#define DLOG() LOGGER_STATEMENT(logger::log_level::debug)
+#else
+#define DLOG() LOGGER_DISABLED()
+#endif
 /**
  * @brief Trace log macro utility to print a trace message on stderr.
  */
-#define TLOG() logger::InternalLog(logger::log_level::trace, \
-                                   logger::log_location(__func__, \
-                                                        __FILE__, \
-                                                        __LINE__), \
-                                   logger::InternalLog::getOstream(), \
-                                   logger::InternalLog::getSystemLevel())
+#if LOGGER_COMPILED_LEVEL >= 9
+#define TLOG() LOGGER_STATEMENT(logger::log_level::trace)
+#else
+#define TLOG() LOGGER_DISABLED()
+#endif
 
 #endif
 #endif /* end of include guard: LOGGER_H_SOWJCIS8 */
@@ -0,0 +1,226 @@
+/**
+* @file reactor.cpp
+* @brief Implementation of com::reactor.
+* @author Adrien Oliva
+* @date 2026-10-16
+*/
+#include "comserial/reactor.h"
+#include "logger.h"
+
+#include <cerrno>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+using namespace com;
+
+reactor::reactor(size_t batch_size)
+    : m_epfd(-1)
+    , m_wakefd(-1)
+    , m_stopped(false)
+    , m_events()
+    , m_registrations()
+    , m_removed()
+{
+    if (batch_size == 0) {
+        ELOG() << "Invalid reactor batch size";
+        throw exception::invalid_input();
+    }
+
+    m_epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epfd < 0) {
+        CLOG() << "Internal system function returns error (epoll_create1)";
+        throw exception::runtime_error("Fail to create epoll instance");
+    }
+
+    m_wakefd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_wakefd < 0) {
+        close(m_epfd);
+        CLOG() << "Internal system function returns error (eventfd)";
+        throw exception::runtime_error("Fail to create event file descriptor");
+    }
+
+    struct epoll_event ev = { };
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    if (epoll_ctl(m_epfd, EPOLL_CTL_ADD, m_wakefd, &ev) < 0) {
+        close(m_wakefd);
+        close(m_epfd);
+        CLOG() << "Internal system function returns error (epoll_ctl)";
+        throw exception::runtime_error("Fail to register wake up event");
+    }
+
+    m_events.resize(batch_size);
+
+    ILOG() << "New reactor (batch of " << batch_size << " events)";
+}
+
+reactor::~reactor()
+{
+    ILOG() << "Destroy reactor";
+    for (auto &it: m_registrations)
+        delete it.second;
+    for (auto &it: m_removed)
+        delete it;
+
+    close(m_wakefd);
+    close(m_epfd);
+}
+
+void reactor::add(serial &device, const handler &callback, unsigned int events)
+{
+    int fd = device.get_fd();
+
+    if (!callback || m_registrations.find(fd) != m_registrations.end()) {
+        ELOG() << "Invalid device registration";
+        throw exception::invalid_input();
+    }
+
+    registration *r = new registration;
+    r->device = &device;
+    r->callback = callback;
+
+    struct epoll_event ev = { };
+    ev.events = to_epoll(events);
+    ev.data.ptr = r;
+    if (epoll_ctl(m_epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        delete r;
+        CLOG() << "Internal system function returns error (epoll_ctl)";
+        throw exception::runtime_error("Fail to add device");
+    }
+
+    m_registrations[fd] = r;
+
+    DLOG() << "Register device " << fd << " (events " << events << ")";
+}
+
+void reactor::modify(serial &device, unsigned int events)
+{
+    int fd = device.get_fd();
+
+    auto it = m_registrations.find(fd);
+    if (it == m_registrations.end()) {
+        ELOG() << "Device " << fd << " not registered";
+        throw exception::invalid_input();
+    }
+
+    struct epoll_event ev = { };
+    ev.events = to_epoll(events);
+    ev.data.ptr = it->second;
+    if (epoll_ctl(m_epfd, EPOLL_CTL_MOD, fd, &ev) < 0) {
+        CLOG() << "Internal system function returns error (epoll_ctl)";
+        throw exception::runtime_error("Fail to modify device");
+    }
+
+    DLOG() << "Modify device " << fd << " (events " << events << ")";
+}
+
+bool reactor::remove(serial &device)
+{
+    int fd = device.get_fd();
+
+    auto it = m_registrations.find(fd);
+    if (it == m_registrations.end())
+        return false;
+
+    epoll_ctl(m_epfd, EPOLL_CTL_DEL, fd, NULL);
+
+    // Registration may still be referenced by pending events of current
+    // batch: only invalidate it and release it after dispatch.
+    it->second->device = NULL;
+    m_removed.push_back(it->second);
+    m_registrations.erase(it);
+
+    DLOG() << "Unregister device " << fd;
+    return true;
+}
+
+size_t reactor::size() const
+{
+    return m_registrations.size();
+}
+
+size_t reactor::run_once(int timeout)
+{
+    int ret = epoll_wait(m_epfd, m_events.data(),
+                         static_cast<int>(m_events.size()), timeout);
+    if (ret < 0) {
+        if (errno == EINTR)
+            return 0;
+        CLOG() << "Internal system function returns error (epoll_wait)";
+        throw exception::runtime_error("Fail to wait for events");
+    }
+
+    size_t dispatched = 0;
+    try {
+        for (int i = 0; i < ret; i++) {
+            registration *r = static_cast<registration *>(m_events[i].data.ptr);
+            if (r == NULL) {
+                uint64_t value;
+                if (read(m_wakefd, &value, sizeof(value)) < 0)
+                    TLOG() << "Spurious wake up";
+                continue;
+            }
+
+            if (r->device == NULL)
+                continue;
+
+            r->callback(*r->device, from_epoll(m_events[i].events));
+            dispatched++;
+        }
+    } catch (...) {
+        for (auto &it: m_removed)
+            delete it;
+        m_removed.clear();
+        throw;
+    }
+
+    for (auto &it: m_removed)
+        delete it;
+    m_removed.clear();
+
+    return dispatched;
+}
+
+void reactor::run()
+{
+    ILOG() << "Start reactor";
+    while (!m_stopped.load())
+        run_once(-1);
+    m_stopped.store(false);
+    ILOG() << "Reactor stopped";
+}
+
+void reactor::stop()
+{
+    uint64_t value = 1;
+
+    m_stopped.store(true);
+    if (write(m_wakefd, &value, sizeof(value)) < 0)
+        TLOG() << "Reactor already woken up";
+}
+
+uint32_t reactor::to_epoll(unsigned int events)
+{
+    uint32_t ev = 0;
+
+    if (events & readable)
+        ev |= EPOLLIN;
+    if (events & writable)
+        ev |= EPOLLOUT;
+
+    return ev;
+}
+
+unsigned int reactor::from_epoll(uint32_t events)
+{
+    unsigned int ev = 0;
+
+    if (events & EPOLLIN)
+        ev |= readable;
+    if (events & EPOLLOUT)
+        ev |= writable;
+    if (events & (EPOLLERR | EPOLLHUP))
+        ev |= error;
+
+    return ev;
+}
@@ -0,0 +1,232 @@
+/**
+* @file replayer.cpp
+* @brief Implementation of com::replayer.
+* @author Adrien Oliva
+* @date 2026-10-17
+*/
+#include "comserial/replayer.h"
+#include "comserial/exceptions.h"
+#include "comserial/stats.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace com;
+
+/**
+* @brief Longest wait without checking if replay is stopped, in ms.
+*/
+static const int STOP_CHECK = 100;
+
+replayer::replayer(const std::vector<std::string> &files,
+                   const std::string &port)
+    : m_data()
+    , m_chunks()
+    , m_master(-1)
+    , m_slave(-1)
+    , m_path()
+    , m_stopped(false)
+{
+    if (files.empty()) {
+        ELOG() << "No capture file to replay";
+        throw exception::invalid_input();
+    }
+
+    std::string name = port;
+    bool found = false;
+    uint64_t first = 0;
+
+    for (const std::string &path: files) {
+        capture_reader reader(path);
+        capture_record r;
+        bool defined = false;
+        uint16_t id = 0;
+
+        // Port ids are resolved by name in each file.
+        while (reader.next(r)) {
+            if (r.dir == capture::port) {
+                std::string defined_name(reinterpret_cast<const char *>(r.data),
+                                         r.size);
+                if (name.empty())
+                    name = defined_name;
+                if (defined_name == name) {
+                    defined = true;
+                    id = r.port;
+                }
+                continue;
+            }
+            if (!defined || r.dir != capture::rx || r.port != id)
+                continue;
+
+            if (m_chunks.empty())
+                first = r.timestamp;
+            chunk c;
+            c.time = r.timestamp > first ? r.timestamp - first : 0;
+            c.offset = m_data.size();
+            c.size = r.size;
+            m_data.insert(m_data.end(), r.data, r.data + r.size);
+            m_chunks.push_back(c);
+        }
+        found = found || defined;
+    }
+
+    if (!found) {
+        ELOG() << "Port " << name << " not found in capture";
+        throw exception::invalid_input();
+    }
+
+    char path[256];
+    if (openpty(&m_master, &m_slave, path, NULL, NULL) < 0) {
+        CLOG() << "Internal system function returns error (openpty)";
+        throw exception::runtime_error("Fail to open pseudo terminal");
+    }
+    m_path = path;
+
+    struct termios options;
+    if (tcgetattr(m_slave, &options) == 0) {
+        cfmakeraw(&options);
+        tcsetattr(m_slave, TCSANOW, &options);
+    }
+    fcntl(m_master, F_SETFL, fcntl(m_master, F_GETFL) | O_NONBLOCK);
+
+    ILOG() << "Replay " << m_chunks.size() << " records of " << name
+           << " on " << m_path;
+}
+
+replayer::~replayer()
+{
+    close(m_slave);
+    close(m_master);
+}
+
+const std::string &replayer::device_path() const
+{
+    return m_path;
+}
+
+size_t replayer::records() const
+{
+    return m_chunks.size();
+}
+
+replay_stats replayer::run(double scale)
+{
+    if (scale < 0.0) {
+        ELOG() << "Invalid time scale";
+        throw exception::invalid_input();
+    }
+
+    replay_stats stats = { 0, 0, 0, 0, 0 };
+    uint64_t start = io_counters::now();
+
+    for (const chunk &c: m_chunks) {
+        if (scale > 0.0) {
+            uint64_t due = start + static_cast<uint64_t>(c.time / scale);
+            uint64_t now = io_counters::now();
+
+            // Keep device user writes flowing while waiting.
+            while (now < due && !m_stopped.load()) {
+                uint64_t wait = std::min<uint64_t>(due - now,
+                                                   STOP_CHECK * 1000000ULL);
+                struct timespec ts;
+                ts.tv_sec = static_cast<time_t>(wait / 1000000000ULL);
+                ts.tv_nsec = static_cast<long>(wait % 1000000000ULL);
+                struct pollfd pfd = { m_master, POLLIN, 0 };
+                if (ppoll(&pfd, 1, &ts, NULL) > 0)
+                    discard(stats);
+                now = io_counters::now();
+            }
+            if (now > due)
+                stats.max_lag = std::max(stats.max_lag, now - due);
+        }
+
+        if (!feed(c, stats))
+            break;
+        stats.records++;
+    }
+
+    stats.elapsed = io_counters::now() - start;
+    DLOG() << "Replayed " << stats.records << " records, " << stats.bytes
+           << " bytes in " << stats.elapsed << "ns";
+    return stats;
+}
+
+void replayer::stop()
+{
+    m_stopped.store(true);
+}
+
+bool replayer::wait_drained(unsigned int timeout)
+{
+    replay_stats ignored = { 0, 0, 0, 0, 0 };
+    uint64_t deadline = io_counters::now() + timeout * 1000000ULL;
+
+    for (;;) {
+        // Polling slave pushes data still in flight to its input queue
+        struct pollfd slave = { m_slave, POLLIN, 0 };
+        poll(&slave, 1, 0);
+
+        int pending = 0;
+        if (ioctl(m_slave, FIONREAD, &pending) < 0 || pending == 0)
+            return true;
+        if (io_counters::now() >= deadline || m_stopped.load())
+            return false;
+
+        struct pollfd pfd = { m_master, POLLIN, 0 };
+        if (poll(&pfd, 1, 1) > 0)
+            discard(ignored);
+    }
+}
+
+bool replayer::feed(const chunk &c, replay_stats &stats)
+{
+    size_t done = 0;
+
+    while (done < c.size) {
+        if (m_stopped.load())
+            return false;
+
+        struct pollfd pfd = { m_master, POLLIN | POLLOUT, 0 };
+        int ret = poll(&pfd, 1, STOP_CHECK);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            CLOG() << "Internal system function returns error (poll)";
+            throw exception::runtime_error("Fail to wait pseudo terminal");
+        }
+
+        if (pfd.revents & POLLIN)
+            discard(stats);
+        if (pfd.revents & POLLOUT) {
+            ssize_t w = write(m_master, &m_data[c.offset + done],
+                              c.size - done);
+            if (w < 0) {
+                if (errno == EAGAIN || errno == EINTR)
+                    continue;
+                ALOG() << "Fail to write pseudo terminal";
+                throw exception::runtime_error("Fail to write");
+            }
+            done += w;
+            stats.bytes += w;
+        }
+    }
+
+    return true;
+}
+
+void replayer::discard(replay_stats &stats)
+{
+    uint8_t buffer[4096];
+    ssize_t r;
+
+    while ((r = read(m_master, buffer, sizeof(buffer))) > 0)
+        stats.discarded += r;
+}
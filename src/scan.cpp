@@ -0,0 +1,120 @@
+/**
+* @file scan.cpp
+* @brief Implementation of vectorized delimiter search.
+* @author Adrien Oliva
+* @date 2026-10-17
+*/
+#include "scan.h"
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define SCAN_X86 1
+#endif
+
+using namespace com;
+
+size_t scan::find_any_scalar(const uint8_t *data, size_t size,
+                             const uint8_t *set, size_t count)
+{
+    bool match[256] = { false };
+    for (size_t i = 0; i < count; i++)
+        match[set[i]] = true;
+
+    for (size_t i = 0; i < size; i++)
+        if (match[data[i]])
+            return i;
+    return size;
+}
+
+#ifdef SCAN_X86
+
+/**
+* @brief SSE2 version of find_any() for a set of at most MAX_VECTOR_SET
+*        bytes.
+*
+* @param data Data to search.
+* @param size Size of data.
+* @param set Bytes to look for.
+* @param count Number of bytes in set.
+*
+* @return Same as find_any().
+*/
+static size_t find_any_sse2(const uint8_t *data, size_t size,
+                            const uint8_t *set, size_t count)
+{
+    __m128i needles[scan::MAX_VECTOR_SET];
+    for (size_t k = 0; k < count; k++)
+        needles[k] = _mm_set1_epi8(static_cast<char>(set[k]));
+
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(
+                            reinterpret_cast<const __m128i *>(data + i));
+        __m128i m = _mm_cmpeq_epi8(v, needles[0]);
+        for (size_t k = 1; k < count; k++)
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(v, needles[k]));
+        int mask = _mm_movemask_epi8(m);
+        if (mask != 0)
+            return i + __builtin_ctz(static_cast<unsigned int>(mask));
+    }
+
+    return i + scan::find_any_scalar(data + i, size - i, set, count);
+}
+
+/**
+* @brief AVX2 version of find_any() for a set of at most MAX_VECTOR_SET
+*        bytes.
+*
+* @param data Data to search.
+* @param size Size of data.
+* @param set Bytes to look for.
+* @param count Number of bytes in set.
+*
+* @return Same as find_any().
+*/
+__attribute__((target("avx2")))
+static size_t find_any_avx2(const uint8_t *data, size_t size,
+                            const uint8_t *set, size_t count)
+{
+    __m256i needles[scan::MAX_VECTOR_SET];
+    for (size_t k = 0; k < count; k++)
+        needles[k] = _mm256_set1_epi8(static_cast<char>(set[k]));
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(
+                            reinterpret_cast<const __m256i *>(data + i));
+        __m256i m = _mm256_cmpeq_epi8(v, needles[0]);
+        for (size_t k = 1; k < count; k++)
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, needles[k]));
+        int mask = _mm256_movemask_epi8(m);
+        if (mask != 0)
+            return i + __builtin_ctz(static_cast<unsigned int>(mask));
+    }
+
+    return i + find_any_sse2(data + i, size - i, set, count);
+}
+
+#endif
+
+size_t scan::find_any(const uint8_t *data, size_t size, const uint8_t *set,
+                      size_t count)
+{
+    if (count == 1) {
+        const void *found = memchr(data, set[0], size);
+        return found == NULL ? size
+                             : static_cast<const uint8_t *>(found) - data;
+    }
+
+#ifdef SCAN_X86
+    if (count != 0 && count <= MAX_VECTOR_SET) {
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        return avx2 ? find_any_avx2(data, size, set, count)
+                    : find_any_sse2(data, size, set, count);
+    }
+#endif
+
+    return find_any_scalar(data, size, set, count);
+}
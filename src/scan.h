@@ -0,0 +1,57 @@
+/**
+* @file scan.h
+* @brief Vectorized search of delimiter bytes in received data.
+* @author Adrien Oliva
+* @date 2026-10-17
+*
+* A single byte is searched with memchr(), already vectorized by the C
+* library. A set of up to MAX_VECTOR_SET bytes is compared 32 bytes at once
+* with AVX2 when processor supports it, 16 bytes at once with SSE2 on any
+* x86-64 processor, and otherwise looked up byte per byte in a table.
+*/
+#ifndef SCAN_H_K2HW7PZC
+#define SCAN_H_K2HW7PZC
+
+#include <cstddef>
+#include <cstdint>
+
+namespace com {
+
+    namespace scan {
+
+        /**
+        * @brief Largest set of bytes searched with vector instructions.
+        */
+        static const size_t MAX_VECTOR_SET = 8;
+
+        /**
+        * @brief Find first byte of data belonging to a set.
+        *
+        * @param data Data to search.
+        * @param size Size of data.
+        * @param set Bytes to look for.
+        * @param count Number of bytes in set.
+        *
+        * @return Index of first matching byte, or size when none matches.
+        */
+        size_t find_any(const uint8_t *data, size_t size, const uint8_t *set,
+                        size_t count);
+
+        /**
+        * @brief Byte per byte version of find_any(), used as fallback.
+        *
+        * @param data Data to search.
+        * @param size Size of data.
+        * @param set Bytes to look for.
+        * @param count Number of bytes in set.
+        *
+        * @return Same as find_any().
+        */
+        size_t find_any_scalar(const uint8_t *data, size_t size,
+                               const uint8_t *set, size_t count);
+
+    };
+
+};
+
+#endif /* end of include guard: SCAN_H_K2HW7PZC */
@@ -0,0 +1,213 @@
+/**
+* @file shmstats.cpp
+* @brief Publication of device statistics in shared memory.
+* @author Adrien Oliva
+* @date 2026-10-17
+*/
+#include "shmstats.h"
+#include "comserial/cppcomserial.h"
+#include "logger.h"
+
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace com;
+
+namespace {
+
+    /**
+    * @brief Segment of an exported device.
+    */
+    struct exported {
+        /**
+        * @brief Name of segment.
+        */
+        std::string name;
+        /**
+        * @brief Mapping of segment.
+        */
+        shmstats::segment *seg;
+    };
+
+    /**
+    * @brief Process wide publisher of statistics, never destroyed so that
+    *        devices may be closed during static destruction.
+    */
+    class publisher {
+        public:
+            static publisher &instance()
+            {
+                static publisher *p = new publisher();
+                return *p;
+            }
+
+            /**
+            * @brief Start publishing statistics of a device.
+            *
+            * @param device Device to publish.
+            * @param path Path name of device.
+            * @param period Refresh period in ms.
+            */
+            void add(const serial &device, const std::string &path,
+                     unsigned int period)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                exported e;
+                e.name = "/" + std::string(shmstats::PREFIX)
+                       + std::to_string(getpid()) + "."
+                       + std::to_string(m_next_id++);
+                e.seg = create(e.name, path, period);
+                if (e.seg == NULL)
+                    return;
+
+                m_devices[&device] = e;
+                if (period < m_period)
+                    m_period = period;
+                if (!m_started) {
+                    // Thread is never joined: it only dies with process.
+                    std::thread(&publisher::run, this).detach();
+                    m_started = true;
+                }
+                m_cond.notify_one();
+            }
+
+            /**
+            * @brief Stop publishing statistics of a device.
+            *
+            * @param device Device given to add().
+            */
+            void remove(const serial &device)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_devices.find(&device);
+                if (it == m_devices.end())
+                    return;
+
+                munmap(it->second.seg, sizeof(shmstats::segment));
+                shm_unlink(it->second.name.c_str());
+                m_devices.erase(it);
+            }
+
+        private:
+            publisher() : m_mutex(), m_cond(), m_devices(), m_next_id(0)
+                        , m_period(UINT_MAX), m_started(false)
+            { }
+
+            /**
+            * @brief Create and map a new segment.
+            *
+            * @param name Name of segment.
+            * @param path Path name of device.
+            * @param period Refresh period in ms.
+            *
+            * @return Mapped segment, or NULL on error.
+            */
+            static shmstats::segment *create(const std::string &name,
+                                             const std::string &path,
+                                             unsigned int period)
+            {
+                int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL,
+                                  0644);
+                if (fd < 0) {
+                    WLOG() << "Fail to create statistics segment " << name;
+                    return NULL;
+                }
+
+                void *addr = MAP_FAILED;
+                if (ftruncate(fd, sizeof(shmstats::segment)) == 0)
+                    addr = mmap(NULL, sizeof(shmstats::segment),
+                                PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                close(fd);
+                if (addr == MAP_FAILED) {
+                    WLOG() << "Fail to map statistics segment " << name;
+                    shm_unlink(name.c_str());
+                    return NULL;
+                }
+
+                // New segment is zero filled: counters and sequence are
+                // already valid, header is completed by magic.
+                auto *seg = static_cast<shmstats::segment *>(addr);
+                seg->version = shmstats::LAYOUT_VERSION;
+                seg->size = sizeof(shmstats::segment);
+                seg->pid = static_cast<uint32_t>(getpid());
+                seg->period = period;
+                path.copy(seg->device, sizeof(seg->device) - 1);
+                std::atomic_thread_fence(std::memory_order_release);
+                memcpy(seg->magic, shmstats::MAGIC, sizeof(shmstats::MAGIC));
+
+                DLOG() << "Export statistics of " << path << " in " << name;
+                return seg;
+            }
+
+            /**
+            * @brief Main loop of publisher thread.
+            */
+            void run()
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                for (;;) {
+                    uint64_t now = io_counters::now();
+                    for (auto &it: m_devices)
+                        shmstats::store(*it.second.seg, it.first->stats(),
+                                        now);
+
+                    m_cond.wait_for(lock, std::chrono::milliseconds(m_period));
+                }
+            }
+
+        private:
+            /**
+            * @brief Protect devices.
+            */
+            std::mutex m_mutex;
+            /**
+            * @brief Wake up publisher thread when a device is added.
+            */
+            std::condition_variable m_cond;
+            /**
+            * @brief Exported devices.
+            */
+            std::unordered_map<const serial *, exported> m_devices;
+            /**
+            * @brief Id of next segment.
+            */
+            unsigned int m_next_id;
+            /**
+            * @brief Shortest requested refresh period in ms.
+            */
+            unsigned int m_period;
+            /**
+            * @brief Publisher thread is running.
+            */
+            bool m_started;
+    };
+
+};
+
+void shmstats::attach(const serial &device, const std::string &path)
+{
+    const char *cser_shmstats = std::getenv("CSER_SHMSTATS");
+    if (cser_shmstats == NULL)
+        return;
+
+    int period = std::atoi(cser_shmstats);
+    if (period <= 0)
+        return;
+
+    publisher::instance().add(device, path, static_cast<unsigned int>(period));
+}
+
+void shmstats::detach(const serial &device)
+{
+    publisher::instance().remove(device);
+}
@@ -0,0 +1,199 @@
+/**
+* @file shmstats.h
+* @brief Export of device statistics in shared memory, read by
+*        comserial-top.
+* @author Adrien Oliva
+* @date 2026-10-17
+*
+* When `CSER_SHMSTATS` environment variable is set to a period in ms, each
+* com::serial gets a /dev/shm/comserial.<pid>.<id> segment, refreshed by a
+* single background thread of process with a snapshot of serial::stats().
+* I/O threads never touch segments, and monitoring tools only map them, so
+* no system call nor IPC is needed on either side.
+*
+* Segment is written under a sequence lock: writer makes sequence odd,
+* updates counters, then makes it even again. Reader retries its copy until
+* it sees the same even sequence before and after it.
+*/
+#ifndef SHMSTATS_H_T5LM2VXQ
+#define SHMSTATS_H_T5LM2VXQ
+
+#include <comserial/stats.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if ATOMIC_LLONG_LOCK_FREE != 2
+#error "Statistics export needs lock free 64 bits atomics"
+#endif
+
+namespace com {
+
+    class serial;
+
+    namespace shmstats {
+
+        /**
+        * @brief Prefix of segment names.
+        */
+        static const char PREFIX[] = "comserial.";
+        /**
+        * @brief First bytes of a segment.
+        */
+        static const char MAGIC[8] = { 'C', 'S', 'E', 'R', 'S', 'H', 'M', 0 };
+        /**
+        * @brief Layout version, incremented on any change of segment.
+        */
+        static const uint32_t LAYOUT_VERSION = 1;
+        /**
+        * @brief Number of counters per direction.
+        */
+        static const size_t FIELDS = 6 + io_stats::LATENCY_BUCKETS;
+
+        /**
+        * @brief Layout of a shared memory segment.
+        */
+        struct segment {
+            /**
+            * @brief MAGIC, written last when segment is created.
+            */
+            char magic[8];
+            /**
+            * @brief Layout version (LAYOUT_VERSION).
+            */
+            uint32_t version;
+            /**
+            * @brief Size of segment.
+            */
+            uint32_t size;
+            /**
+            * @brief Process owning device.
+            */
+            uint32_t pid;
+            /**
+            * @brief Refresh period in ms.
+            */
+            uint32_t period;
+            /**
+            * @brief Path name of device, NUL terminated.
+            */
+            char device[256];
+            /**
+            * @brief Sequence lock, odd while counters are updated.
+            */
+            std::atomic<uint64_t> sequence;
+            /**
+            * @brief Time of last refresh in ns on CLOCK_MONOTONIC.
+            */
+            std::atomic<uint64_t> timestamp;
+            /**
+            * @brief Counters of read then write direction, in io_stats
+            *        order.
+            */
+            std::atomic<uint64_t> counters[2][FIELDS];
+        };
+
+        /**
+        * @brief Write a statistics snapshot in a segment (single writer).
+        *
+        * @param seg Segment to update.
+        * @param stats Snapshot to write.
+        * @param timestamp Time of snapshot in ns on CLOCK_MONOTONIC.
+        */
+        inline void store(segment &seg, const serial_stats &stats,
+                          uint64_t timestamp)
+        {
+            const io_stats *directions[2] = { &stats.read, &stats.write };
+            uint64_t sequence = seg.sequence.load(std::memory_order_relaxed);
+
+            seg.sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            seg.timestamp.store(timestamp, std::memory_order_relaxed);
+            for (size_t d = 0; d < 2; d++) {
+                const io_stats &io = *directions[d];
+                std::atomic<uint64_t> *c = seg.counters[d];
+                c[0].store(io.bytes, std::memory_order_relaxed);
+                c[1].store(io.calls, std::memory_order_relaxed);
+                c[2].store(io.syscalls, std::memory_order_relaxed);
+                c[3].store(io.timeouts, std::memory_order_relaxed);
+                c[4].store(io.timeout_bytes, std::memory_order_relaxed);
+                c[5].store(io.errors, std::memory_order_relaxed);
+                for (size_t i = 0; i < io_stats::LATENCY_BUCKETS; i++)
+                    c[6 + i].store(io.latency[i], std::memory_order_relaxed);
+            }
+
+            seg.sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        /**
+        * @brief Read a consistent statistics snapshot from a segment.
+        *
+        * @param seg Segment to read.
+        * @param stats Output snapshot.
+        * @param timestamp Output time of snapshot.
+        *
+        * @return false when segment is not a valid one, or is never left
+        *         consistent by writer.
+        */
+        inline bool load(const segment &seg, serial_stats &stats,
+                         uint64_t &timestamp)
+        {
+            if (memcmp(seg.magic, MAGIC, sizeof(MAGIC)) != 0
+                    || seg.version != LAYOUT_VERSION
+                    || seg.size != sizeof(segment))
+                return false;
+
+            io_stats *directions[2] = { &stats.read, &stats.write };
+
+            // Writer may have died while updating segment: do not spin.
+            for (size_t attempt = 0; attempt < 1000; attempt++) {
+                uint64_t before = seg.sequence.load(std::memory_order_acquire);
+
+                timestamp = seg.timestamp.load(std::memory_order_relaxed);
+                for (size_t d = 0; d < 2; d++) {
+                    io_stats &io = *directions[d];
+                    const std::atomic<uint64_t> *c = seg.counters[d];
+                    io.bytes = c[0].load(std::memory_order_relaxed);
+                    io.calls = c[1].load(std::memory_order_relaxed);
+                    io.syscalls = c[2].load(std::memory_order_relaxed);
+                    io.timeouts = c[3].load(std::memory_order_relaxed);
+                    io.timeout_bytes = c[4].load(std::memory_order_relaxed);
+                    io.errors = c[5].load(std::memory_order_relaxed);
+                    for (size_t i = 0; i < io_stats::LATENCY_BUCKETS; i++)
+                        io.latency[i] = c[6 + i].load(
+                                                std::memory_order_relaxed);
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                uint64_t after = seg.sequence.load(std::memory_order_relaxed);
+                if ((before & 1) == 0 && before == after)
+                    return true;
+            }
+
+            return false;
+        }
+
+        /**
+        * @brief Export statistics of a device when enabled by environment.
+        *
+        * @param device Device to export.
+        * @param path Path name of device.
+        */
+        void attach(const serial &device, const std::string &path);
+
+        /**
+        * @brief Stop exporting statistics of a device and remove its
+        *        segment.
+        *
+        * @param device Device given to attach().
+        */
+        void detach(const serial &device);
+
+    };
+
+};
+
+#endif /* end of include guard: SHMSTATS_H_T5LM2VXQ */
@@ -0,0 +1,204 @@
+/**
+* @file slip.cpp
+* @brief Implementation of com::slip_codec and com::slip_serial.
+* @author Adrien Oliva
+* @date 2026-10-17
+*/
+#include "comserial/slip.h"
+#include "comserial/exceptions.h"
+#include "logger.h"
+#include "scan.h"
+
+#include <cstring>
+
+using namespace com;
+
+const uint8_t slip_codec::END;
+const uint8_t slip_codec::ESC;
+const uint8_t slip_codec::ESC_END;
+const uint8_t slip_codec::ESC_ESC;
+
+/**
+* @brief Bytes needing escape or ending a frame.
+*/
+static const uint8_t SPECIAL[2] = { slip_codec::END, slip_codec::ESC };
+
+size_t slip_codec::encode(const uint8_t *data, size_t size, uint8_t *buffer)
+{
+    size_t length = 0;
+    buffer[length++] = END;
+
+    size_t i = 0;
+    while (i < size) {
+        size_t run = scan::find_any(data + i, size - i, SPECIAL, 2);
+        memcpy(buffer + length, data + i, run);
+        length += run;
+        i += run;
+        if (i < size) {
+            buffer[length++] = ESC;
+            buffer[length++] = data[i++] == END ? ESC_END : ESC_ESC;
+        }
+    }
+
+    buffer[length++] = END;
+    return length;
+}
+
+slip_codec::slip_codec()
+    : m_escape(false)
+    , m_discard(false)
+    , m_dropped(0)
+{
+}
+
+bool slip_codec::decode(const uint8_t *data, size_t size, frame &out,
+                        size_t &consumed)
+{
+    size_t i = 0;
+    while (i < size) {
+        if (m_escape) {
+            m_escape = false;
+            uint8_t byte = data[i];
+            if (byte == END) {
+                // Aborted frame: END is handled by next iteration
+                m_discard = true;
+                continue;
+            }
+            if (byte == ESC_END)
+                byte = END;
+            else if (byte == ESC_ESC)
+                byte = ESC;
+            if (out.size < out.capacity)
+                out.data[out.size++] = byte;
+            else
+                m_discard = true;
+            i++;
+            continue;
+        }
+
+        size_t run = scan::find_any(data + i, size - i, SPECIAL, 2);
+        if (!m_discard) {
+            if (run <= out.capacity - out.size) {
+                memcpy(out.data + out.size, data + i, run);
+                out.size += run;
+            } else {
+                m_discard = true;
+            }
+        }
+        i += run;
+        if (i == size)
+            break;
+
+        if (data[i++] == ESC) {
+            m_escape = true;
+            continue;
+        }
+
+        if (m_discard) {
+            DLOG() << "Drop SLIP frame";
+            m_discard = false;
+            m_dropped++;
+            out.size = 0;
+        } else if (out.size != 0) {
+            consumed = i;
+            return true;
+        }
+    }
+
+    consumed = size;
+    return false;
+}
+
+void slip_codec::reset()
+{
+    m_escape = false;
+    m_discard = false;
+}
+
+uint64_t slip_codec::dropped() const
+{
+    return m_dropped;
+}
+
+slip_serial::slip_serial(serial &device, size_t mtu, size_t frames)
+    : m_device(device)
+    , m_mtu(mtu)
+    , m_codec()
+    , m_pool(frames, mtu)
+    , m_current(NULL)
+    , m_output(slip_codec::max_encoded_size(mtu))
+{
+    ILOG() << "New SLIP device (" << frames << " frames of " << mtu
+           << " bytes)";
+}
+
+frame *slip_serial::read_frame()
+{
+    std::error_code ec;
+    frame *f = try_read_frame(ec);
+
+    if (ec == std::errc::timed_out)
+        throw exception::timeout(m_current != NULL ? m_current->size : 0);
+    else if (ec == std::errc::no_buffer_space)
+        throw exception::runtime_error("No free frame");
+    else if (ec)
+        throw exception::runtime_error("Fail to read");
+
+    return f;
+}
+
+frame *slip_serial::try_read_frame(std::error_code &ec)
+{
+    ec.clear();
+    if (m_current == NULL) {
+        m_current = m_pool.acquire();
+        if (m_current == NULL) {
+            WLOG() << "All SLIP frames are in use";
+            ec = std::make_error_code(std::errc::no_buffer_space);
+            return NULL;
+        }
+    }
+
+    for (;;) {
+        const uint8_t *data;
+        size_t size = m_device.peek(data, ec);
+        if (ec)
+            return NULL;
+
+        size_t used;
+        bool complete = m_codec.decode(data, size, *m_current, used);
+        m_device.consume(used);
+        if (complete) {
+            frame *f = m_current;
+            m_current = NULL;
+            return f;
+        }
+    }
+}
+
+void slip_serial::release(frame *f)
+{
+    m_pool.release(f);
+}
+
+size_t slip_serial::write_frame(const uint8_t *data, size_t size)
+{
+    if (data == NULL || size == 0 || size > m_mtu) {
+        ELOG() << "Invalid SLIP frame";
+        throw exception::invalid_input();
+    }
+
+    size_t length = slip_codec::encode(data, size, m_output.data());
+    m_device.write_buffer(m_output.data(), length);
+    return size;
+}
+
+uint64_t slip_serial::dropped() const
+{
+    return m_codec.dropped();
+}
+
+serial &slip_serial::device()
+{
+    return m_device;
+}
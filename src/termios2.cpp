@@ -0,0 +1,79 @@
+/**
+* @file termios2.cpp
+* @brief Arbitrary speed support through Linux termios2 and BOTHER.
+* @author Adrien Oliva
+* @date 2026-10-16
+*/
+#include "termios2.h"
+
+#include <cerrno>
+#include <cstring>
+
+#if HAVE_ASM_TERMBITS_H == 1
+#include <asm/termbits.h>
+#include <sys/ioctl.h>
+#endif
+
+#if HAVE_ASM_TERMBITS_H == 1 && defined(BOTHER) && defined(TCSETS2)
+
+bool com::termios2::supported()
+{
+    return true;
+}
+
+bool com::termios2::set_custom_speed(int fd, const settings &options,
+                                     unsigned int speed, int when)
+{
+    struct ::termios2 kernel;
+    memset(&kernel, 0, sizeof(kernel));
+
+    kernel.c_iflag = options.iflag;
+    kernel.c_oflag = options.oflag;
+    kernel.c_lflag = options.lflag;
+    kernel.c_line = options.line;
+    memcpy(kernel.c_cc, options.cc,
+           options.cc_count < NCCS ? options.cc_count : NCCS);
+
+    // Speed bits of libc are replaced, input speed bits are left to 0 so
+    // that input speed follows output speed.
+    kernel.c_cflag = options.cflag & (CSIZE | CSTOPB | CREAD | PARENB
+                                      | PARODD | HUPCL | CLOCAL | CRTSCTS
+#ifdef CMSPAR
+                                      | CMSPAR
+#endif
+                                      );
+    kernel.c_cflag |= BOTHER;
+    kernel.c_ospeed = speed;
+    kernel.c_ispeed = speed;
+
+    unsigned long request;
+    switch (when) {
+        case TCSANOW:
+            request = TCSETS2;
+            break;
+        case TCSADRAIN:
+            request = TCSETSW2;
+            break;
+        default:
+            request = TCSETSF2;
+            break;
+    }
+
+    return ioctl(fd, request, &kernel) == 0;
+}
+
+#else
+
+bool com::termios2::supported()
+{
+    return false;
+}
+
+bool com::termios2::set_custom_speed(int, const settings &, unsigned int,
+                                     int)
+{
+    errno = ENOTSUP;
+    return false;
+}
+
+#endif
@@ -0,0 +1,78 @@
+/**
+* @file termios2.h
+* @brief Internal access to Linux termios2 interface for arbitrary speeds.
+* @author Adrien Oliva
+* @date 2026-10-16
+*
+* Kernel termios2 structure and libc termios structure can not be declared
+* in the same translation unit, so arbitrary speed handling lives apart.
+*/
+#ifndef TERMIOS2_H_K4QW7ZPD
+#define TERMIOS2_H_K4QW7ZPD
+
+#include <cstddef>
+
+namespace com {
+
+    namespace termios2 {
+
+        /**
+        * @brief Check if arbitrary speeds are available on this system.
+        *
+        * @return true if set_custom_speed() may be used.
+        */
+        bool supported();
+
+        /**
+        * @brief Device settings, as stored in a libc termios structure.
+        */
+        struct settings {
+            /**
+            * @brief Input modes.
+            */
+            unsigned int iflag;
+            /**
+            * @brief Output modes.
+            */
+            unsigned int oflag;
+            /**
+            * @brief Control modes, speed bits are ignored.
+            */
+            unsigned int cflag;
+            /**
+            * @brief Local modes.
+            */
+            unsigned int lflag;
+            /**
+            * @brief Line discipline.
+            */
+            unsigned char line;
+            /**
+            * @brief Control characters.
+            */
+            const unsigned char *cc;
+            /**
+            * @brief Number of control characters.
+            */
+            size_t cc_count;
+        };
+
+        /**
+        * @brief Commit settings with an arbitrary speed in a single call.
+        *
+        * @param fd File descriptor of device.
+        * @param options Settings of device.
+        * @param speed Input and output speed in bps.
+        * @param when Optional actions of tcsetattr() (TCSANOW, TCSADRAIN or
+        *        TCSAFLUSH).
+        *
+        * @return false on error, errno is then set.
+        */
+        bool set_custom_speed(int fd, const settings &options,
+                              unsigned int speed, int when);
+
+    };
+
+};
+
+#endif /* end of include guard: TERMIOS2_H_K4QW7ZPD */
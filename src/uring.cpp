@@ -0,0 +1,361 @@
+/**
+* @file uring.cpp
+* @brief Implementation of com::uring.
+* @author Adrien Oliva
+* @date 2026-10-16
+*/
+#include "comserial/uring.h"
+#include "logger.h"
+
+#include <cerrno>
+#include <set>
+#include <poll.h>
+#include <liburing.h>
+
+using namespace com;
+
+/**
+* @brief Internal state of a read or write request.
+*/
+struct uring::request {
+    /**
+    * @brief Port on which request is done.
+    */
+    port *owner;
+    /**
+    * @brief Kind of request.
+    */
+    operation op;
+    /**
+    * @brief Data buffer of request.
+    */
+    uint8_t *buffer;
+    /**
+    * @brief Total size of request.
+    */
+    size_t length;
+    /**
+    * @brief Amount of data already transferred.
+    */
+    size_t done;
+    /**
+    * @brief User data reported in completion.
+    */
+    void *user_data;
+};
+
+/**
+* @brief Internal state of an attached device.
+*/
+struct uring::port {
+    /**
+    * @brief Attached device.
+    */
+    serial *device;
+    /**
+    * @brief File descriptor of device.
+    */
+    int fd;
+    /**
+    * @brief Read buffers, used alternatively so that reported data remain
+    *        valid while next read is in flight.
+    */
+    std::vector<uint8_t> buffers[2];
+    /**
+    * @brief Index of buffer used by in flight read.
+    */
+    unsigned int current;
+    /**
+    * @brief Read request of port.
+    */
+    request read_req;
+    /**
+    * @brief Pending write requests of port.
+    */
+    std::set<request *> writes;
+    /**
+    * @brief Number of requests sent and not completed yet.
+    */
+    size_t inflight;
+    /**
+    * @brief Set once port is detached.
+    */
+    bool detached;
+};
+
+uring::uring(unsigned int entries, size_t read_size)
+    : m_ring(NULL)
+    , m_read_size(read_size)
+    , m_ports()
+{
+    if (entries == 0 || read_size == 0) {
+        ELOG() << "Invalid io_uring engine size";
+        throw exception::invalid_input();
+    }
+
+    m_ring = new struct io_uring;
+    int ret = io_uring_queue_init(entries, m_ring, 0);
+    if (ret < 0) {
+        delete m_ring;
+        CLOG() << "Internal system function returns error (io_uring_setup): "
+               << -ret;
+        throw exception::runtime_error("Fail to create io_uring instance");
+    }
+
+    ILOG() << "New io_uring engine (" << entries << " entries)";
+}
+
+uring::~uring()
+{
+    ILOG() << "Destroy io_uring engine";
+
+    // Kernel cancels and waits for all in flight requests.
+    io_uring_queue_exit(m_ring);
+    delete m_ring;
+
+    for (auto &it: m_ports) {
+        for (auto &w: it.second->writes)
+            delete w;
+        delete it.second;
+    }
+}
+
+void uring::attach(serial &device)
+{
+    int fd = device.get_fd();
+
+    if (m_ports.find(fd) != m_ports.end()) {
+        ELOG() << "Device " << fd << " already attached";
+        throw exception::invalid_input();
+    }
+
+    port *p = new port;
+    p->device = &device;
+    p->fd = fd;
+    p->buffers[0].resize(m_read_size);
+    p->buffers[1].resize(m_read_size);
+    p->current = 0;
+    p->read_req.owner = p;
+    p->read_req.op = received;
+    p->read_req.buffer = p->buffers[0].data();
+    p->read_req.length = m_read_size;
+    p->read_req.done = 0;
+    p->read_req.user_data = NULL;
+    p->inflight = 0;
+    p->detached = false;
+
+    m_ports[fd] = p;
+    queue(&p->read_req);
+
+    DLOG() << "Attach device " << fd;
+}
+
+bool uring::detach(serial &device)
+{
+    auto it = m_ports.find(device.get_fd());
+    if (it == m_ports.end())
+        return false;
+
+    port *p = it->second;
+    m_ports.erase(it);
+    p->detached = true;
+
+    if (p->inflight != 0) {
+        // Cancel every request of device, port is released once all of
+        // them have completed.
+        struct io_uring_sqe *sqe = get_sqe();
+        io_uring_prep_cancel_fd(sqe, p->fd, IORING_ASYNC_CANCEL_ALL);
+        io_uring_sqe_set_data(sqe, NULL);
+    }
+    release_if_idle(p);
+
+    DLOG() << "Detach device " << device.get_fd();
+    return true;
+}
+
+void uring::write(serial &device, const uint8_t *buffer, size_t length,
+                  void *user_data)
+{
+    auto it = m_ports.find(device.get_fd());
+    if (buffer == NULL || length == 0 || it == m_ports.end()) {
+        ELOG() << "Invalid buffer to write";
+        throw exception::invalid_input();
+    }
+
+    request *req = new request;
+    req->owner = it->second;
+    req->op = sent;
+    req->buffer = const_cast<uint8_t *>(buffer);
+    req->length = length;
+    req->done = 0;
+    req->user_data = user_data;
+
+    it->second->writes.insert(req);
+    queue(req);
+}
+
+size_t uring::submit()
+{
+    int ret = io_uring_submit(m_ring);
+    if (ret < 0) {
+        CLOG() << "Internal system function returns error (io_uring_enter): "
+               << -ret;
+        throw exception::runtime_error("Fail to submit requests");
+    }
+
+    return ret;
+}
+
+size_t uring::wait(std::vector<completion> &completions,
+                   unsigned int min_completions, int timeout)
+{
+    int ret;
+
+    completions.clear();
+
+    if (timeout < 0) {
+        ret = io_uring_submit_and_wait(m_ring, min_completions);
+    } else {
+        struct io_uring_cqe *cqe = NULL;
+        struct __kernel_timespec ts;
+        ts.tv_sec = timeout / 1000;
+        ts.tv_nsec = (timeout % 1000) * 1000000L;
+        ret = io_uring_submit_and_wait_timeout(m_ring, &cqe, min_completions,
+                                               &ts, NULL);
+    }
+
+    if (ret < 0 && ret != -ETIME && ret != -EINTR) {
+        CLOG() << "Internal system function returns error (io_uring_enter): "
+               << -ret;
+        throw exception::runtime_error("Fail to wait for completions");
+    }
+
+    // Only harvest completions available right now: a read queued again
+    // below must not complete into a buffer reported in this batch.
+    unsigned int ready = io_uring_cq_ready(m_ring);
+    while (ready > 0) {
+        struct io_uring_cqe *cqes[64];
+        unsigned int count = io_uring_peek_batch_cqe(m_ring, cqes,
+                                                     ready < 64 ? ready : 64);
+        if (count == 0)
+            break;
+
+        for (unsigned int i = 0; i < count; i++) {
+            request *req = static_cast<request *>(io_uring_cqe_get_data(cqes[i]));
+            int res = cqes[i]->res;
+            if (req != NULL)
+                complete(req, res, completions);
+        }
+
+        io_uring_cq_advance(m_ring, count);
+        ready -= count;
+    }
+
+    return completions.size();
+}
+
+struct io_uring_sqe *uring::get_sqe()
+{
+    struct io_uring_sqe *sqe = io_uring_get_sqe(m_ring);
+    if (sqe == NULL) {
+        submit();
+        sqe = io_uring_get_sqe(m_ring);
+        if (sqe == NULL) {
+            CLOG() << "Submission queue still full";
+            throw exception::runtime_error("Fail to get submission entry");
+        }
+    }
+
+    return sqe;
+}
+
+void uring::queue(request *req)
+{
+    port *p = req->owner;
+
+    // Poll and I/O requests are linked and must be submitted together.
+    if (io_uring_sq_space_left(m_ring) < 2)
+        submit();
+
+    struct io_uring_sqe *sqe = get_sqe();
+    io_uring_prep_poll_add(sqe, p->fd, req->op == received ? POLLIN : POLLOUT);
+    io_uring_sqe_set_data(sqe, NULL);
+    io_uring_sqe_set_flags(sqe, IOSQE_IO_LINK | IOSQE_CQE_SKIP_SUCCESS);
+
+    sqe = get_sqe();
+    if (req->op == received)
+        io_uring_prep_read(sqe, p->fd, req->buffer,
+                           static_cast<unsigned int>(req->length), -1);
+    else
+        io_uring_prep_write(sqe, p->fd, req->buffer + req->done,
+                            static_cast<unsigned int>(req->length - req->done),
+                            -1);
+    io_uring_sqe_set_data(sqe, req);
+
+    p->inflight++;
+}
+
+void uring::complete(request *req, int res,
+                     std::vector<completion> &completions)
+{
+    port *p = req->owner;
+    p->inflight--;
+
+    if (p->detached) {
+        if (req->op == sent) {
+            p->writes.erase(req);
+            delete req;
+        }
+        release_if_idle(p);
+        return;
+    }
+
+    // Poll was interrupted or device was not ready yet: simply try again.
+    if (res == -ECANCELED || res == -EAGAIN || res == -EINTR) {
+        queue(req);
+        return;
+    }
+
+    if (req->op == received) {
+        completion c = { p->device, received, req->buffer, res, NULL };
+        completions.push_back(c);
+
+        if (res > 0) {
+            DLOG() << "Read completion:" << logger::dump(req->buffer, res);
+            p->current ^= 1;
+            req->buffer = p->buffers[p->current].data();
+            queue(req);
+        } else {
+            WLOG() << "Stop reading device " << p->fd << " (" << -res << ")";
+        }
+    } else {
+        if (res > 0) {
+            req->done += res;
+            if (req->done < req->length) {
+                queue(req);
+                return;
+            }
+            DLOG() << "Write completion:"
+                   << logger::dump(req->buffer, req->length);
+        } else {
+            ALOG() << "Fail to write buffer (" << -res << ")";
+        }
+
+        completion c = { p->device, sent, req->buffer,
+                         res > 0 ? static_cast<ssize_t>(req->done) : res,
+                         req->user_data };
+        completions.push_back(c);
+
+        p->writes.erase(req);
+        delete req;
+    }
+}
+
+void uring::release_if_idle(port *p)
+{
+    if (p->detached && p->inflight == 0) {
+        for (auto &w: p->writes)
+            delete w;
+        delete p;
+    }
+}
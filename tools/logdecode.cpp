@@ -0,0 +1,303 @@
+/**
+* @file logdecode.cpp
+* @brief Render a binary log written with `CSER_LOGFORMAT=binary` as text.
+* @author Adrien Oliva
+* @date 2026-10-17
+*
+* Usage: comserial-logdecode [-t] [file]
+*
+* Log is read from file, or from standard input when no file is given, and
+* printed on standard output exactly as text logger would have, each line
+* prefixed with its time stamp when `-t` is given.
+*
+* Log must start with a header of a supported format version. Call site ids
+* are only known by the process that wrote them, so a log file appended by
+* several processes at once can not be decoded (see binlog.h).
+*/
+#include "binlog.h"
+#include "logger.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+* @brief Call site read from log.
+*/
+struct site {
+    /**
+    * @brief File name.
+    */
+    std::string file;
+    /**
+    * @brief Line number.
+    */
+    uint64_t line;
+    /**
+    * @brief Function name.
+    */
+    std::string function;
+};
+
+/**
+* @brief Print usage of tool.
+*
+* @param name Program name.
+*/
+static void usage(const char *name)
+{
+    std::cerr << "Usage: " << name << " [-t] [file]" << std::endl;
+}
+
+/**
+* @brief Read a length prefixed string.
+*
+* @param data Start of length.
+* @param end End of record.
+* @param out Output string.
+*
+* @return Pointer after string, or NULL when record is truncated.
+*/
+static const uint8_t *read_string(const uint8_t *data, const uint8_t *end,
+                                  std::string &out)
+{
+    if (end - data < 2)
+        return NULL;
+    size_t length = binlog::get(data, 2);
+    data += 2;
+    if (static_cast<size_t>(end - data) < length)
+        return NULL;
+    out.assign(reinterpret_cast<const char *>(data), length);
+    return data + length;
+}
+
+/**
+* @brief Decode a call site record.
+*
+* @param r Record to decode.
+* @param sites Known call sites, updated with decoded one.
+*
+* @return false when record is malformed.
+*/
+static bool decode_site(const binlog::record &r, std::map<uint32_t, site> &sites)
+{
+    const uint8_t *end = r.body + r.length;
+    if (r.length < 8)
+        return false;
+
+    site s;
+    uint32_t id = static_cast<uint32_t>(binlog::get(r.body, 4));
+    s.line = binlog::get(r.body + 4, 4);
+    const uint8_t *p = read_string(r.body + 8, end, s.file);
+    if (p == NULL || read_string(p, end, s.function) == NULL)
+        return false;
+
+    sites[id] = s;
+    return true;
+}
+
+/**
+* @brief Render a message record.
+*
+* @param r Record to decode.
+* @param sites Known call sites.
+* @param timestamps Prefix line with time stamp.
+* @param out Output stream.
+*
+* @return false when record is malformed.
+*/
+static bool decode_message(const binlog::record &r,
+                           const std::map<uint32_t, site> &sites,
+                           bool timestamps, std::ostream &out)
+{
+    const uint8_t *p = r.body;
+    const uint8_t *end = r.body + r.length;
+    if (r.length < 13)
+        return false;
+
+    uint64_t timestamp = binlog::get(p, 8);
+    uint32_t id = static_cast<uint32_t>(binlog::get(p + 8, 4));
+    auto level = static_cast<enum logger::log_level>(p[12]);
+    p += 13;
+
+    std::ostringstream line;
+    if (timestamps) {
+        char ns[16];
+        snprintf(ns, sizeof(ns), "%09u",
+                 static_cast<unsigned int>(timestamp % 1000000000ULL));
+        line << timestamp / 1000000000ULL << "." << ns << " ";
+    }
+
+    line << "[" << logger::InternalLog::char_from_level(level) << "] ";
+    // Site 0 is used by logger for its own messages.
+    if (id != 0) {
+        auto it = sites.find(id);
+        if (it == sites.end())
+            line << "?:0(?) ";
+        else
+            line << it->second.file << ":" << it->second.line << "("
+                 << it->second.function << ") ";
+    }
+
+    while (p != end) {
+        if (end - p < 5)
+            return false;
+        uint8_t type = p[0];
+        size_t length = binlog::get(p + 1, 4);
+        p += 5;
+
+        if (type == binlog::TEXT) {
+            if (static_cast<size_t>(end - p) < length)
+                return false;
+            line.write(reinterpret_cast<const char *>(p), length);
+            p += length;
+        } else if (type == binlog::BINARY) {
+            if (static_cast<size_t>(end - p) < length + 8)
+                return false;
+            uintptr_t address = binlog::get(p, 8);
+            line << logger::dump(p + 8, length,
+                                 reinterpret_cast<const void *>(address));
+            p += length + 8;
+        } else {
+            return false;
+        }
+    }
+
+    out << line.str() << "\n";
+    return true;
+}
+
+/**
+* @brief Check a header record.
+*
+* @param r Record to check.
+* @param error Output description of problem, if any.
+*
+* @return false when record is not a header of a supported version.
+*/
+static bool check_header(const binlog::record &r, std::string &error)
+{
+    // Last byte of magic is format version.
+    const size_t size = sizeof(binlog::MAGIC) - 1;
+    if (r.type != binlog::HEADER || r.length != size
+            || memcmp(r.body, binlog::MAGIC, size - 1) != 0) {
+        error = "not a binary log";
+        return false;
+    }
+    if (r.body[size - 1] != static_cast<uint8_t>(binlog::MAGIC[size - 1])) {
+        error = "unsupported log version "
+              + std::to_string(static_cast<unsigned int>(r.body[size - 1]));
+        return false;
+    }
+    return true;
+}
+
+/**
+* @brief Render one session of log, from a header to the next one.
+*
+* @param data Start of session.
+* @param size Size of session.
+* @param timestamps Prefix line with time stamp.
+* @param out Output stream.
+*
+* @return false when session holds malformed records.
+*
+* Messages logged concurrently may be written before their call site, so
+* call sites of a session are all collected before rendering any message.
+*/
+static bool decode_session(const uint8_t *data, size_t size, bool timestamps,
+                           std::ostream &out)
+{
+    std::map<uint32_t, site> sites;
+    binlog::record r;
+    bool valid = true;
+
+    binlog::reader collect(data, size);
+    while (collect.next(r))
+        if (r.type == binlog::SITE && !decode_site(r, sites))
+            valid = false;
+
+    binlog::reader render(data, size);
+    while (render.next(r))
+        if (r.type == binlog::MESSAGE && !decode_message(r, sites, timestamps,
+                                                         out))
+            valid = false;
+
+    return valid && render.offset() == size;
+}
+
+int main(int argc, char *argv[])
+{
+    bool timestamps = false;
+    const char *filename = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        if (arg == "-t") {
+            timestamps = true;
+        } else if (arg == "-h" || arg == "--help") {
+            usage(argv[0]);
+            return 0;
+        } else if (filename == NULL && arg[0] != '-') {
+            filename = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    std::stringstream ss;
+    if (filename != NULL) {
+        std::ifstream input(filename, std::ios::binary);
+        if (!input) {
+            std::cerr << argv[0] << ": can not open " << filename << std::endl;
+            return 1;
+        }
+        ss << input.rdbuf();
+    } else {
+        ss << std::cin.rdbuf();
+    }
+    std::string content = ss.str();
+
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(content.data());
+    binlog::reader reader(data, content.size());
+    binlog::record r;
+    std::string error;
+
+    // Call site ids are only valid inside a session: find sessions, and
+    // check their headers before rendering anything.
+    std::vector<size_t> sessions;
+    while (reader.next(r)) {
+        size_t offset = reader.offset() - binlog::RECORD_HEADER_SIZE - r.length;
+        if (r.type != binlog::HEADER && offset != 0)
+            continue;
+        if (!check_header(r, error)) {
+            std::cerr << argv[0] << ": " << error << std::endl;
+            return 1;
+        }
+        sessions.push_back(offset);
+    }
+    if (sessions.empty() && !content.empty()) {
+        // First record is not even readable.
+        std::cerr << argv[0] << ": not a binary log" << std::endl;
+        return 1;
+    }
+    sessions.push_back(content.size());
+
+    bool valid = true;
+    for (size_t i = 0; i + 1 < sessions.size(); i++)
+        if (!decode_session(data + sessions[i], sessions[i + 1] - sessions[i],
+                            timestamps, std::cout))
+            valid = false;
+
+    if (!valid) {
+        std::cerr << argv[0] << ": malformed or truncated log" << std::endl;
+        return 1;
+    }
+    return 0;
+}
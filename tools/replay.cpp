@@ -0,0 +1,142 @@
+/**
+* @file replay.cpp
+* @brief Replay traffic received by a captured device on a pseudo terminal.
+* @author Adrien Oliva
+* @date 2026-10-17
+*
+* Usage: comserial-replay [-p port] [-s scale] [-l link] [-w delay] file...
+*
+* Data received by device port (first device of capture by default) in
+* capture files, oldest first, are fed to a new pseudo terminal whose path
+* is printed on standard output, and linked from link when given. Replay
+* starts after delay ms (0 by default), at recorded pace divided by scale
+* (1 by default, 0 for as fast as possible), and a summary is printed on
+* standard error once device user read everything.
+*/
+#include <comserial/replayer.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+/**
+* @brief Longest wait of device user in ms once replay is done.
+*/
+static const unsigned int DRAIN_TIMEOUT = 10000;
+
+/**
+* @brief Replayer stopped on interruption.
+*/
+static com::replayer *replaying = NULL;
+
+/**
+* @brief Stop replay on SIGINT or SIGTERM.
+*
+* @param signum Signal number.
+*/
+static void interrupt(int signum)
+{
+    (void) signum;
+    if (replaying != NULL)
+        replaying->stop();
+}
+
+/**
+* @brief Print usage of tool.
+*
+* @param name Program name.
+*/
+static void usage(const char *name)
+{
+    std::cerr << "Usage: " << name
+              << " [-p port] [-s scale] [-l link] [-w delay_ms] file..."
+              << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string port;
+    std::string link;
+    double scale = 1.0;
+    long delay = 0;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        if (arg == "-h" || arg == "--help") {
+            usage(argv[0]);
+            return 0;
+        } else if (arg == "-p" && i + 1 < argc) {
+            port = argv[++i];
+        } else if (arg == "-l" && i + 1 < argc) {
+            link = argv[++i];
+        } else if ((arg == "-s" || arg == "-w") && i + 1 < argc) {
+            char *end;
+            const char *value = argv[++i];
+            if (arg == "-s")
+                scale = strtod(value, &end);
+            else
+                delay = strtol(value, &end, 10);
+            if (*end != '\0' || scale < 0.0 || delay < 0) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (arg[0] != '-') {
+            files.push_back(arg);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (files.empty()) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    try {
+        com::replayer r(files, port);
+
+        if (!link.empty()) {
+            unlink(link.c_str());
+            if (symlink(r.device_path().c_str(), link.c_str()) < 0) {
+                std::cerr << argv[0] << ": can not create " << link
+                          << std::endl;
+                return 1;
+            }
+        }
+        std::cout << r.device_path() << std::endl;
+
+        replaying = &r;
+        signal(SIGINT, interrupt);
+        signal(SIGTERM, interrupt);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+        com::replay_stats stats = r.run(scale);
+        bool drained = r.wait_drained(DRAIN_TIMEOUT);
+
+        replaying = NULL;
+        if (!link.empty())
+            unlink(link.c_str());
+
+        double seconds = stats.elapsed / 1e9;
+        fprintf(stderr, "%llu/%zu records, %llu bytes in %.3f s (%.3f MB/s), "
+                "max lag %.1f us, %llu bytes discarded%s\n",
+                static_cast<unsigned long long>(stats.records), r.records(),
+                static_cast<unsigned long long>(stats.bytes), seconds,
+                seconds > 0.0 ? stats.bytes / seconds / 1e6 : 0.0,
+                stats.max_lag / 1e3,
+                static_cast<unsigned long long>(stats.discarded),
+                drained ? "" : ", not all data read");
+        return stats.records == r.records() && drained ? 0 : 1;
+    } catch (std::exception &e) {
+        std::cerr << argv[0] << ": " << e.what() << std::endl;
+        return 1;
+    }
+}
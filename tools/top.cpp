@@ -0,0 +1,271 @@
+/**
+* @file top.cpp
+* @brief Show I/O rates of serial devices exported with `CSER_SHMSTATS`.
+* @author Adrien Oliva
+* @date 2026-10-17
+*
+* Usage: comserial-top [-d delay] [-n count]
+*
+* Every delay ms (1000 by default), statistics segments found in /dev/shm
+* are read and rates since previous refresh are printed for each device, up
+* to count refreshes (forever by default). Segments are only mapped: neither
+* this tool nor monitored processes do any system call to share statistics.
+*/
+#include "shmstats.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace com;
+
+/**
+* @brief Directory of POSIX shared memory segments.
+*/
+static const char SHM_DIR[] = "/dev/shm/";
+
+/**
+* @brief Monitored device.
+*/
+struct port {
+    /**
+    * @brief Mapped segment.
+    */
+    const shmstats::segment *seg;
+    /**
+    * @brief Previous sample.
+    */
+    serial_stats last;
+    /**
+    * @brief Time of previous sample, 0 before first one.
+    */
+    uint64_t timestamp;
+    /**
+    * @brief Segment is still present in last scan.
+    */
+    bool seen;
+};
+
+/**
+* @brief Print usage of tool.
+*
+* @param name Program name.
+*/
+static void usage(const char *name)
+{
+    std::cerr << "Usage: " << name << " [-d delay_ms] [-n count]" << std::endl;
+}
+
+/**
+* @brief Map a statistics segment.
+*
+* @param path Path of segment.
+*
+* @return Mapped segment, or NULL when file is not a segment.
+*/
+static const shmstats::segment *map_segment(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    struct stat st;
+    void *addr = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size == sizeof(shmstats::segment))
+        addr = mmap(NULL, sizeof(shmstats::segment), PROT_READ, MAP_SHARED,
+                    fd, 0);
+    close(fd);
+
+    if (addr == MAP_FAILED)
+        return NULL;
+    return static_cast<const shmstats::segment *>(addr);
+}
+
+/**
+* @brief Update monitored devices with segments currently in /dev/shm.
+*
+* @param ports Monitored devices, by segment name.
+*/
+static void scan(std::map<std::string, port> &ports)
+{
+    for (auto &it: ports)
+        it.second.seen = false;
+
+    DIR *dir = opendir(SHM_DIR);
+    if (dir != NULL) {
+        const size_t prefix = sizeof(shmstats::PREFIX) - 1;
+        while (struct dirent *entry = readdir(dir)) {
+            std::string name(entry->d_name);
+            if (name.compare(0, prefix, shmstats::PREFIX) != 0)
+                continue;
+
+            auto it = ports.find(name);
+            if (it == ports.end()) {
+                const shmstats::segment *seg = map_segment(SHM_DIR + name);
+                if (seg == NULL)
+                    continue;
+                port p = { seg, serial_stats(), 0, false };
+                it = ports.insert(std::make_pair(name, p)).first;
+            }
+            it->second.seen = true;
+        }
+        closedir(dir);
+    }
+
+    for (auto it = ports.begin(); it != ports.end();) {
+        if (it->second.seen) {
+            ++it;
+        } else {
+            munmap(const_cast<shmstats::segment *>(it->second.seg),
+                   sizeof(shmstats::segment));
+            it = ports.erase(it);
+        }
+    }
+}
+
+/**
+* @brief Get 99th percentile of calls done between two samples.
+*
+* @param now Current sample.
+* @param last Previous sample.
+*
+* @return Upper bound of percentile in us, 0 when there is no call.
+*/
+static uint64_t p99(const io_stats &now, const io_stats &last)
+{
+    uint64_t delta[io_stats::LATENCY_BUCKETS];
+    uint64_t total = 0;
+    for (size_t i = 0; i < io_stats::LATENCY_BUCKETS; i++) {
+        delta[i] = now.latency[i] - last.latency[i];
+        total += delta[i];
+    }
+    if (total == 0)
+        return 0;
+
+    uint64_t count = 0;
+    for (size_t i = 0; i < io_stats::LATENCY_BUCKETS; i++) {
+        count += delta[i];
+        if (count * 100 >= total * 99)
+            return 1ULL << i;
+    }
+    return 1ULL << (io_stats::LATENCY_BUCKETS - 1);
+}
+
+/**
+* @brief Print one line per monitored device.
+*
+* @param ports Monitored devices.
+*/
+static void refresh(std::map<std::string, port> &ports)
+{
+    printf("%7s %-24s %12s %12s %10s %10s %9s %7s %10s %10s\n",
+           "PID", "DEVICE", "RX B/s", "TX B/s", "RX call/s", "TX call/s",
+           "timeouts", "errors", "RX p99 us", "TX p99 us");
+
+    for (auto &it: ports) {
+        port &p = it.second;
+        serial_stats now;
+        uint64_t timestamp;
+
+        // Ignore torn segments and segments left by a crashed process.
+        if (!shmstats::load(*p.seg, now, timestamp)
+                || (kill(static_cast<pid_t>(p.seg->pid), 0) < 0
+                    && errno == ESRCH))
+            continue;
+
+        std::string device(p.seg->device,
+                           strnlen(p.seg->device, sizeof(p.seg->device)));
+        printf("%7u %-24s ", p.seg->pid, device.c_str());
+
+        if (p.timestamp == 0 || timestamp <= p.timestamp) {
+            // No rate yet: wait for publisher next refresh.
+            printf("%12s %12s %10s %10s %9s %7s %10s %10s\n",
+                   "-", "-", "-", "-", "-", "-", "-", "-");
+        } else {
+            double seconds = (timestamp - p.timestamp) / 1e9;
+            const io_stats &rx = now.read, &tx = now.write;
+            const io_stats &lrx = p.last.read, &ltx = p.last.write;
+            printf("%12.0f %12.0f %10.0f %10.0f %9llu %7llu %10llu %10llu\n",
+                   (rx.bytes - lrx.bytes) / seconds,
+                   (tx.bytes - ltx.bytes) / seconds,
+                   (rx.calls - lrx.calls) / seconds,
+                   (tx.calls - ltx.calls) / seconds,
+                   static_cast<unsigned long long>(rx.timeouts + tx.timeouts),
+                   static_cast<unsigned long long>(rx.errors + tx.errors),
+                   static_cast<unsigned long long>(p99(rx, lrx)),
+                   static_cast<unsigned long long>(p99(tx, ltx)));
+        }
+
+        if (timestamp > p.timestamp) {
+            p.last = now;
+            p.timestamp = timestamp;
+        }
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    long delay = 1000;
+    long count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        if (arg == "-h" || arg == "--help") {
+            usage(argv[0]);
+            return 0;
+        } else if ((arg == "-d" || arg == "-n") && i + 1 < argc) {
+            char *end;
+            long value = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || value < 0 || (arg == "-d" && value == 0)) {
+                usage(argv[0]);
+                return 2;
+            }
+            if (arg == "-d")
+                delay = value;
+            else
+                count = value;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    bool terminal = isatty(STDOUT_FILENO);
+    std::map<std::string, port> ports;
+
+    // First samples only give a base for rates.
+    scan(ports);
+    for (auto &it: ports) {
+        serial_stats stats;
+        uint64_t timestamp;
+        if (shmstats::load(*it.second.seg, stats, timestamp)) {
+            it.second.last = stats;
+            it.second.timestamp = timestamp;
+        }
+    }
+
+    for (long i = 0; count == 0 || i < count; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+        scan(ports);
+        if (terminal)
+            printf("\033[H\033[2J");
+        else if (i != 0)
+            printf("\n");
+        refresh(ports);
+    }
+
+    return 0;
+}
@@ -46,7 +46,7 @@ TEST(cinterface_module, close_non_existing)
     comserial_destroy_device(NULL);
 }
 
-SOCAT_TEST(cinterface_module, open_existing)
+TEST(cinterface_module, open_existing)
 {
     comserial_t s;
 
@@ -137,92 +137,135 @@ TEST_GROUP(cinterface_valid_module)
     };
 };
 
-SOCAT_TEST(cinterface_valid_module, check_default_speed)
+TEST(cinterface_valid_module, check_default_speed)
 {
     UNSIGNED_LONGS_EQUAL(19200, comserial_get_speed(m_comserial));
 }
 
-SOCAT_TEST(cinterface_valid_module, set_valid_speed)
+TEST(cinterface_valid_module, set_valid_speed)
 {
     unsigned int old_speed = comserial_set_speed(m_comserial, 115200);
     UNSIGNED_LONGS_EQUAL(19200, old_speed);
     UNSIGNED_LONGS_EQUAL(115200, comserial_get_speed(m_comserial));
 }
 
-SOCAT_TEST(cinterface_valid_module, set_invalid_speed)
+TEST(cinterface_valid_module, set_invalid_speed)
 {
-    UNSIGNED_LONGS_EQUAL(0, comserial_set_speed(m_comserial, 1234));
+    UNSIGNED_LONGS_EQUAL(0, comserial_set_speed(m_comserial, 0));
 }
 
-SOCAT_TEST(cinterface_valid_module, check_default_data_size)
+TEST(cinterface_valid_module, set_arbitrary_speed)
 {
+    UNSIGNED_LONGS_EQUAL(19200, comserial_set_speed(m_comserial, 250000));
+    UNSIGNED_LONGS_EQUAL(250000, comserial_get_speed(m_comserial));
+}
+
+TEST(cinterface_valid_module, set_flow_control)
+{
+    LONGS_EQUAL(COMSER_FLOW_NONE, comserial_get_flow_control(m_comserial));
+    LONGS_EQUAL(COMSER_FLOW_NONE,
+                comserial_set_flow_control(m_comserial, COMSER_FLOW_SOFTWARE));
+    LONGS_EQUAL(COMSER_FLOW_SOFTWARE,
+                comserial_set_flow_control(m_comserial, COMSER_FLOW_HARDWARE));
+    LONGS_EQUAL(-1, comserial_set_flow_control(m_comserial, 42));
+    LONGS_EQUAL(-1, comserial_get_flow_control(NULL));
+    LONGS_EQUAL(COMSER_FLOW_HARDWARE, comserial_get_flow_control(m_comserial));
+}
+
+TEST(cinterface_valid_module, apply_config)
+{
+    comserial_config_t config = { 115200, 8, 2, 'O', COMSER_FLOW_SOFTWARE };
+
+    LONGS_EQUAL(0, comserial_apply_config(m_comserial, &config,
+                                          COMSER_APPLY_DRAIN));
+    LONGS_EQUAL(0, comserial_get_config(m_comserial, &config));
+    UNSIGNED_LONGS_EQUAL(115200, config.speed);
+    UNSIGNED_LONGS_EQUAL(2, config.stop_size);
+    BYTES_EQUAL('o', config.parity);
+    LONGS_EQUAL(COMSER_FLOW_SOFTWARE, config.flow_control);
+    LONGS_EQUAL(COMSER_FLOW_SOFTWARE, comserial_get_flow_control(m_comserial));
+
+    config.flow_control = 42;
+    LONGS_EQUAL(-1, comserial_apply_config(m_comserial, &config,
+                                           COMSER_APPLY_NOW));
+    config.flow_control = COMSER_FLOW_NONE;
+    config.data_size = 4;
+    LONGS_EQUAL(-1, comserial_apply_config(m_comserial, &config,
+                                           COMSER_APPLY_NOW));
+    LONGS_EQUAL(-1, comserial_apply_config(m_comserial, NULL,
+                                           COMSER_APPLY_NOW));
     UNSIGNED_LONGS_EQUAL(8, comserial_get_data_size(m_comserial));
 }
 
-SOCAT_TEST(cinterface_valid_module, set_valid_data_size)
+TEST(cinterface_valid_module, check_default_data_size)
+{
+    UNSIGNED_LONGS_EQUAL(8, comserial_get_data_size(m_comserial));
+}
+
+TEST(cinterface_valid_module, set_valid_data_size)
 {
     unsigned int old_data_size = comserial_set_data_size(m_comserial, 7);
     UNSIGNED_LONGS_EQUAL(8, old_data_size);
     UNSIGNED_LONGS_EQUAL(7, comserial_get_data_size(m_comserial));
 }
 
-SOCAT_TEST(cinterface_valid_module, set_invalid_data_size)
+TEST(cinterface_valid_module, set_invalid_data_size)
 {
     UNSIGNED_LONGS_EQUAL(0, comserial_set_data_size(m_comserial, 1234));
 }
 
-SOCAT_TEST(cinterface_valid_module, check_default_stop_size)
+TEST(cinterface_valid_module, check_default_stop_size)
 {
     UNSIGNED_LONGS_EQUAL(1, comserial_get_stop_size(m_comserial));
 }
 
-SOCAT_TEST(cinterface_valid_module, set_valid_stop_size)
+TEST(cinterface_valid_module, set_valid_stop_size)
 {
     unsigned int old_stop_size = comserial_set_stop_size(m_comserial, 2);
     UNSIGNED_LONGS_EQUAL(1, old_stop_size);
     UNSIGNED_LONGS_EQUAL(2, comserial_get_stop_size(m_comserial));
 }
 
-SOCAT_TEST(cinterface_valid_module, set_invalid_stop_size)
+TEST(cinterface_valid_module, set_invalid_stop_size)
 {
     UNSIGNED_LONGS_EQUAL(0, comserial_set_stop_size(m_comserial, 1234));
 }
 
-SOCAT_TEST(cinterface_valid_module, check_default_parity)
+TEST(cinterface_valid_module, check_default_parity)
 {
     UNSIGNED_LONGS_EQUAL('n', comserial_get_parity(m_comserial));
 }
 
-SOCAT_TEST(cinterface_valid_module, set_valid_parity)
+TEST(cinterface_valid_module, set_valid_parity)
 {
     char old_parity = comserial_set_parity(m_comserial, 'E');
     UNSIGNED_LONGS_EQUAL('n', old_parity);
     UNSIGNED_LONGS_EQUAL('e', comserial_get_parity(m_comserial));
 }
 
-SOCAT_TEST(cinterface_valid_module, set_invalid_parity)
+TEST(cinterface_valid_module, set_invalid_parity)
 {
     UNSIGNED_LONGS_EQUAL(0, comserial_set_parity(m_comserial, 'P'));
 }
 
-SOCAT_TEST(cinterface_valid_module, check_default_read_timeout)
+TEST(cinterface_valid_module, check_default_read_timeout)
 {
     UNSIGNED_LONGS_EQUAL(1000, comserial_get_read_timeout(m_comserial));
 }
 
-SOCAT_TEST(cinterface_valid_module, set_valid_read_timeout)
+TEST(cinterface_valid_module, set_valid_read_timeout)
 {
     unsigned long old_read_timeout = comserial_set_read_timeout(m_comserial, 15);
     UNSIGNED_LONGS_EQUAL(1000, old_read_timeout);
     UNSIGNED_LONGS_EQUAL(15, comserial_get_read_timeout(m_comserial));
 }
 
-SOCAT_TEST(cinterface_valid_module, check_default_write_timeout)
+TEST(cinterface_valid_module, check_default_write_timeout)
 {
     UNSIGNED_LONGS_EQUAL(1000, comserial_get_write_timeout(m_comserial));
 }
 
-SOCAT_TEST(cinterface_valid_module, set_valid_write_timeout)
+TEST(cinterface_valid_module, set_valid_write_timeout)
 {
     unsigned long old_write_timeout = comserial_set_write_timeout(m_comserial, 15);
     UNSIGNED_LONGS_EQUAL(1000, old_write_timeout);
@@ -255,7 +298,7 @@ TEST_GROUP(cinterface_io)
     };
 };
 
-SOCAT_TEST(cinterface_io, write_buffer)
+TEST(cinterface_io, write_buffer)
 {
     uint8_t buffer[16];
     for (size_t index = 0; index < 16; index++)
@@ -264,7 +307,7 @@ SOCAT_TEST(cinterface_io, write_buffer)
     LONGS_EQUAL(16, comserial_write_buffer(in, buffer, 16));
 }
 
-SOCAT_TEST(cinterface_io, write_error)
+TEST(cinterface_io, write_error)
 {
     uint8_t buffer[16];
     LONGS_EQUAL(-COMSER_IOERROR, comserial_write_buffer(NULL, buffer, 16));
@@ -272,7 +315,7 @@ SOCAT_TEST(cinterface_io, write_error)
     LONGS_EQUAL(-COMSER_IOERROR, comserial_write_buffer(in, buffer, 0));
 }
 
-SOCAT_TEST(cinterface_io, read_buffer)
+TEST(cinterface_io, read_buffer)
 {
     uint8_t buffer[16];
     uint8_t read_buffer[18];
@@ -291,7 +334,7 @@ SOCAT_TEST(cinterface_io, read_buffer)
     MEMCMP_EQUAL(buffer, &read_buffer[1], 16);
 }
 
-SOCAT_TEST(cinterface_io, read_buffer_small)
+TEST(cinterface_io, read_buffer_small)
 {
     uint8_t buffer[8];
     uint8_t read_buffer[10];
@@ -310,7 +353,7 @@ SOCAT_TEST(cinterface_io, read_buffer_small)
     MEMCMP_EQUAL(buffer, &read_buffer[1], 8);
 }
 
-SOCAT_TEST(cinterface_io, read_error)
+TEST(cinterface_io, read_error)
 {
     uint8_t buffer[16];
     LONGS_EQUAL(-COMSER_IOERROR, comserial_read_buffer(NULL, buffer, 16));
@@ -318,7 +361,7 @@ SOCAT_TEST(cinterface_io, read_error)
     LONGS_EQUAL(-COMSER_IOERROR, comserial_read_buffer(in, buffer, 0));
 }
 
-SOCAT_TEST(cinterface_io, read_timeout)
+TEST(cinterface_io, read_timeout)
 {
     uint8_t buffer[4] = { 0xde, 0xad, 0xbe, 0xef };
     uint8_t read_buffer[16] = { };
@@ -328,4 +371,73 @@ SOCAT_TEST(cinterface_io, read_timeout)
     LONGS_EQUAL(-4, comserial_read_buffer(out, read_buffer, 16));
     MEMCMP_EQUAL(buffer, read_buffer, 4);
 }
+
+TEST(cinterface_io, write_read_buffers)
+{
+    uint8_t header[2] = { 0x7e, 0x03 };
+    uint8_t payload[3] = { 0x01, 0x02, 0x03 };
+    uint8_t crc[1] = { 0x55 };
+    uint8_t expected[6] = { 0x7e, 0x03, 0x01, 0x02, 0x03, 0x55 };
+    uint8_t first[4] = { };
+    uint8_t second[4] = { };
+    struct iovec out_iov[3] = {
+        { header, sizeof(header) },
+        { payload, sizeof(payload) },
+        { crc, sizeof(crc) },
+    };
+    struct iovec in_iov[2] = {
+        { first, sizeof(first) },
+        { second, sizeof(second) },
+    };
+
+    LONGS_EQUAL(-COMSER_IOERROR, comserial_write_buffers(NULL, out_iov, 3));
+    LONGS_EQUAL(-COMSER_IOERROR, comserial_write_buffers(in, NULL, 3));
+    LONGS_EQUAL(6, comserial_write_buffers(in, out_iov, 3));
+    LONGS_EQUAL(-6, comserial_read_buffers(out, in_iov, 2));
+    MEMCMP_EQUAL(expected, first, 4);
+    MEMCMP_EQUAL(expected + 4, second, 2);
+}
+
+TEST(cinterface_io, read_until)
+{
+    const uint8_t message[8] = { 'a', 'b', '\n', 'c', '\r', 'd', 'e', 'f' };
+    const uint8_t delimiters[2] = { '\n', '\r' };
+    uint8_t buffer[8] = { };
+
+    LONGS_EQUAL(-COMSER_IOERROR, comserial_read_until(NULL, delimiters, 2,
+                                                      buffer, 8));
+    LONGS_EQUAL(-COMSER_IOERROR, comserial_read_until(out, delimiters, 2,
+                                                      NULL, 8));
+    LONGS_EQUAL(8, comserial_write_buffer(in, message, 8));
+    LONGS_EQUAL(3, comserial_read_until(out, delimiters, 2, buffer, 8));
+    MEMCMP_EQUAL(message, buffer, 3);
+    LONGS_EQUAL(2, comserial_read_until(out, delimiters, 2, buffer, 8));
+    MEMCMP_EQUAL(message + 3, buffer, 2);
+    LONGS_EQUAL(3, comserial_read_buffer(out, buffer, 3));
+    MEMCMP_EQUAL(message + 5, buffer, 3);
+}
+
+TEST(cinterface_io, stats)
+{
+    uint8_t buffer[4] = { 0xde, 0xad, 0xbe, 0xef };
+    uint8_t read_buffer[16] = { };
+    comserial_stats_t stats;
+
+    LONGS_EQUAL(-1, comserial_get_stats(NULL, &stats));
+    LONGS_EQUAL(-1, comserial_get_stats(in, NULL));
+
+    LONGS_EQUAL(4, comserial_write_buffer(in, buffer, 4));
+    LONGS_EQUAL(-4, comserial_read_buffer(out, read_buffer, 16));
+
+    LONGS_EQUAL(0, comserial_get_stats(in, &stats));
+    UNSIGNED_LONGS_EQUAL(4, stats.write.bytes);
+    UNSIGNED_LONGS_EQUAL(1, stats.write.calls);
+    UNSIGNED_LONGS_EQUAL(0, stats.read.calls);
+
+    LONGS_EQUAL(0, comserial_get_stats(out, &stats));
+    UNSIGNED_LONGS_EQUAL(4, stats.read.bytes);
+    UNSIGNED_LONGS_EQUAL(1, stats.read.timeouts);
+    UNSIGNED_LONGS_EQUAL(4, stats.read.timeout_bytes);
+    UNSIGNED_LONGS_EQUAL(0, stats.write.calls);
+}
 #endif /* end of include guard: UT_CMODULE_H_UJEVLXFG */
@@ -0,0 +1,8 @@
+#include "ut_executor.h"
+
+#include <CppUTest/CommandLineTestRunner.h>
+
+int main(int argc, char *argv[])
+{
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
@@ -0,0 +1,173 @@
+#ifndef UT_EXECUTOR_H_T2NQ8WCA
+#define UT_EXECUTOR_H_T2NQ8WCA
+
+#include <comserial/coroutine.h>
+
+#include <CppUTest/TestHarness.h>
+#include <string>
+#include <cstring>
+
+TEST_GROUP(coroutine_executor)
+{
+    fake::serial *m_serial;
+    std::string com_in = "com_in";
+    std::string com_out = "com_out";
+
+    com::serial *in;
+    com::serial *out;
+
+    void setup()
+    {
+        m_serial = new fake::serial(com_in, com_out);
+
+        in = new com::serial(com_in);
+        out = new com::serial(com_out);
+    };
+
+    void teardown()
+    {
+        delete out;
+        delete in;
+
+        delete m_serial;
+    };
+};
+
+static com::task<int> answer()
+{
+    co_return 42;
+}
+
+static com::task<> nested(int &result)
+{
+    result = co_await answer();
+}
+
+TEST(coroutine_executor, nested_task)
+{
+    com::executor ex;
+    int result = 0;
+
+    ex.spawn(nested(result));
+    UNSIGNED_LONGS_EQUAL(1, ex.size());
+    ex.run();
+
+    LONGS_EQUAL(42, result);
+    UNSIGNED_LONGS_EQUAL(0, ex.size());
+}
+
+static com::task<> failing()
+{
+    throw com::exception::invalid_input();
+    co_return;
+}
+
+TEST(coroutine_executor, task_exception)
+{
+    com::executor ex;
+
+    ex.spawn(failing());
+    CHECK_THROWS(com::exception::invalid_input, ex.run_once(0));
+    UNSIGNED_LONGS_EQUAL(0, ex.size());
+}
+
+static com::task<> writer(com::executor &ex, com::serial &device,
+                          const uint8_t *buffer, size_t length)
+{
+    co_await com::async_write(ex, device, buffer, length);
+}
+
+static com::task<> reader(com::executor &ex, com::serial &device,
+                          uint8_t *buffer, size_t length, size_t &result)
+{
+    result = co_await com::async_read(ex, device, buffer, length);
+}
+
+TEST(coroutine_executor, write_and_read)
+{
+    uint8_t buffer[16];
+    uint8_t read_buffer[16] = { };
+    size_t read_size = 0;
+    com::executor ex;
+
+    for (size_t index = 0; index < 16; index++)
+        buffer[index] = static_cast<uint8_t>(index);
+
+    ex.spawn(reader(ex, *out, read_buffer, 16, read_size));
+    ex.spawn(writer(ex, *in, buffer, 16));
+    ex.run();
+
+    UNSIGNED_LONGS_EQUAL(16, read_size);
+    MEMCMP_EQUAL(buffer, read_buffer, 16);
+}
+
+TEST(coroutine_executor, read_timeout)
+{
+    uint8_t read_buffer[16] = { };
+    size_t read_size = 0;
+    com::executor ex;
+
+    out->set_read_timeout(50);
+    ex.spawn(reader(ex, *out, read_buffer, 16, read_size));
+    CHECK_THROWS(com::exception::timeout, ex.run());
+    UNSIGNED_LONGS_EQUAL(0, ex.size());
+}
+
+static com::task<> lines(com::executor &ex, com::serial &device,
+                         std::string &first, std::string &second)
+{
+    uint8_t buffer[32];
+    size_t size = co_await com::async_read_until(ex, device, buffer,
+                                                 sizeof(buffer), '\n');
+    first.assign(reinterpret_cast<char *>(buffer), size);
+    size = co_await com::async_read_until(ex, device, buffer,
+                                          sizeof(buffer), '\n');
+    second.assign(reinterpret_cast<char *>(buffer), size);
+}
+
+TEST(coroutine_executor, read_until)
+{
+    const char *message = "hello\nworld\n";
+    std::string first;
+    std::string second;
+    com::executor ex;
+
+    in->write_buffer(reinterpret_cast<const uint8_t *>(message),
+                     strlen(message));
+
+    ex.spawn(lines(ex, *out, first, second));
+    ex.run();
+
+    STRCMP_EQUAL("hello\n", first.c_str());
+    STRCMP_EQUAL("world\n", second.c_str());
+}
+
+static com::task<> line(com::executor &ex, com::serial &device,
+                        std::string &first)
+{
+    uint8_t buffer[32];
+    size_t size = co_await com::async_read_until(ex, device, buffer,
+                                                 sizeof(buffer), '\n');
+    first.assign(reinterpret_cast<char *>(buffer), size);
+}
+
+TEST(coroutine_executor, read_until_then_read)
+{
+    const char *message = "hello\nworld\n";
+    std::string first;
+    uint8_t buffer[32];
+    com::executor ex;
+
+    in->write_buffer(reinterpret_cast<const uint8_t *>(message),
+                     strlen(message));
+
+    ex.spawn(line(ex, *out, first));
+    ex.run();
+    STRCMP_EQUAL("hello\n", first.c_str());
+
+    // Data beyond delimiter are left to device, not to executor.
+    UNSIGNED_LONGS_EQUAL(6, out->read_buffer(buffer, 6));
+    MEMCMP_EQUAL("world\n", buffer, 6);
+}
+
+#endif /* end of include guard: UT_EXECUTOR_H_T2NQ8WCA */
@@ -0,0 +1,138 @@
+#ifndef UT_BUFFERED_H_X4PLD9QE
+#define UT_BUFFERED_H_X4PLD9QE
+
+#include <comserial/buffered.h>
+
+#include <CppUTest/TestHarness.h>
+#include <string>
+#include <cstring>
+#include <unistd.h>
+
+TEST_GROUP(cppinterface_buffered)
+{
+    fake::serial *m_serial;
+    std::string com_in = "com_in";
+    std::string com_out = "com_out";
+
+    com::serial *in;
+    com::serial *out;
+
+    void setup()
+    {
+        m_serial = new fake::serial(com_in, com_out);
+
+        in = new com::serial(com_in);
+        out = new com::serial(com_out);
+    };
+
+    void teardown()
+    {
+        delete out;
+        delete in;
+
+        delete m_serial;
+    };
+};
+
+TEST(cppinterface_buffered, invalid_capacity)
+{
+    com::buffered_serial *b = NULL;
+
+    CHECK_THROWS(com::exception::invalid_input,
+                 b = new com::buffered_serial(*out, 0));
+
+    delete b;
+}
+
+TEST(cppinterface_buffered, capacity_power_of_two)
+{
+    com::buffered_serial b(*out, 1000);
+
+    UNSIGNED_LONGS_EQUAL(1024, b.capacity());
+    UNSIGNED_LONGS_EQUAL(0, b.available());
+    UNSIGNED_LONGS_EQUAL(0, b.high_water_mark());
+    UNSIGNED_LONGS_EQUAL(0, b.overflow_count());
+    POINTERS_EQUAL(out, &b.device());
+}
+
+TEST(cppinterface_buffered, read_buffer)
+{
+    uint8_t buffer[16];
+    uint8_t read_buffer[16] = { };
+    com::buffered_serial b(*out);
+
+    for (size_t index = 0; index < 16; index++)
+        buffer[index] = static_cast<uint8_t>(index);
+
+    in->write_buffer(buffer, 16);
+
+    UNSIGNED_LONGS_EQUAL(16, b.read_buffer(read_buffer, 16));
+    MEMCMP_EQUAL(buffer, read_buffer, 16);
+    CHECK(b.high_water_mark() > 0);
+
+    CHECK_THROWS(com::exception::invalid_input, b.read_buffer(NULL, 16));
+    CHECK_THROWS(com::exception::invalid_input, b.read_available(buffer, 0));
+}
+
+TEST(cppinterface_buffered, read_timeout)
+{
+    uint8_t buffer[4] = { 0xde, 0xad, 0xbe, 0xef };
+    uint8_t read_buffer[16] = { };
+    std::error_code ec;
+    com::buffered_serial b(*out);
+
+    out->set_read_timeout(100);
+    UNSIGNED_LONGS_EQUAL(0, b.read_some(read_buffer, 16, ec));
+    CHECK(ec == std::errc::timed_out);
+
+    in->write_buffer(buffer, 4);
+    try {
+        b.read_buffer(read_buffer, 16);
+        FAIL("No exception thrown");
+    } catch (const com::exception::timeout &e) {
+        UNSIGNED_LONGS_EQUAL(4, e.get_bytes());
+    }
+    MEMCMP_EQUAL(buffer, read_buffer, 4);
+}
+
+TEST(cppinterface_buffered, stalled_consumer)
+{
+    uint8_t buffer[64];
+    uint8_t read_buffer[64] = { };
+    com::buffered_serial b(*out, 16);
+
+    for (size_t index = 0; index < 64; index++)
+        buffer[index] = static_cast<uint8_t>(index);
+
+    in->write_buffer(buffer, 64);
+    for (int i = 0; i < 50 && b.overflow_count() < 48; i++)
+        usleep(10000);
+
+    UNSIGNED_LONGS_EQUAL(16, b.available());
+    UNSIGNED_LONGS_EQUAL(16, b.high_water_mark());
+    UNSIGNED_LONGS_EQUAL(48, b.overflow_count());
+
+    UNSIGNED_LONGS_EQUAL(16, b.read_available(read_buffer, 64));
+    MEMCMP_EQUAL(buffer, read_buffer, 16);
+    UNSIGNED_LONGS_EQUAL(0, b.available());
+}
+
+TEST(cppinterface_buffered, read_ahead_data)
+{
+    const char *message = "line\ntail";
+    uint8_t read_buffer[16] = { };
+
+    in->write_buffer(reinterpret_cast<const uint8_t *>(message), 9);
+    UNSIGNED_LONGS_EQUAL(5, out->read_until('\n', read_buffer, 16));
+
+    // Remaining bytes were read ahead by device, not lost by reader thread.
+    com::buffered_serial b(*out);
+    UNSIGNED_LONGS_EQUAL(4, b.read_buffer(read_buffer, 4));
+    MEMCMP_EQUAL("tail", read_buffer, 4);
+
+    in->write_buffer(reinterpret_cast<const uint8_t *>(message), 5);
+    UNSIGNED_LONGS_EQUAL(5, b.read_buffer(read_buffer, 5));
+    UNSIGNED_LONGS_EQUAL(14, out->stats().read.bytes);
+}
+
+#endif /* end of include guard: UT_BUFFERED_H_X4PLD9QE */
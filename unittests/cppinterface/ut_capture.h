@@ -0,0 +1,180 @@
+#ifndef UT_CAPTURE_H_W6FJ2LQS
+#define UT_CAPTURE_H_W6FJ2LQS
+
+#include <comserial/capture.h>
+
+#include <CppUTest/TestHarness.h>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+TEST_GROUP(cppinterface_capture)
+{
+    fake::serial *m_serial;
+    std::string com_in = "com_in";
+    std::string com_out = "com_out";
+    std::string path = "unittests_capture.cap";
+
+    void setup()
+    {
+        m_serial = new fake::serial(com_in, com_out);
+    };
+
+    void teardown()
+    {
+        delete m_serial;
+        for (int i = 0; i < 4; i++)
+            unlink((i == 0 ? path : path + "." + std::to_string(i)).c_str());
+    };
+};
+
+TEST(cppinterface_capture, invalid_input)
+{
+    com::capture *c = NULL;
+
+    CHECK_THROWS(com::exception::invalid_input,
+                 c = new com::capture(path, 16));
+    CHECK_THROWS(com::exception::invalid_input,
+                 c = new com::capture(path, 4096, 0));
+    CHECK_THROWS(com::exception::runtime_error,
+                 c = new com::capture("/nonexistent/capture.cap"));
+    CHECK_THROWS(com::exception::runtime_error,
+                 com::capture_reader r("/nonexistent/capture.cap"));
+
+    delete c;
+}
+
+TEST(cppinterface_capture, device_traffic)
+{
+    {
+        com::capture c(path, 4096);
+        com::serial in(com_in);
+        com::serial out(com_out);
+        uint8_t buffer[4] = { 'p', 'i', 'n', 'g' };
+
+        in.set_capture(&c);
+        out.set_capture(&c);
+        out.write_buffer(buffer, sizeof(buffer));
+        memset(buffer, 0, sizeof(buffer));
+        in.read_buffer(buffer, sizeof(buffer));
+        in.set_capture(NULL);
+        out.set_capture(NULL);
+
+        // Not captured anymore
+        out.write_buffer(buffer, sizeof(buffer));
+        UNSIGNED_LONGS_EQUAL(0, c.dropped());
+        UNSIGNED_LONGS_EQUAL(1, c.file_count());
+    }
+
+    com::capture_reader reader(path);
+    com::capture_record r;
+
+    CHECK(reader.start_realtime() != 0);
+    CHECK(reader.start_monotonic() != 0);
+
+    CHECK(reader.next(r));
+    LONGS_EQUAL(com::capture::port, r.dir);
+    UNSIGNED_LONGS_EQUAL(0, r.port);
+    STRCMP_EQUAL(com_in.c_str(), reader.port_name(0).c_str());
+
+    CHECK(reader.next(r));
+    LONGS_EQUAL(com::capture::port, r.dir);
+    STRCMP_EQUAL(com_out.c_str(), reader.port_name(1).c_str());
+
+    CHECK(reader.next(r));
+    LONGS_EQUAL(com::capture::tx, r.dir);
+    UNSIGNED_LONGS_EQUAL(1, r.port);
+    UNSIGNED_LONGS_EQUAL(4, r.size);
+    MEMCMP_EQUAL("ping", r.data, 4);
+    uint64_t sent = r.timestamp;
+
+    CHECK(reader.next(r));
+    LONGS_EQUAL(com::capture::rx, r.dir);
+    UNSIGNED_LONGS_EQUAL(0, r.port);
+    UNSIGNED_LONGS_EQUAL(4, r.size);
+    MEMCMP_EQUAL("ping", r.data, 4);
+    CHECK(r.timestamp >= sent);
+
+    CHECK_FALSE(reader.next(r));
+    STRCMP_EQUAL("", reader.port_name(2).c_str());
+}
+
+TEST(cppinterface_capture, rotation)
+{
+    const uint8_t data[40] = { 0 };
+    {
+        com::capture c(path, 256, 3);
+        uint16_t port = c.add_port("port");
+
+        // 56 bytes records, 3 per file after header and port definition
+        for (int i = 0; i < 10; i++)
+            c.record(port, com::capture::rx, data, sizeof(data));
+        UNSIGNED_LONGS_EQUAL(4, c.file_count());
+
+        // Larger than a file
+        uint8_t large[512] = { 0 };
+        c.record(port, com::capture::tx, large, sizeof(large));
+        UNSIGNED_LONGS_EQUAL(1, c.dropped());
+    }
+
+    CHECK(access((path + ".3").c_str(), F_OK) != 0);
+    for (int i = 0; i < 3; i++) {
+        com::capture_reader reader(i == 0 ? path
+                                          : path + "." + std::to_string(i));
+        com::capture_record r;
+        size_t records = 0;
+
+        // Each file can be read alone
+        CHECK(reader.next(r));
+        LONGS_EQUAL(com::capture::port, r.dir);
+        STRCMP_EQUAL("port", reader.port_name(0).c_str());
+        while (reader.next(r)) {
+            LONGS_EQUAL(com::capture::rx, r.dir);
+            UNSIGNED_LONGS_EQUAL(sizeof(data), r.size);
+            records++;
+        }
+        UNSIGNED_LONGS_EQUAL(i == 0 ? 1 : 3, records);
+    }
+}
+
+TEST(cppinterface_capture, concurrent_writers)
+{
+    const size_t THREADS = 4;
+    const size_t RECORDS = 1000;
+    {
+        com::capture c(path, 1024 * 1024, 1);
+        std::vector<std::thread> writers;
+
+        for (size_t t = 0; t < THREADS; t++) {
+            uint16_t port = c.add_port(std::to_string(t));
+            writers.push_back(std::thread([&c, port, t] {
+                std::vector<uint8_t> data(t + 1, static_cast<uint8_t>(t));
+                for (size_t i = 0; i < RECORDS; i++)
+                    c.record(port, com::capture::tx, data.data(), data.size());
+            }));
+        }
+        for (auto &w: writers)
+            w.join();
+    }
+
+    com::capture_reader reader(path);
+    com::capture_record r;
+    size_t counts[THREADS] = { 0 };
+
+    while (reader.next(r)) {
+        if (r.dir == com::capture::port)
+            continue;
+        CHECK(r.port < THREADS);
+        UNSIGNED_LONGS_EQUAL(r.port + 1, r.size);
+        for (size_t i = 0; i < r.size; i++)
+            UNSIGNED_LONGS_EQUAL(r.port, r.data[i]);
+        counts[r.port]++;
+    }
+    for (size_t t = 0; t < THREADS; t++)
+        UNSIGNED_LONGS_EQUAL(RECORDS, counts[t]);
+}
+
+#endif /* end of include guard: UT_CAPTURE_H_W6FJ2LQS */
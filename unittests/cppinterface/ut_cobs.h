@@ -0,0 +1,218 @@
+#ifndef UT_COBS_H_Q4XH7NPD
+#define UT_COBS_H_Q4XH7NPD
+
+#include <comserial/cobs.h>
+
+#include <CppUTest/TestHarness.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+TEST_GROUP(cppinterface_cobs)
+{
+    fake::serial *m_serial;
+    std::string com_in = "com_in";
+    std::string com_out = "com_out";
+
+    com::serial *in;
+    com::serial *out;
+
+    void setup()
+    {
+        m_serial = new fake::serial(com_in, com_out);
+
+        in = new com::serial(com_in);
+        out = new com::serial(com_out);
+    };
+
+    void teardown()
+    {
+        delete out;
+        delete in;
+
+        delete m_serial;
+    };
+
+    /**
+    * @brief Encode a frame and compare with expected encoding.
+    *
+    * @param data Frame.
+    * @param expected Expected encoding.
+    */
+    void check_encoding(const std::vector<uint8_t> &data,
+                        const std::vector<uint8_t> &expected)
+    {
+        std::vector<uint8_t> buffer(com::cobs::max_encoded_size(data.size()));
+        std::error_code ec;
+
+        size_t size = com::cobs::encode(data.data(), data.size(),
+                                        buffer.data());
+        buffer.resize(size);
+        CHECK(buffer == expected);
+
+        size = com::cobs::decode(buffer.data(), buffer.size(), buffer.data(),
+                                 ec);
+        CHECK(!ec);
+        buffer.resize(size);
+        CHECK(buffer == data);
+    }
+
+    void send(const std::string &data)
+    {
+        in->write_buffer(reinterpret_cast<const uint8_t *>(data.data()),
+                         data.size());
+    }
+};
+
+TEST(cppinterface_cobs, encode)
+{
+    check_encoding({ 0x00 }, { 0x01, 0x01 });
+    check_encoding({ 0x00, 0x00 }, { 0x01, 0x01, 0x01 });
+    check_encoding({ 0x11, 0x22, 0x00, 0x33 }, { 0x03, 0x11, 0x22, 0x02, 0x33 });
+    check_encoding({ 0x11, 0x22, 0x33, 0x44 }, { 0x05, 0x11, 0x22, 0x33, 0x44 });
+    check_encoding({ 0x11, 0x00, 0x00, 0x00 }, { 0x02, 0x11, 0x01, 0x01, 0x01 });
+
+    // Full blocks
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> expected(1, 0xff);
+    for (int i = 1; i < 255; i++)
+        data.push_back(static_cast<uint8_t>(i));
+    expected.insert(expected.end(), data.begin(), data.end());
+    check_encoding(data, expected);
+
+    data.push_back(0xff);
+    expected.push_back(0x02);
+    expected.push_back(0xff);
+    check_encoding(data, expected);
+
+    data.insert(data.begin(), 0x00);
+    data.pop_back();
+    expected.insert(expected.begin(), 0x01);
+    expected.resize(expected.size() - 2);
+    check_encoding(data, expected);
+}
+
+TEST(cppinterface_cobs, in_place)
+{
+    std::vector<uint8_t> frame;
+    std::vector<uint8_t> buffer;
+    std::error_code ec;
+
+    srand(25);
+    for (size_t size = 0; size < 1200; size += 1 + rand() % 7) {
+        int density = 1 + rand() % 300;
+        frame.resize(size);
+        for (uint8_t &byte: frame)
+            byte = rand() % density == 0 ? 0 : static_cast<uint8_t>(1 + rand() % 255);
+
+        // Frame is stored at end of buffer to encode in place
+        size_t offset = com::cobs::max_encoded_size(size) - size;
+        buffer.assign(offset, 0xaa);
+        buffer.insert(buffer.end(), frame.begin(), frame.end());
+        size_t encoded = com::cobs::encode(buffer.data() + offset, size,
+                                           buffer.data());
+        CHECK(encoded <= com::cobs::max_encoded_size(size));
+        POINTERS_EQUAL(NULL, memchr(buffer.data(), 0, encoded));
+
+        size_t decoded = com::cobs::decode(buffer.data(), encoded,
+                                           buffer.data(), ec);
+        CHECK(!ec);
+        UNSIGNED_LONGS_EQUAL(size, decoded);
+        CHECK(std::equal(frame.begin(), frame.end(), buffer.begin()));
+    }
+}
+
+TEST(cppinterface_cobs, decode_errors)
+{
+    const uint8_t zero[2] = { 0x02, 0x00 };
+    const uint8_t overrun[2] = { 0x05, 0x11 };
+    uint8_t buffer[4];
+    std::error_code ec;
+
+    UNSIGNED_LONGS_EQUAL(0, com::cobs::decode(overrun, 2, buffer, ec));
+    CHECK(ec == std::errc::bad_message);
+    com::cobs::decode(zero + 1, 1, buffer, ec);
+    CHECK(ec == std::errc::bad_message);
+    com::cobs::decode(zero, 2, buffer, ec);
+    CHECK(!ec);
+}
+
+TEST(cppinterface_cobs, device)
+{
+    com::cobs_serial sender(*in, 16);
+    com::cobs_serial receiver(*out, 16);
+    const uint8_t first[4] = { 0x00, 'a', 0x00, 'b' };
+    const uint8_t large[17] = { 0 };
+
+    CHECK_THROWS(com::exception::invalid_input, com::cobs_serial c(*in, 0));
+    CHECK_THROWS(com::exception::invalid_input, sender.write_frame(NULL, 1));
+    CHECK_THROWS(com::exception::invalid_input, sender.write_frame(large, 17));
+
+    UNSIGNED_LONGS_EQUAL(4, sender.write_frame(first, 4));
+    // Oversized and malformed frames, then empty frames
+    send(std::string(20, 'x') + '\0' + "\x05\x11" + '\0' + '\0' + '\0');
+    UNSIGNED_LONGS_EQUAL(5, sender.write_frame(
+                                reinterpret_cast<const uint8_t *>("hello"), 5));
+
+    com::frame f = receiver.read_frame();
+    UNSIGNED_LONGS_EQUAL(4, f.size);
+    MEMCMP_EQUAL(first, f.data, 4);
+
+    f = receiver.read_frame();
+    UNSIGNED_LONGS_EQUAL(5, f.size);
+    MEMCMP_EQUAL("hello", f.data, 5);
+    UNSIGNED_LONGS_EQUAL(2, receiver.dropped());
+}
+
+TEST(cppinterface_cobs, stream)
+{
+    com::cobs_serial sender(*in, 300);
+    com::cobs_serial receiver(*out, 300);
+    std::vector<uint8_t> frame(300);
+    size_t frames = 0;
+
+    // Frames straddle receive buffer ends
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 5; i++) {
+            frame.assign(101 + 37 * i, static_cast<uint8_t>(round * 5 + i));
+            sender.write_frame(frame.data(), frame.size());
+        }
+        for (int i = 0; i < 5; i++) {
+            com::frame f = receiver.read_frame();
+            UNSIGNED_LONGS_EQUAL(101 + 37 * i, f.size);
+            UNSIGNED_LONGS_EQUAL(round * 5 + i, f.data[0]);
+            UNSIGNED_LONGS_EQUAL(round * 5 + i, f.data[f.size - 1]);
+            frames++;
+        }
+    }
+
+    UNSIGNED_LONGS_EQUAL(50, frames);
+    UNSIGNED_LONGS_EQUAL(0, receiver.dropped());
+}
+
+TEST(cppinterface_cobs, partial_frame)
+{
+    com::cobs_serial receiver(*out);
+    std::error_code ec;
+
+    out->set_read_timeout(50);
+    send("\x08part");
+    try {
+        receiver.read_frame();
+        FAIL("Timeout expected");
+    } catch (com::exception::timeout &e) {
+        UNSIGNED_LONGS_EQUAL(5, e.get_bytes());
+    }
+
+    POINTERS_EQUAL(NULL, receiver.try_read_frame(ec).data);
+    CHECK(ec == std::errc::timed_out);
+
+    send(std::string("ial") + '\0');
+    com::frame f = receiver.read_frame();
+    UNSIGNED_LONGS_EQUAL(7, f.size);
+    MEMCMP_EQUAL("partial", f.data, 7);
+}
+
+#endif /* end of include guard: UT_COBS_H_Q4XH7NPD */
@@ -1,5 +1,16 @@
 #include "ut_cppmodule.h"
 #include "ut_exceptions.h"
+#include "ut_reactor.h"
+#include "ut_buffered.h"
+#include "ut_shmstats.h"
+#include "ut_capture.h"
+#include "ut_replayer.h"
+#include "ut_readuntil.h"
+#include "ut_slip.h"
+#include "ut_cobs.h"
+#if HAVE_LIBURING == 1
+#include "ut_uring.h"
+#endif
 
 #include <CppUTest/CommandLineTestRunner.h>
 
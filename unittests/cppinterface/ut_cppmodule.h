@@ -5,7 +5,13 @@
 
 #include <CppUTest/TestHarness.h>
 #include <string>
+#include <algorithm>
 #include <cstring>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
 
 #include "logger.h"
 
@@ -47,7 +53,7 @@ TEST(cppinterface_module, open_existing_notty)
     delete serial;
 };
 
-SOCAT_TEST(cppinterface_module, open_existing)
+TEST(cppinterface_module, open_existing)
 {
     try {
         com::serial serial("com_in");
@@ -57,21 +63,21 @@ SOCAT_TEST(cppinterface_module, open_existing)
     }
 };
 
-SOCAT_TEST(cppinterface_module, check_default_speed)
+TEST(cppinterface_module, check_default_speed)
 {
     com::serial serial("com_in");
 
     UNSIGNED_LONGS_EQUAL(19200, serial.get_speed());
 }
 
-SOCAT_TEST(cppinterface_module, check_user_defined_valid_speed)
+TEST(cppinterface_module, check_user_defined_valid_speed)
 {
     com::serial serial("com_in", 9600);
 
     UNSIGNED_LONGS_EQUAL(9600, serial.get_speed());
 }
 
-SOCAT_TEST(cppinterface_module, set_valid_speed_after)
+TEST(cppinterface_module, set_valid_speed_after)
 {
     com::serial serial("com_in");
 
@@ -80,25 +86,25 @@ SOCAT_TEST(cppinterface_module, set_valid_speed_after)
     UNSIGNED_LONGS_EQUAL(115200, serial.get_speed());
 }
 
-SOCAT_TEST(cppinterface_module, create_invalid_speed)
+TEST(cppinterface_module, create_invalid_speed)
 {
     com::serial *serial = NULL;
 
     CHECK_THROWS(com::exception::invalid_speed,
-                 serial = new com::serial("com_in", 1234));
+                 serial = new com::serial("com_in", 0));
 
     delete serial;
 }
 
-SOCAT_TEST(cppinterface_module, set_invalid_speed)
+TEST(cppinterface_module, set_invalid_speed)
 {
     com::serial serial("com_in");
 
     CHECK_THROWS(com::exception::invalid_speed,
-                 serial.set_speed(4321));
+                 serial.set_speed(0));
 }
 
-SOCAT_TEST(cppinterface_module, set_all_valid_speed)
+TEST(cppinterface_module, set_all_valid_speed)
 {
     com::serial serial("com_in");
 
@@ -129,21 +135,58 @@ SOCAT_TEST(cppinterface_module, set_all_valid_speed)
                              serial.set_speed(valid_speed[i]));
 }
 
-SOCAT_TEST(cppinterface_module, check_default_data_size)
+TEST(cppinterface_module, set_high_speed)
+{
+    com::serial serial("com_in", 921600);
+
+    UNSIGNED_LONGS_EQUAL(921600, serial.set_speed(4000000));
+    UNSIGNED_LONGS_EQUAL(4000000, serial.get_speed());
+}
+
+TEST(cppinterface_module, set_arbitrary_speed)
+{
+    com::serial serial("com_in");
+
+    UNSIGNED_LONGS_EQUAL(19200, serial.set_speed(250000));
+    UNSIGNED_LONGS_EQUAL(250000, serial.set_speed(31250));
+    UNSIGNED_LONGS_EQUAL(31250, serial.set_speed(115200));
+}
+
+TEST(cppinterface_module, arbitrary_speed_with_settings)
+{
+    com::serial serial("com_in", 31250);
+    struct termios options;
+
+    // Every setting is committed along with custom speed
+    serial.set_parity('o');
+    serial.apply(com::serial_config(31250, 7, 2, 'o'), com::apply_drain);
+    UNSIGNED_LONGS_EQUAL(31250, serial.get_speed());
+
+    int fd = open("com_in", O_RDWR | O_NOCTTY);
+    CHECK(fd >= 0);
+    CHECK(tcgetattr(fd, &options) == 0);
+    close(fd);
+    // Pseudo terminals force 8 bits without parity, but keep other flags
+    CHECK(cfgetospeed(&options) != B38400);
+    CHECK((options.c_cflag & PARODD) != 0);
+    CHECK((options.c_cflag & CSTOPB) != 0);
+}
+
+TEST(cppinterface_module, check_default_data_size)
 {
     com::serial serial("com_in");
 
     UNSIGNED_LONGS_EQUAL(8, serial.get_data_size());
 }
 
-SOCAT_TEST(cppinterface_module, check_user_defined_valid_data_size)
+TEST(cppinterface_module, check_user_defined_valid_data_size)
 {
     com::serial serial("com_in", 19200, 7);
 
     UNSIGNED_LONGS_EQUAL(7, serial.get_data_size());
 }
 
-SOCAT_TEST(cppinterface_module, set_valid_data_size_after)
+TEST(cppinterface_module, set_valid_data_size_after)
 {
     com::serial serial("com_in");
 
@@ -152,7 +195,85 @@ SOCAT_TEST(cppinterface_module, set_valid_data_size_after)
     UNSIGNED_LONGS_EQUAL(7, serial.get_data_size());
 }
 
-SOCAT_TEST(cppinterface_module, create_invalid_data_size)
+TEST(cppinterface_module, apply_config)
+{
+    com::serial serial("com_in", 9600);
+
+    com::serial_config old_config = serial.apply(
+                            com::serial_config(115200, 8, 2, 'E'),
+                            com::apply_now);
+    CHECK(old_config == com::serial_config(9600, 8, 1, 'n'));
+    UNSIGNED_LONGS_EQUAL(115200, serial.get_speed());
+    UNSIGNED_LONGS_EQUAL(8, serial.get_data_size());
+    UNSIGNED_LONGS_EQUAL(2, serial.get_stop_size());
+    BYTES_EQUAL('e', serial.get_parity());
+
+    old_config = serial.apply(com::serial_config(115200, 8, 2, 'e'));
+    CHECK(old_config == serial.get_config());
+
+    old_config = serial.apply(com::serial_config(115200, 8, 2, 'e',
+                                                 com::flow_software));
+    CHECK(old_config.flow == com::flow_none);
+    LONGS_EQUAL(com::flow_software, serial.get_flow_control());
+    CHECK(serial.get_config().flow == com::flow_software);
+}
+
+TEST(cppinterface_module, apply_unchanged_config)
+{
+    com::serial serial("com_in", 9600, 8, 1, 'N');
+    struct termios options;
+
+    BYTES_EQUAL('n', serial.get_parity());
+    CHECK(serial.get_config() == com::serial_config(9600, 8, 1, 'n'));
+
+    // Device configuration changed behind instance is left untouched when
+    // applying current configuration
+    int fd = open("com_in", O_RDWR | O_NOCTTY);
+    CHECK(fd >= 0);
+    CHECK(tcgetattr(fd, &options) == 0);
+    options.c_cflag |= CSTOPB;
+    CHECK(tcsetattr(fd, TCSANOW, &options) == 0);
+
+    serial.apply(serial.get_config());
+    CHECK(tcgetattr(fd, &options) == 0);
+    CHECK((options.c_cflag & CSTOPB) != 0);
+    close(fd);
+}
+
+TEST(cppinterface_module, apply_invalid_config)
+{
+    com::serial serial("com_in", 9600);
+
+    CHECK_THROWS(com::exception::invalid_stop_size,
+                 serial.apply(com::serial_config(115200, 8, 3, 'o')));
+    CHECK(serial.get_config() == com::serial_config(9600, 8, 1, 'n'));
+
+    CHECK_THROWS(com::exception::invalid_flow_control,
+                 serial.apply(com::serial_config(115200, 8, 1, 'n',
+                                  static_cast<com::flow_control>(42))));
+    CHECK(serial.get_config() == com::serial_config(9600, 8, 1, 'n'));
+
+    CHECK_THROWS(com::exception::invalid_input,
+                 serial.apply(com::serial_config(),
+                              static_cast<com::apply_when>(42)));
+}
+
+TEST(cppinterface_module, set_flow_control)
+{
+    com::serial serial("com_in");
+
+    LONGS_EQUAL(com::flow_none, serial.get_flow_control());
+    LONGS_EQUAL(com::flow_none, serial.set_flow_control(com::flow_hardware));
+    LONGS_EQUAL(com::flow_hardware,
+                serial.set_flow_control(com::flow_software));
+    LONGS_EQUAL(com::flow_software, serial.set_flow_control(com::flow_none));
+
+    CHECK_THROWS(com::exception::invalid_flow_control,
+                 serial.set_flow_control(static_cast<com::flow_control>(3)));
+    LONGS_EQUAL(com::flow_none, serial.get_flow_control());
+}
+
+TEST(cppinterface_module, create_invalid_data_size)
 {
     com::serial *serial = NULL;
 
@@ -162,7 +283,7 @@ SOCAT_TEST(cppinterface_module, create_invalid_data_size)
     delete serial;
 }
 
-SOCAT_TEST(cppinterface_module, set_invalid_data_size)
+TEST(cppinterface_module, set_invalid_data_size)
 {
     com::serial serial("com_in");
 
@@ -170,7 +291,7 @@ SOCAT_TEST(cppinterface_module, set_invalid_data_size)
                  serial.set_data_size(4321));
 }
 
-SOCAT_TEST(cppinterface_module, set_all_valid_data_size)
+TEST(cppinterface_module, set_all_valid_data_size)
 {
     com::serial serial("com_in");
 
@@ -183,21 +304,21 @@ SOCAT_TEST(cppinterface_module, set_all_valid_data_size)
                              serial.set_data_size(valid_data_size[i]));
 }
 
-SOCAT_TEST(cppinterface_module, check_default_stop_size)
+TEST(cppinterface_module, check_default_stop_size)
 {
     com::serial serial("com_in");
 
     UNSIGNED_LONGS_EQUAL(1, serial.get_stop_size());
 }
 
-SOCAT_TEST(cppinterface_module, check_user_defined_valid_stop_size)
+TEST(cppinterface_module, check_user_defined_valid_stop_size)
 {
     com::serial serial("com_in", 19200, 8, 2);
 
     UNSIGNED_LONGS_EQUAL(2, serial.get_stop_size());
 }
 
-SOCAT_TEST(cppinterface_module, set_valid_stop_size_after)
+TEST(cppinterface_module, set_valid_stop_size_after)
 {
     com::serial serial("com_in");
 
@@ -206,7 +327,7 @@ SOCAT_TEST(cppinterface_module, set_valid_stop_size_after)
     UNSIGNED_LONGS_EQUAL(2, serial.get_stop_size());
 }
 
-SOCAT_TEST(cppinterface_module, create_invalid_stop_size)
+TEST(cppinterface_module, create_invalid_stop_size)
 {
     com::serial *serial = NULL;
 
@@ -216,7 +337,7 @@ SOCAT_TEST(cppinterface_module, create_invalid_stop_size)
     delete serial;
 }
 
-SOCAT_TEST(cppinterface_module, set_invalid_stop_size)
+TEST(cppinterface_module, set_invalid_stop_size)
 {
     com::serial serial("com_in");
 
@@ -224,7 +345,7 @@ SOCAT_TEST(cppinterface_module, set_invalid_stop_size)
                  serial.set_stop_size(4321));
 }
 
-SOCAT_TEST(cppinterface_module, set_all_valid_stop_size)
+TEST(cppinterface_module, set_all_valid_stop_size)
 {
     com::serial serial("com_in");
 
@@ -237,21 +358,21 @@ SOCAT_TEST(cppinterface_module, set_all_valid_stop_size)
                              serial.set_stop_size(valid_stop_size[i]));
 }
 
-SOCAT_TEST(cppinterface_module, check_default_parity)
+TEST(cppinterface_module, check_default_parity)
 {
     com::serial serial("com_in");
 
     UNSIGNED_LONGS_EQUAL('n', serial.get_parity());
 }
 
-SOCAT_TEST(cppinterface_module, check_user_defined_valid_parity)
+TEST(cppinterface_module, check_user_defined_valid_parity)
 {
     com::serial serial("com_in", 19200, 8, 2, 'o');
 
     UNSIGNED_LONGS_EQUAL('o', serial.get_parity());
 }
 
-SOCAT_TEST(cppinterface_module, set_valid_parity_after)
+TEST(cppinterface_module, set_valid_parity_after)
 {
     com::serial serial("com_in");
 
@@ -260,7 +381,7 @@ SOCAT_TEST(cppinterface_module, set_valid_parity_after)
     UNSIGNED_LONGS_EQUAL('o', serial.get_parity());
 }
 
-SOCAT_TEST(cppinterface_module, create_invalid_parity)
+TEST(cppinterface_module, create_invalid_parity)
 {
     com::serial *serial = NULL;
 
@@ -270,7 +391,7 @@ SOCAT_TEST(cppinterface_module, create_invalid_parity)
     delete serial;
 }
 
-SOCAT_TEST(cppinterface_module, set_invalid_parity)
+TEST(cppinterface_module, set_invalid_parity)
 {
     com::serial serial("com_in");
 
@@ -278,7 +399,7 @@ SOCAT_TEST(cppinterface_module, set_invalid_parity)
                  serial.set_parity('X'));
 }
 
-SOCAT_TEST(cppinterface_module, set_all_valid_parity)
+TEST(cppinterface_module, set_all_valid_parity)
 {
     com::serial serial("com_in");
 
@@ -291,21 +412,21 @@ SOCAT_TEST(cppinterface_module, set_all_valid_parity)
                              serial.set_parity(valid_parity[i]));
 }
 
-SOCAT_TEST(cppinterface_module, check_default_read_timeout)
+TEST(cppinterface_module, check_default_read_timeout)
 {
     com::serial serial("com_in");
 
     UNSIGNED_LONGS_EQUAL(1000, serial.get_read_timeout());
 }
 
-SOCAT_TEST(cppinterface_module, check_default_write_timeout)
+TEST(cppinterface_module, check_default_write_timeout)
 {
     com::serial serial("com_in");
 
     UNSIGNED_LONGS_EQUAL(1000, serial.get_write_timeout());
 }
 
-SOCAT_TEST(cppinterface_module, set_read_timeout)
+TEST(cppinterface_module, set_read_timeout)
 {
     com::serial serial("com_in");
     unsigned int old_timeout = serial.set_read_timeout(10);
@@ -314,7 +435,7 @@ SOCAT_TEST(cppinterface_module, set_read_timeout)
     UNSIGNED_LONGS_EQUAL(10, serial.get_read_timeout());
 }
 
-SOCAT_TEST(cppinterface_module, set_write_timeout)
+TEST(cppinterface_module, set_write_timeout)
 {
     com::serial serial("com_in");
     unsigned int old_timeout = serial.set_write_timeout(10);
@@ -349,7 +470,7 @@ TEST_GROUP(cppinterface_io)
     };
 };
 
-SOCAT_TEST(cppinterface_io, write_buffer)
+TEST(cppinterface_io, write_buffer)
 {
     uint8_t buffer[16];
     for (size_t index = 0; index < 16; index++)
@@ -358,7 +479,7 @@ SOCAT_TEST(cppinterface_io, write_buffer)
     UNSIGNED_LONGS_EQUAL(16, in->write_buffer(buffer, 16));
 }
 
-SOCAT_TEST(cppinterface_io, write_error)
+TEST(cppinterface_io, write_error)
 {
     uint8_t buffer[16];
     CHECK_THROWS(com::exception::invalid_input,
@@ -367,7 +488,7 @@ SOCAT_TEST(cppinterface_io, write_error)
                  in->write_buffer(buffer, 0));
 }
 
-SOCAT_TEST(cppinterface_io, read_buffer)
+TEST(cppinterface_io, read_buffer)
 {
     uint8_t buffer[16];
     uint8_t read_buffer[18];
@@ -386,7 +507,7 @@ SOCAT_TEST(cppinterface_io, read_buffer)
     MEMCMP_EQUAL(buffer, &read_buffer[1], 16);
 }
 
-SOCAT_TEST(cppinterface_io, read_buffer_small)
+TEST(cppinterface_io, read_buffer_small)
 {
     uint8_t buffer[8];
     uint8_t read_buffer[10];
@@ -405,7 +526,7 @@ SOCAT_TEST(cppinterface_io, read_buffer_small)
     MEMCMP_EQUAL(buffer, &read_buffer[1], 8);
 }
 
-SOCAT_TEST(cppinterface_io, read_error)
+TEST(cppinterface_io, read_error)
 {
     uint8_t buffer[16];
     CHECK_THROWS(com::exception::invalid_input,
@@ -414,7 +535,7 @@ SOCAT_TEST(cppinterface_io, read_error)
                  in->read_buffer(buffer, 0));
 }
 
-SOCAT_TEST(cppinterface_io, read_timeout)
+TEST(cppinterface_io, read_timeout)
 {
     uint8_t buffer[4] = { 0xde, 0xad, 0xbe, 0xef };
     uint8_t read_buffer[16] = { };
@@ -432,4 +553,301 @@ SOCAT_TEST(cppinterface_io, read_timeout)
     MEMCMP_EQUAL(buffer, read_buffer, 4);
 }
 
+TEST(cppinterface_io, some_error)
+{
+    uint8_t buffer[16];
+    std::error_code ec;
+
+    UNSIGNED_LONGS_EQUAL(0, in->write_some(NULL, 16, ec));
+    CHECK(ec == std::errc::invalid_argument);
+    UNSIGNED_LONGS_EQUAL(0, in->read_some(buffer, 0, ec));
+    CHECK(ec == std::errc::invalid_argument);
+    UNSIGNED_LONGS_EQUAL(0, in->try_write_exact(buffer, 0, ec));
+    CHECK(ec == std::errc::invalid_argument);
+    UNSIGNED_LONGS_EQUAL(0, in->try_read_exact(NULL, 16, ec));
+    CHECK(ec == std::errc::invalid_argument);
+}
+
+TEST(cppinterface_io, write_read_some)
+{
+    uint8_t buffer[4] = { 0xde, 0xad, 0xbe, 0xef };
+    uint8_t read_buffer[16] = { };
+    size_t read_size = 0;
+    std::error_code ec;
+
+    UNSIGNED_LONGS_EQUAL(4, in->write_some(buffer, 4, ec));
+    CHECK_FALSE(ec);
+
+    out->set_read_timeout(100);
+    while (read_size < 4 && !ec)
+        read_size += out->read_some(read_buffer + read_size,
+                                    sizeof(read_buffer) - read_size, ec);
+
+    CHECK_FALSE(ec);
+    UNSIGNED_LONGS_EQUAL(4, read_size);
+    MEMCMP_EQUAL(buffer, read_buffer, 4);
+
+    UNSIGNED_LONGS_EQUAL(0, out->read_some(read_buffer, 16, ec));
+    CHECK(ec == std::errc::timed_out);
+}
+
+TEST(cppinterface_io, try_read_exact_timeout)
+{
+    uint8_t buffer[4] = { 0xde, 0xad, 0xbe, 0xef };
+    uint8_t read_buffer[16] = { };
+    std::error_code ec;
+
+    UNSIGNED_LONGS_EQUAL(4, in->try_write_exact(buffer, 4, ec));
+    CHECK_FALSE(ec);
+
+    UNSIGNED_LONGS_EQUAL(4, out->try_read_exact(read_buffer, 16, ec));
+    CHECK(ec == std::errc::timed_out);
+    MEMCMP_EQUAL(buffer, read_buffer, 4);
+
+    in->write_buffer(buffer, 4);
+    UNSIGNED_LONGS_EQUAL(4, out->try_read_exact(read_buffer, 4, ec));
+    CHECK_FALSE(ec);
+}
+
+TEST(cppinterface_io, stats_transfer)
+{
+    uint8_t buffer[16] = { };
+    uint8_t read_buffer[16];
+
+    in->write_buffer(buffer, 16);
+    out->read_buffer(read_buffer, 16);
+
+    com::serial_stats stats = out->stats();
+    UNSIGNED_LONGS_EQUAL(16, stats.read.bytes);
+    UNSIGNED_LONGS_EQUAL(1, stats.read.calls);
+    CHECK(stats.read.syscalls >= 2);
+    UNSIGNED_LONGS_EQUAL(0, stats.read.timeouts);
+    UNSIGNED_LONGS_EQUAL(0, stats.read.errors);
+    UNSIGNED_LONGS_EQUAL(0, stats.write.calls);
+
+    uint64_t histogram = 0;
+    for (size_t i = 0; i < com::io_stats::LATENCY_BUCKETS; i++)
+        histogram += stats.read.latency[i];
+    UNSIGNED_LONGS_EQUAL(1, histogram);
+
+    stats = in->stats();
+    UNSIGNED_LONGS_EQUAL(16, stats.write.bytes);
+    UNSIGNED_LONGS_EQUAL(1, stats.write.calls);
+    UNSIGNED_LONGS_EQUAL(0, stats.read.calls);
+}
+
+TEST(cppinterface_io, stats_timeout_error)
+{
+    uint8_t buffer[4] = { 0xde, 0xad, 0xbe, 0xef };
+    uint8_t read_buffer[16];
+    std::error_code ec;
+
+    out->set_read_timeout(50);
+    in->write_buffer(buffer, 4);
+    UNSIGNED_LONGS_EQUAL(4, out->try_read_exact(read_buffer, 16, ec));
+    CHECK_THROWS(com::exception::invalid_input,
+                 out->read_buffer(NULL, 16));
+
+    com::serial_stats stats = out->stats();
+    UNSIGNED_LONGS_EQUAL(2, stats.read.calls);
+    UNSIGNED_LONGS_EQUAL(4, stats.read.bytes);
+    UNSIGNED_LONGS_EQUAL(1, stats.read.timeouts);
+    UNSIGNED_LONGS_EQUAL(4, stats.read.timeout_bytes);
+    UNSIGNED_LONGS_EQUAL(1, stats.read.errors);
+    // Timeout of 50ms lands in bucket of 32 to 64ms (or next one on a
+    // loaded machine).
+    UNSIGNED_LONGS_EQUAL(1, stats.read.latency[16] + stats.read.latency[17]);
+}
+
+TEST(cppinterface_io, write_read_buffers)
+{
+    uint8_t header[2] = { 0x7e, 0x05 };
+    uint8_t payload[5] = { 0x01, 0x02, 0x03, 0x04, 0x05 };
+    uint8_t crc[2] = { 0xaa, 0x55 };
+    uint8_t read_header[2] = { };
+    uint8_t read_payload[5] = { };
+    uint8_t read_crc[2] = { };
+    struct iovec out_iov[4] = {
+        { header, sizeof(header) },
+        { NULL, 0 },
+        { payload, sizeof(payload) },
+        { crc, sizeof(crc) },
+    };
+    struct iovec in_iov[3] = {
+        { read_header, sizeof(read_header) },
+        { read_payload, sizeof(read_payload) },
+        { read_crc, sizeof(read_crc) },
+    };
+
+    UNSIGNED_LONGS_EQUAL(9, in->write_buffers(out_iov, 4));
+    UNSIGNED_LONGS_EQUAL(9, out->read_buffers(in_iov, 3));
+    MEMCMP_EQUAL(header, read_header, sizeof(header));
+    MEMCMP_EQUAL(payload, read_payload, sizeof(payload));
+    MEMCMP_EQUAL(crc, read_crc, sizeof(crc));
+
+    in->write_buffers(out_iov, 2);
+    try {
+        out->read_buffers(in_iov, 3);
+        FAIL("No exception thrown");
+    } catch (const com::exception::timeout &e) {
+        UNSIGNED_LONGS_EQUAL(2, e.get_bytes());
+    }
+}
+
+TEST(cppinterface_io, buffers_error)
+{
+    uint8_t buffer[4];
+    struct iovec empty[2] = { { buffer, 0 }, { NULL, 0 } };
+    struct iovec invalid[2] = { { buffer, 4 }, { NULL, 4 } };
+
+    CHECK_THROWS(com::exception::invalid_input, in->write_buffers(NULL, 1));
+    CHECK_THROWS(com::exception::invalid_input, in->write_buffers(empty, 2));
+    CHECK_THROWS(com::exception::invalid_input, in->write_buffers(invalid, 2));
+    CHECK_THROWS(com::exception::invalid_input, in->read_buffers(empty, 0));
+    CHECK_THROWS(com::exception::invalid_input, in->read_buffers(invalid, 2));
+}
+
+TEST(cppinterface_io, splice_to)
+{
+    uint8_t buffer[16];
+    uint8_t read_buffer[16] = { };
+    int p[2];
+
+    for (size_t index = 0; index < 16; index++)
+        buffer[index] = static_cast<uint8_t>(index);
+
+    CHECK_EQUAL(0, pipe(p));
+    in->write_buffer(buffer, 16);
+
+    UNSIGNED_LONGS_EQUAL(16, out->splice_to(p[1], 16));
+    LONGS_EQUAL(16, read(p[0], read_buffer, sizeof(read_buffer)));
+    MEMCMP_EQUAL(buffer, read_buffer, 16);
+
+    out->set_read_timeout(10);
+    CHECK_THROWS(com::exception::timeout, out->splice_to(p[1], 4));
+    CHECK_THROWS(com::exception::invalid_input, out->splice_to(-1, 4));
+    CHECK_THROWS(com::exception::invalid_input, out->splice_to(p[1], 0));
+
+    close(p[0]);
+    close(p[1]);
+}
+
+TEST(cppinterface_io, splice_from)
+{
+    uint8_t buffer[16];
+    uint8_t read_buffer[16] = { };
+    int p[2];
+
+    for (size_t index = 0; index < 16; index++)
+        buffer[index] = static_cast<uint8_t>(0xf0 - index);
+
+    CHECK_EQUAL(0, pipe(p));
+    LONGS_EQUAL(16, write(p[1], buffer, 16));
+    close(p[1]);
+
+    UNSIGNED_LONGS_EQUAL(16, in->splice_from(p[0], 64));
+    UNSIGNED_LONGS_EQUAL(16, out->read_buffer(read_buffer, 16));
+    MEMCMP_EQUAL(buffer, read_buffer, 16);
+
+    CHECK_THROWS(com::exception::invalid_input, in->splice_from(-1, 4));
+
+    close(p[0]);
+}
+
+TEST_GROUP(cppinterface_flow_control)
+{
+    /**
+    * @brief Receive queue of UART like devices, in bytes.
+    */
+    static const size_t RX_LIMIT = 4000;
+
+    fake::serial *m_serial;
+    std::string com_in = "uart_in";
+    std::string com_out = "uart_out";
+
+    com::serial *in;
+    com::serial *out;
+
+    void setup()
+    {
+        m_serial = new fake::serial(com_in, com_out, RX_LIMIT);
+
+        in = new com::serial(com_in);
+        out = new com::serial(com_out);
+    };
+
+    void teardown()
+    {
+        delete out;
+        delete in;
+
+        delete m_serial;
+    };
+
+    /**
+    * @brief Send data faster than reader consumes them.
+    *
+    * @param mode Flow control mode of both devices.
+    * @param sent Output data written.
+    * @param received Output data read.
+    */
+    void transfer(com::flow_control mode, std::vector<uint8_t> &sent,
+                    std::vector<uint8_t> &received)
+    {
+        // XON/XOFF characters must not be part of data.
+        sent.resize(64 * 1024);
+        for (size_t index = 0; index < sent.size(); index++)
+            sent[index] = static_cast<uint8_t>('a' + index % 26);
+        received.clear();
+
+        in->set_flow_control(mode);
+        out->set_flow_control(mode);
+        in->set_write_timeout(5000);
+        out->set_read_timeout(200);
+
+        // An exception must not escape from writer thread.
+        bool failed = false;
+        std::thread writer([this, &sent, &failed] {
+            try {
+                for (size_t offset = 0; offset < sent.size(); offset += 64)
+                    in->write_buffer(&sent[offset], 64);
+            } catch (std::exception &) {
+                failed = true;
+            }
+        });
+
+        // Reader is about four times slower than line.
+        uint8_t buffer[256];
+        while (received.size() < sent.size()) {
+            std::error_code ec;
+            size_t r = out->read_some(buffer, sizeof(buffer), ec);
+            if (ec)
+                break;
+            received.insert(received.end(), buffer, buffer + r);
+            usleep(1000);
+        }
+
+        writer.join();
+        CHECK_FALSE(failed);
+    }
+};
+
+TEST(cppinterface_flow_control, software_slow_consumer)
+{
+    std::vector<uint8_t> sent;
+    std::vector<uint8_t> received;
+
+    // Without flow control, bytes overflowing receiver are lost.
+    transfer(com::flow_none, sent, received);
+    CHECK(received.size() < sent.size());
+    CHECK(m_serial->dropped() > 0);
+    uint64_t dropped = m_serial->dropped();
+
+    // XOFF stops writer before receiver overflows.
+    transfer(com::flow_software, sent, received);
+    UNSIGNED_LONGS_EQUAL(sent.size(), received.size());
+    CHECK(sent == received);
+    UNSIGNED_LONGS_EQUAL(dropped, m_serial->dropped());
+}
+
 #endif /* end of include guard: UT_CPPMODULE_H_OWBGUT0J */
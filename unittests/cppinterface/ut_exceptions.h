@@ -68,6 +68,14 @@ TEST(cppinterface_exception, invalid_parity)
     delete pe;
 };
 
+TEST(cppinterface_exception, invalid_flow_control)
+{
+    com::exception::invalid_flow_control *pe =
+                                new com::exception::invalid_flow_control(3);
+    STRCMP_EQUAL("Invalid flow control (3)", pe->what());
+    delete pe;
+};
+
 TEST(cppinterface_exception, invalid_device)
 {
     com::exception::invalid_device *pe =
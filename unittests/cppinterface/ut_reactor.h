@@ -0,0 +1,159 @@
+#ifndef UT_REACTOR_H_WQ2NXV8L
+#define UT_REACTOR_H_WQ2NXV8L
+
+#include <comserial/reactor.h>
+
+#include <CppUTest/TestHarness.h>
+#include <string>
+#include <cstring>
+
+TEST_GROUP(cppinterface_reactor)
+{
+    fake::serial *m_serial;
+    std::string com_in = "com_in";
+    std::string com_out = "com_out";
+
+    com::serial *in;
+    com::serial *out;
+
+    void setup()
+    {
+        m_serial = new fake::serial(com_in, com_out);
+
+        in = new com::serial(com_in);
+        out = new com::serial(com_out);
+    };
+
+    void teardown()
+    {
+        delete out;
+        delete in;
+
+        delete m_serial;
+    };
+};
+
+TEST(cppinterface_reactor, invalid_batch_size)
+{
+    com::reactor *r = NULL;
+
+    CHECK_THROWS(com::exception::invalid_input, r = new com::reactor(0));
+
+    delete r;
+}
+
+TEST(cppinterface_reactor, empty_timeout)
+{
+    com::reactor r;
+
+    UNSIGNED_LONGS_EQUAL(0, r.size());
+    UNSIGNED_LONGS_EQUAL(0, r.run_once(10));
+}
+
+TEST(cppinterface_reactor, register_devices)
+{
+    com::reactor r;
+    com::reactor::handler h = [](com::serial &, unsigned int) { };
+
+    r.add(*in, h);
+    r.add(*out, h);
+    UNSIGNED_LONGS_EQUAL(2, r.size());
+
+    CHECK_THROWS(com::exception::invalid_input, r.add(*in, h));
+    CHECK_THROWS(com::exception::invalid_input,
+                 r.add(*in, com::reactor::handler()));
+
+    CHECK_TRUE(r.remove(*in));
+    CHECK_FALSE(r.remove(*in));
+    UNSIGNED_LONGS_EQUAL(1, r.size());
+
+    CHECK_THROWS(com::exception::invalid_input,
+                 r.modify(*in, com::reactor::writable));
+}
+
+TEST(cppinterface_reactor, dispatch_readable)
+{
+    uint8_t buffer[4] = { 0xde, 0xad, 0xbe, 0xef };
+    uint8_t read_buffer[16] = { };
+    size_t read_size = 0;
+    com::serial *ready = NULL;
+
+    com::reactor r;
+    r.add(*out, [&](com::serial &device, unsigned int events) {
+        CHECK_TRUE(events & com::reactor::readable);
+        ready = &device;
+        read_size += device.read_available(read_buffer + read_size,
+                                           sizeof(read_buffer) - read_size);
+    });
+
+    UNSIGNED_LONGS_EQUAL(0, r.run_once(10));
+
+    in->write_buffer(buffer, 4);
+    while (read_size < 4)
+        CHECK_TRUE(r.run_once(1000) > 0);
+
+    POINTERS_EQUAL(out, ready);
+    UNSIGNED_LONGS_EQUAL(4, read_size);
+    MEMCMP_EQUAL(buffer, read_buffer, 4);
+    UNSIGNED_LONGS_EQUAL(0, out->read_available(read_buffer, 16));
+}
+
+TEST(cppinterface_reactor, dispatch_writable)
+{
+    uint8_t buffer[4] = { 0xde, 0xad, 0xbe, 0xef };
+    uint8_t read_buffer[4] = { };
+    size_t written = 0;
+
+    com::reactor r;
+    r.add(*in, [&](com::serial &device, unsigned int events) {
+        CHECK_TRUE(events & com::reactor::writable);
+        written += device.write_available(buffer + written, 4 - written);
+        if (written == 4)
+            r.modify(device, 0);
+    }, com::reactor::writable);
+
+    while (written < 4)
+        CHECK_TRUE(r.run_once(1000) > 0);
+
+    UNSIGNED_LONGS_EQUAL(4, out->read_buffer(read_buffer, 4));
+    MEMCMP_EQUAL(buffer, read_buffer, 4);
+}
+
+TEST(cppinterface_reactor, remove_and_stop_from_handler)
+{
+    uint8_t buffer[2] = { 0x42, 0x43 };
+    size_t calls = 0;
+
+    com::reactor r;
+    com::reactor::handler h = [&](com::serial &device, unsigned int) {
+        calls++;
+        r.remove(device);
+        r.stop();
+    };
+    r.add(*in, h);
+    r.add(*out, h);
+
+    in->write_buffer(buffer, 1);
+    out->write_buffer(buffer + 1, 1);
+
+    r.run();
+
+    CHECK_TRUE(calls >= 1);
+    UNSIGNED_LONGS_EQUAL(2 - calls, r.size());
+}
+
+TEST(cppinterface_reactor, nonblocking_io_error)
+{
+    uint8_t buffer[16];
+
+    CHECK_THROWS(com::exception::invalid_input,
+                 in->read_available(NULL, 16));
+    CHECK_THROWS(com::exception::invalid_input,
+                 in->read_available(buffer, 0));
+    CHECK_THROWS(com::exception::invalid_input,
+                 in->write_available(NULL, 16));
+    CHECK_THROWS(com::exception::invalid_input,
+                 in->write_available(buffer, 0));
+}
+
+#endif /* end of include guard: UT_REACTOR_H_WQ2NXV8L */
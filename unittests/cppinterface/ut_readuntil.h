@@ -0,0 +1,174 @@
+#ifndef UT_READUNTIL_H_N5TD8KVA
+#define UT_READUNTIL_H_N5TD8KVA
+
+#include "scan.h"
+
+#include <CppUTest/TestHarness.h>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+TEST_GROUP(cppinterface_read_until)
+{
+    fake::serial *m_serial;
+    std::string com_in = "com_in";
+    std::string com_out = "com_out";
+
+    com::serial *in;
+    com::serial *out;
+
+    void setup()
+    {
+        m_serial = new fake::serial(com_in, com_out);
+
+        in = new com::serial(com_in);
+        out = new com::serial(com_out);
+    };
+
+    void teardown()
+    {
+        delete out;
+        delete in;
+
+        delete m_serial;
+    };
+
+    void send(const std::string &data)
+    {
+        in->write_buffer(reinterpret_cast<const uint8_t *>(data.data()),
+                         data.size());
+    }
+
+    std::string until(uint8_t delimiter, size_t length = 64)
+    {
+        std::vector<uint8_t> buffer(length);
+        size_t size = out->read_until(delimiter, buffer.data(), length);
+        return std::string(buffer.begin(), buffer.begin() + size);
+    }
+};
+
+TEST(cppinterface_read_until, invalid_input)
+{
+    uint8_t buffer[4];
+    uint8_t delimiter = '\n';
+
+    CHECK_THROWS(com::exception::invalid_input,
+                 out->read_until('\n', NULL, 4));
+    CHECK_THROWS(com::exception::invalid_input,
+                 out->read_until('\n', buffer, 0));
+    CHECK_THROWS(com::exception::invalid_input,
+                 out->read_until(NULL, 1, buffer, 4));
+    CHECK_THROWS(com::exception::invalid_input,
+                 out->read_until(&delimiter, 0, buffer, 4));
+}
+
+TEST(cppinterface_read_until, lines)
+{
+    send("one\ntwo\nthree\n");
+
+    STRCMP_EQUAL("one\n", until('\n').c_str());
+    STRCMP_EQUAL("two\n", until('\n').c_str());
+    STRCMP_EQUAL("three\n", until('\n').c_str());
+
+    // Lines were read ahead by large chunks
+    com::serial_stats stats = out->stats();
+    UNSIGNED_LONGS_EQUAL(3, stats.read.calls);
+    UNSIGNED_LONGS_EQUAL(14, stats.read.bytes);
+    CHECK(stats.read.syscalls < 14);
+}
+
+TEST(cppinterface_read_until, buffer_full)
+{
+    send("abcdef\n");
+
+    STRCMP_EQUAL("abcd", until('\n', 4).c_str());
+    STRCMP_EQUAL("ef\n", until('\n', 4).c_str());
+}
+
+TEST(cppinterface_read_until, many_delimiters)
+{
+    const uint8_t delimiters[3] = { ';', ',', '\n' };
+    uint8_t buffer[16];
+    std::string received;
+
+    send("a;bb,ccc\n");
+    for (int i = 0; i < 3; i++) {
+        size_t size = out->read_until(delimiters, 3, buffer, sizeof(buffer));
+        received.append(reinterpret_cast<char *>(buffer), size);
+        received += '|';
+    }
+    STRCMP_EQUAL("a;|bb,|ccc\n|", received.c_str());
+}
+
+TEST(cppinterface_read_until, timeout)
+{
+    uint8_t buffer[16];
+    std::error_code ec;
+
+    out->set_read_timeout(50);
+    send("partial");
+
+    try {
+        out->read_until('\n', buffer, sizeof(buffer));
+        FAIL("Timeout expected");
+    } catch (com::exception::timeout &e) {
+        UNSIGNED_LONGS_EQUAL(7, e.get_bytes());
+        MEMCMP_EQUAL("partial", buffer, 7);
+    }
+
+    uint8_t delimiter = '\n';
+    UNSIGNED_LONGS_EQUAL(0, out->try_read_until(&delimiter, 1, buffer,
+                                                sizeof(buffer), ec));
+    CHECK(ec == std::errc::timed_out);
+}
+
+TEST(cppinterface_read_until, leftover_read_first)
+{
+    uint8_t buffer[8] = { 0 };
+    int fds[2];
+
+    send("head\nbody");
+    STRCMP_EQUAL("head\n", until('\n').c_str());
+    UNSIGNED_LONGS_EQUAL(4, out->read_buffer(buffer, 4));
+    MEMCMP_EQUAL("body", buffer, 4);
+
+    // Leftover is also moved first by splice_to()
+    CHECK(pipe(fds) == 0);
+    send("x\nyz");
+    STRCMP_EQUAL("x\n", until('\n').c_str());
+    UNSIGNED_LONGS_EQUAL(2, out->splice_to(fds[1], 2));
+    LONGS_EQUAL(2, read(fds[0], buffer, sizeof(buffer)));
+    MEMCMP_EQUAL("yz", buffer, 2);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(cppinterface_read_until, scan_matches_scalar)
+{
+    std::vector<uint8_t> data(300);
+    const uint8_t set[10] = { 0x00, 0xc0, 0xdb, 0xdc, 0xdd, 0x0a, 0x0d, 0x7e,
+                              0x80, 0xff };
+
+    srand(42);
+    for (int round = 0; round < 200; round++) {
+        // Sparse matches so that every vector lane gets tested
+        for (uint8_t &byte: data)
+            byte = static_cast<uint8_t>(0x20 + rand() % 0x5e);
+        data[rand() % data.size()] = set[rand() % 10];
+
+        size_t offset = rand() % 32;
+        size_t size = rand() % (data.size() - offset);
+        size_t count = 1 + rand() % 10;
+        const uint8_t *start = data.data() + offset;
+
+        UNSIGNED_LONGS_EQUAL(com::scan::find_any_scalar(start, size, set, count),
+                             com::scan::find_any(start, size, set, count));
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, com::scan::find_any(data.data(), 0, set, 2));
+}
+
+#endif /* end of include guard: UT_READUNTIL_H_N5TD8KVA */
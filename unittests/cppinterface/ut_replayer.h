@@ -0,0 +1,143 @@
+#ifndef UT_REPLAYER_H_H7QX5MBR
+#define UT_REPLAYER_H_H7QX5MBR
+
+#include <comserial/replayer.h>
+
+#include <CppUTest/TestHarness.h>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+TEST_GROUP(cppinterface_replayer)
+{
+    std::string path = "unittests_replay.cap";
+    std::vector<std::string> files;
+
+    void setup()
+    {
+        files.clear();
+        files.push_back(path);
+
+        // Port "a" receives "hello" then " world" 50ms later
+        com::capture c(path, 4096);
+        uint16_t a = c.add_port("a");
+        uint16_t b = c.add_port("b");
+        c.record(a, com::capture::rx, "hello", 5);
+        c.record(a, com::capture::tx, "ignored", 7);
+        c.record(b, com::capture::rx, "other", 5);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        c.record(a, com::capture::rx, " world", 6);
+    };
+
+    void teardown()
+    {
+        unlink(path.c_str());
+    };
+
+    /**
+    * @brief Replay capture and read it from a device.
+    *
+    * @param r Replayer.
+    * @param scale Time scale.
+    * @param received Output data read from device.
+    *
+    * @return Result of replay.
+    */
+    com::replay_stats replay(com::replayer &r, double scale,
+                             std::string &received)
+    {
+        com::serial device(r.device_path());
+        com::replay_stats stats;
+        std::thread player([&r, &stats, scale] { stats = r.run(scale); });
+
+        uint8_t buffer[11];
+        device.write_buffer(reinterpret_cast<const uint8_t *>("ack"), 3);
+        size_t size = device.read_buffer(buffer, sizeof(buffer));
+        player.join();
+
+        received.assign(reinterpret_cast<char *>(buffer), size);
+        return stats;
+    }
+};
+
+TEST(cppinterface_replayer, invalid_input)
+{
+    std::vector<std::string> none;
+    std::vector<std::string> missing(1, "/nonexistent/capture.cap");
+
+    CHECK_THROWS(com::exception::invalid_input, com::replayer r(none));
+    CHECK_THROWS(com::exception::invalid_input, com::replayer r(files, "c"));
+    CHECK_THROWS(com::exception::runtime_error, com::replayer r(missing));
+
+    com::replayer r(files);
+    CHECK_THROWS(com::exception::invalid_input, r.run(-1.0));
+}
+
+TEST(cppinterface_replayer, first_port)
+{
+    com::replayer r(files);
+    std::string received;
+
+    UNSIGNED_LONGS_EQUAL(2, r.records());
+    com::replay_stats stats = replay(r, 0.0, received);
+
+    STRCMP_EQUAL("hello world", received.c_str());
+    UNSIGNED_LONGS_EQUAL(2, stats.records);
+    UNSIGNED_LONGS_EQUAL(11, stats.bytes);
+    CHECK(r.wait_drained(100));
+}
+
+TEST(cppinterface_replayer, named_port)
+{
+    com::replayer r(files, "b");
+    com::serial device(r.device_path());
+    uint8_t buffer[5];
+
+    UNSIGNED_LONGS_EQUAL(1, r.records());
+    r.run(0.0);
+    CHECK_FALSE(r.wait_drained(10));
+    device.read_buffer(buffer, sizeof(buffer));
+    MEMCMP_EQUAL("other", buffer, sizeof(buffer));
+    CHECK(r.wait_drained(100));
+}
+
+TEST(cppinterface_replayer, time_scale)
+{
+    std::string received;
+    {
+        com::replayer r(files);
+        com::replay_stats stats = replay(r, 1.0, received);
+
+        STRCMP_EQUAL("hello world", received.c_str());
+        CHECK(stats.elapsed >= 45000000ULL);
+        UNSIGNED_LONGS_EQUAL(3, stats.discarded);
+    }
+    {
+        com::replayer r(files);
+        com::replay_stats stats = replay(r, 10.0, received);
+
+        STRCMP_EQUAL("hello world", received.c_str());
+        CHECK(stats.elapsed >= 4500000ULL);
+        CHECK(stats.elapsed < 45000000ULL);
+    }
+}
+
+TEST(cppinterface_replayer, stop)
+{
+    com::replayer r(files);
+    com::replay_stats stats;
+    std::thread player([&r, &stats] { stats = r.run(0.001); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    r.stop();
+    player.join();
+
+    UNSIGNED_LONGS_EQUAL(1, stats.records);
+    UNSIGNED_LONGS_EQUAL(5, stats.bytes);
+}
+
+#endif /* end of include guard: UT_REPLAYER_H_H7QX5MBR */
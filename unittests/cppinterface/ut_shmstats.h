@@ -0,0 +1,170 @@
+#ifndef UT_SHMSTATS_H_R8WQ3NZD
+#define UT_SHMSTATS_H_R8WQ3NZD
+
+#include "shmstats.h"
+
+#include <CppUTest/TestHarness.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+TEST_GROUP(cppinterface_shmstats)
+{
+    fake::serial *m_serial;
+    std::string com_in = "com_in";
+    std::string com_out = "com_out";
+
+    void setup()
+    {
+        setenv("CSER_SHMSTATS", "10", 1);
+        m_serial = new fake::serial(com_in, com_out);
+    };
+
+    void teardown()
+    {
+        unsetenv("CSER_SHMSTATS");
+        delete m_serial;
+    };
+
+    /**
+    * @brief Find segment of a device of current process.
+    *
+    * @param device Path name of device.
+    *
+    * @return Name of segment in /dev/shm, empty when not found.
+    */
+    std::string find_segment(const std::string &device)
+    {
+        std::string prefix = std::string(com::shmstats::PREFIX)
+                           + std::to_string(getpid()) + ".";
+        std::string found;
+
+        DIR *dir = opendir("/dev/shm");
+        if (dir == NULL)
+            return found;
+        while (struct dirent *entry = readdir(dir)) {
+            std::string name(entry->d_name);
+            if (name.compare(0, prefix.size(), prefix) != 0)
+                continue;
+
+            com::shmstats::segment *seg = map("/" + name);
+            if (seg == NULL)
+                continue;
+            if (device == seg->device)
+                found = name;
+            munmap(seg, sizeof(*seg));
+        }
+        closedir(dir);
+        return found;
+    }
+
+    /**
+    * @brief Map a segment.
+    *
+    * @param name Name of segment.
+    *
+    * @return Mapped segment, or NULL on error.
+    */
+    com::shmstats::segment *map(const std::string &name)
+    {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            return NULL;
+        void *addr = mmap(NULL, sizeof(com::shmstats::segment), PROT_READ,
+                          MAP_SHARED, fd, 0);
+        close(fd);
+        return addr == MAP_FAILED ? NULL
+                                  : static_cast<com::shmstats::segment *>(addr);
+    }
+};
+
+TEST(cppinterface_shmstats, store_load)
+{
+    com::shmstats::segment *seg = new com::shmstats::segment();
+    com::serial_stats stats;
+    com::serial_stats loaded;
+    uint64_t timestamp = 0;
+
+    memset(&stats, 0, sizeof(stats));
+    stats.read.bytes = 12;
+    stats.read.latency[3] = 4;
+    stats.write.errors = 2;
+    stats.write.latency[31] = 1;
+
+    // Header is not valid yet
+    CHECK_FALSE(com::shmstats::load(*seg, loaded, timestamp));
+
+    memcpy(seg->magic, com::shmstats::MAGIC, sizeof(seg->magic));
+    seg->version = com::shmstats::LAYOUT_VERSION;
+    seg->size = sizeof(*seg);
+    com::shmstats::store(*seg, stats, 42);
+
+    CHECK(com::shmstats::load(*seg, loaded, timestamp));
+    UNSIGNED_LONGS_EQUAL(42, timestamp);
+    UNSIGNED_LONGS_EQUAL(2, seg->sequence.load());
+    MEMCMP_EQUAL(&stats, &loaded, sizeof(stats));
+
+    // Writer stopped in the middle of an update
+    seg->sequence.store(3);
+    CHECK_FALSE(com::shmstats::load(*seg, loaded, timestamp));
+
+    delete seg;
+}
+
+TEST(cppinterface_shmstats, disabled)
+{
+    unsetenv("CSER_SHMSTATS");
+    com::serial out(com_out);
+
+    STRCMP_EQUAL("", find_segment(com_out).c_str());
+}
+
+TEST(cppinterface_shmstats, export)
+{
+    std::string name;
+    {
+        com::serial in(com_in);
+        com::serial out(com_out);
+        uint8_t buffer[8] = { 0 };
+
+        name = find_segment(com_out);
+        CHECK(!name.empty());
+        STRCMP_EQUAL("", find_segment("unknown").c_str());
+
+        com::shmstats::segment *seg = map("/" + name);
+        CHECK(seg != NULL);
+        UNSIGNED_LONGS_EQUAL(getpid(), seg->pid);
+        UNSIGNED_LONGS_EQUAL(10, seg->period);
+
+        out.write_buffer(buffer, sizeof(buffer));
+        in.read_buffer(buffer, sizeof(buffer));
+
+        // Wait for publisher thread
+        com::serial_stats stats;
+        uint64_t timestamp = 0;
+        for (int i = 0; i < 100; i++) {
+            CHECK(com::shmstats::load(*seg, stats, timestamp));
+            if (stats.write.bytes == sizeof(buffer))
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        UNSIGNED_LONGS_EQUAL(sizeof(buffer), stats.write.bytes);
+        UNSIGNED_LONGS_EQUAL(1, stats.write.calls);
+        UNSIGNED_LONGS_EQUAL(0, stats.read.bytes);
+        CHECK(timestamp != 0);
+
+        munmap(seg, sizeof(*seg));
+    }
+
+    // Segment is removed with device
+    STRCMP_EQUAL("", find_segment(com_out).c_str());
+}
+
+#endif /* end of include guard: UT_SHMSTATS_H_R8WQ3NZD */
@@ -0,0 +1,222 @@
+#ifndef UT_SLIP_H_F2LC9WQA
+#define UT_SLIP_H_F2LC9WQA
+
+#include <comserial/slip.h>
+
+#include <CppUTest/TestHarness.h>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+TEST_GROUP(cppinterface_slip)
+{
+    fake::serial *m_serial;
+    std::string com_in = "com_in";
+    std::string com_out = "com_out";
+
+    com::serial *in;
+    com::serial *out;
+
+    void setup()
+    {
+        m_serial = new fake::serial(com_in, com_out);
+
+        in = new com::serial(com_in);
+        out = new com::serial(com_out);
+    };
+
+    void teardown()
+    {
+        delete out;
+        delete in;
+
+        delete m_serial;
+    };
+
+    /**
+    * @brief Decode a stream byte per byte, as a reference.
+    *
+    * @param data Encoded stream.
+    *
+    * @return Non empty frames of stream.
+    */
+    std::vector<std::string> reference(const std::vector<uint8_t> &data)
+    {
+        std::vector<std::string> frames;
+        std::string current;
+        bool escape = false;
+
+        for (uint8_t byte: data) {
+            if (escape) {
+                escape = false;
+                if (byte == com::slip_codec::ESC_END)
+                    byte = com::slip_codec::END;
+                else if (byte == com::slip_codec::ESC_ESC)
+                    byte = com::slip_codec::ESC;
+                current += static_cast<char>(byte);
+            } else if (byte == com::slip_codec::ESC) {
+                escape = true;
+            } else if (byte == com::slip_codec::END) {
+                if (!current.empty())
+                    frames.push_back(current);
+                current.clear();
+            } else {
+                current += static_cast<char>(byte);
+            }
+        }
+        return frames;
+    }
+};
+
+TEST(cppinterface_slip, encode)
+{
+    const uint8_t data[4] = { 0x01, 0xc0, 0xdb, 0x02 };
+    const uint8_t expected[8] = { 0xc0, 0x01, 0xdb, 0xdc, 0xdb, 0xdd, 0x02,
+                                  0xc0 };
+    uint8_t buffer[10];
+
+    UNSIGNED_LONGS_EQUAL(10, com::slip_codec::max_encoded_size(4));
+    UNSIGNED_LONGS_EQUAL(8, com::slip_codec::encode(data, 4, buffer));
+    MEMCMP_EQUAL(expected, buffer, sizeof(expected));
+}
+
+TEST(cppinterface_slip, decode_matches_reference)
+{
+    std::vector<uint8_t> frame(256);
+    std::vector<uint8_t> stream;
+    std::vector<uint8_t> storage(256);
+    com::frame decoded_frame = { storage.data(), 0, storage.size() };
+    com::slip_codec codec;
+    std::vector<std::string> decoded;
+
+    srand(24);
+    for (int i = 0; i < 100; i++) {
+        size_t size = 1 + rand() % frame.size();
+        for (size_t j = 0; j < size; j++)
+            frame[j] = static_cast<uint8_t>(rand() % 4 == 0 ? 0xc0 + rand() % 32
+                                                            : rand());
+        size_t offset = stream.size();
+        stream.resize(offset + com::slip_codec::max_encoded_size(size));
+        stream.resize(offset + com::slip_codec::encode(frame.data(), size,
+                                                       stream.data() + offset));
+    }
+
+    // Feed stream by random chunks
+    size_t position = 0;
+    while (position < stream.size()) {
+        size_t chunk = std::min<size_t>(1 + rand() % 100,
+                                        stream.size() - position);
+        size_t consumed;
+        while (chunk != 0) {
+            if (codec.decode(stream.data() + position, chunk, decoded_frame,
+                             consumed)) {
+                decoded.push_back(std::string(decoded_frame.data,
+                                              decoded_frame.data
+                                                  + decoded_frame.size));
+                decoded_frame.size = 0;
+            }
+            position += consumed;
+            chunk -= consumed;
+        }
+    }
+
+    std::vector<std::string> expected = reference(stream);
+    UNSIGNED_LONGS_EQUAL(100, expected.size());
+    CHECK(decoded == expected);
+    UNSIGNED_LONGS_EQUAL(0, codec.dropped());
+}
+
+TEST(cppinterface_slip, decode_errors)
+{
+    // Oversized frame, aborted frame, unknown escape and empty frames
+    const uint8_t stream[] = { 0xc0, 'a', 'b', 'c', 'd', 'e', 0xc0,
+                               'x', 0xdb, 0xc0, 0xc0, 0xc0,
+                               'o', 0xdb, 'k', 0xc0 };
+    uint8_t storage[4];
+    com::frame decoded_frame = { storage, 0, sizeof(storage) };
+    com::slip_codec codec;
+    size_t consumed;
+
+    CHECK(codec.decode(stream, sizeof(stream), decoded_frame, consumed));
+    UNSIGNED_LONGS_EQUAL(sizeof(stream), consumed);
+    UNSIGNED_LONGS_EQUAL(2, decoded_frame.size);
+    MEMCMP_EQUAL("ok", storage, 2);
+    UNSIGNED_LONGS_EQUAL(2, codec.dropped());
+}
+
+TEST(cppinterface_slip, frame_pool)
+{
+    CHECK_THROWS(com::exception::invalid_input, com::frame_pool p(0, 16));
+    CHECK_THROWS(com::exception::invalid_input, com::frame_pool p(2, 0));
+
+    com::frame_pool pool(2, 16);
+    com::frame *a = pool.acquire();
+    com::frame *b = pool.acquire();
+
+    CHECK(a != NULL && b != NULL && a != b);
+    UNSIGNED_LONGS_EQUAL(16, a->capacity);
+    UNSIGNED_LONGS_EQUAL(0, pool.available());
+    POINTERS_EQUAL(NULL, pool.acquire());
+
+    a->size = 5;
+    pool.release(a);
+    POINTERS_EQUAL(a, pool.acquire());
+    UNSIGNED_LONGS_EQUAL(0, a->size);
+}
+
+TEST(cppinterface_slip, device)
+{
+    com::slip_serial sender(*in, 16);
+    com::slip_serial receiver(*out, 16, 2);
+    const uint8_t first[3] = { 0xc0, 'a', 0xdb };
+    const uint8_t large[17] = { 0 };
+
+    CHECK_THROWS(com::exception::invalid_input, sender.write_frame(NULL, 1));
+    CHECK_THROWS(com::exception::invalid_input, sender.write_frame(large, 17));
+
+    UNSIGNED_LONGS_EQUAL(3, sender.write_frame(first, 3));
+    UNSIGNED_LONGS_EQUAL(5, sender.write_frame(
+                                reinterpret_cast<const uint8_t *>("hello"), 5));
+
+    com::frame *a = receiver.read_frame();
+    com::frame *b = receiver.read_frame();
+    UNSIGNED_LONGS_EQUAL(3, a->size);
+    MEMCMP_EQUAL(first, a->data, 3);
+    UNSIGNED_LONGS_EQUAL(5, b->size);
+    MEMCMP_EQUAL("hello", b->data, 5);
+
+    // Caller holds every frame of pool
+    std::error_code ec;
+    POINTERS_EQUAL(NULL, receiver.try_read_frame(ec));
+    CHECK(ec == std::errc::no_buffer_space);
+    CHECK_THROWS(com::exception::runtime_error, receiver.read_frame());
+
+    receiver.release(a);
+    receiver.release(b);
+    UNSIGNED_LONGS_EQUAL(0, receiver.dropped());
+}
+
+TEST(cppinterface_slip, partial_frame)
+{
+    com::slip_serial receiver(*out);
+
+    out->set_read_timeout(50);
+    in->write_buffer(reinterpret_cast<const uint8_t *>("\xc0par"), 4);
+    try {
+        receiver.read_frame();
+        FAIL("Timeout expected");
+    } catch (com::exception::timeout &e) {
+        UNSIGNED_LONGS_EQUAL(3, e.get_bytes());
+    }
+
+    in->write_buffer(reinterpret_cast<const uint8_t *>("tial\xc0"), 5);
+    com::frame *f = receiver.read_frame();
+    UNSIGNED_LONGS_EQUAL(7, f->size);
+    MEMCMP_EQUAL("partial", f->data, 7);
+    receiver.release(f);
+
+    // Bytes are accounted for once decoded
+    UNSIGNED_LONGS_EQUAL(9, out->stats().read.bytes);
+}
+
+#endif /* end of include guard: UT_SLIP_H_F2LC9WQA */
@@ -0,0 +1,108 @@
+#ifndef UT_URING_H_M7C2KQ4D
+#define UT_URING_H_M7C2KQ4D
+
+#include <comserial/uring.h>
+
+#include <CppUTest/TestHarness.h>
+#include <string>
+#include <cstring>
+#include <vector>
+
+TEST_GROUP(cppinterface_uring)
+{
+    fake::serial *m_serial;
+    std::string com_in = "com_in";
+    std::string com_out = "com_out";
+
+    com::serial *in;
+    com::serial *out;
+
+    void setup()
+    {
+        m_serial = new fake::serial(com_in, com_out);
+
+        in = new com::serial(com_in);
+        out = new com::serial(com_out);
+    };
+
+    void teardown()
+    {
+        delete out;
+        delete in;
+
+        delete m_serial;
+    };
+};
+
+TEST(cppinterface_uring, invalid_size)
+{
+    com::uring *u = NULL;
+
+    CHECK_THROWS(com::exception::invalid_input, u = new com::uring(0));
+    CHECK_THROWS(com::exception::invalid_input, u = new com::uring(8, 0));
+
+    delete u;
+}
+
+TEST(cppinterface_uring, attach_detach)
+{
+    com::uring u;
+    uint8_t byte = 0;
+
+    u.attach(*in);
+    CHECK_THROWS(com::exception::invalid_input, u.attach(*in));
+    CHECK_THROWS(com::exception::invalid_input, u.write(*out, &byte, 1));
+    CHECK_THROWS(com::exception::invalid_input, u.write(*in, NULL, 1));
+    CHECK_THROWS(com::exception::invalid_input, u.write(*in, &byte, 0));
+
+    CHECK_TRUE(u.detach(*in));
+    CHECK_FALSE(u.detach(*in));
+}
+
+TEST(cppinterface_uring, write_and_read)
+{
+    const uint8_t buffer[4] = { 0xde, 0xad, 0xbe, 0xef };
+    std::vector<uint8_t> received;
+    std::vector<com::uring::completion> completions;
+    bool sent = false;
+    com::uring u;
+    int cookie = 0;
+
+    u.attach(*in);
+    u.attach(*out);
+    u.write(*in, buffer, sizeof(buffer), &cookie);
+
+    for (int i = 0; i < 50 && (!sent || received.size() < sizeof(buffer)); i++) {
+        u.wait(completions, 1, 100);
+        for (auto &c: completions) {
+            if (c.op == com::uring::sent) {
+                POINTERS_EQUAL(in, c.device);
+                POINTERS_EQUAL(&cookie, c.user_data);
+                LONGS_EQUAL(sizeof(buffer), c.result);
+                sent = true;
+            } else {
+                POINTERS_EQUAL(out, c.device);
+                CHECK(c.result > 0);
+                received.insert(received.end(), c.data, c.data + c.result);
+            }
+        }
+    }
+
+    CHECK_TRUE(sent);
+    UNSIGNED_LONGS_EQUAL(sizeof(buffer), received.size());
+    MEMCMP_EQUAL(buffer, received.data(), sizeof(buffer));
+
+    CHECK_TRUE(u.detach(*out));
+}
+
+TEST(cppinterface_uring, wait_timeout)
+{
+    std::vector<com::uring::completion> completions;
+    com::uring u;
+
+    u.attach(*out);
+    UNSIGNED_LONGS_EQUAL(0, u.wait(completions, 1, 10));
+    UNSIGNED_LONGS_EQUAL(0, completions.size());
+}
+
+#endif /* end of include guard: UT_URING_H_M7C2KQ4D */
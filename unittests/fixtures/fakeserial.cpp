@@ -1,88 +1,218 @@
 #include "fakeserial.h"
 
-#include <sstream>
-#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
 
-#include <signal.h>
-#include <errno.h>
-#include <cstring>
-#include <sys/wait.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <sys/ioctl.h>
+#include <sys/eventfd.h>
+#include <termios.h>
 
-std::set<pid_t> fake::serial::m_socat_pid_list;
+const size_t fake::serial::LINE_RATE;
 
-#if HAVE_SOCAT == 1
-static void crash_handler(int signum)
+fake::serial::serial(const std::string &in, const std::string &out,
+                     size_t rx_limit)
+    : m_links{in, out}
+    , m_master{-1, -1}
+    , m_slave{-1, -1}
+    , m_pending()
+    , m_rx_limit(rx_limit)
+    , m_credit{0, 0}
+    , m_throttled{false, false}
+    , m_stopped{false, false}
+    , m_dropped(0)
+    , m_wakefd(-1)
+    , m_thread()
 {
-    switch (signum) {
-        case SIGSEGV:
-        case SIGABRT:
-            for (auto &it: fake::serial::m_socat_pid_list) {
-                kill(it, SIGINT);
-                waitpid(it, NULL, 0);
-            }
+    for (size_t i = 0; i < 2; i++) {
+        char name[256];
+        // Slave sides stay opened so that masters never hang up.
+        if (openpty(&m_master[i], &m_slave[i], name, NULL, NULL) < 0)
+            throw std::runtime_error("Fail to open pseudo terminal");
+
+        struct termios options;
+        tcgetattr(m_slave[i], &options);
+        cfmakeraw(&options);
+        tcsetattr(m_slave[i], TCSANOW, &options);
+        fcntl(m_master[i], F_SETFL, fcntl(m_master[i], F_GETFL) | O_NONBLOCK);
+
+        unlink(m_links[i].c_str());
+        if (symlink(name, m_links[i].c_str()) < 0)
+            throw std::runtime_error("Fail to link pseudo terminal");
+    }
+
+    m_wakefd = eventfd(0, EFD_CLOEXEC);
+    m_thread = std::thread(rx_limit == 0 ? &fake::serial::forward
+                                         : &fake::serial::forward_uart,
+                           this);
+}
 
-            signal(signum, SIG_DFL);
-            kill(getpid(), signum);
-            break;
+fake::serial::~serial()
+{
+    uint64_t value = 1;
+    if (write(m_wakefd, &value, sizeof(value)) == sizeof(value))
+        m_thread.join();
+    else
+        m_thread.detach();
+    close(m_wakefd);
+
+    for (size_t i = 0; i < 2; i++) {
+        unlink(m_links[i].c_str());
+        close(m_slave[i]);
+        close(m_master[i]);
     }
 }
-#endif
 
-fake::serial::serial(const std::string &in, const std::string &out)
-    : m_pid(0)
-    , m_mypid(getpid())
+void fake::serial::forward()
 {
-#if HAVE_SOCAT == 1
-    // Create fake serial using socat
-    m_pid = fork();
-    if (m_pid == 0) {
-        // We are in child process
-        std::stringstream arg1;
-        std::stringstream arg2;
-
-        arg1 << "pty,link=" << in << ",rawer";
-        arg2 << "pty,link=" << out << ",rawer";
-
-        int ret = execl("/usr/bin/socat", "socat",
-                        arg1.str().c_str(),
-                        arg2.str().c_str(),
-                        (char *) NULL);
-        if (ret == -1) {
-            int errsys = errno;
-            std::cerr << "Fail to start socat: "
-                      << strerror(errsys)
-                      << std::endl;
-            kill(m_mypid, SIGINT);
-            throw std::exception();
+    for (;;) {
+        struct pollfd fds[3];
+        for (size_t i = 0; i < 2; i++) {
+            // Stop reading a side while its data are not forwarded, so that
+            // slow consumer back pressure reaches writer.
+            fds[i].fd = m_master[i];
+            fds[i].events = 0;
+            if (m_pending[i].length == 0)
+                fds[i].events |= POLLIN;
+            if (m_pending[1 - i].length != 0)
+                fds[i].events |= POLLOUT;
+        }
+        fds[2].fd = m_wakefd;
+        fds[2].events = POLLIN;
+
+        if (poll(fds, 3, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
         }
-    } else if (m_pid == -1) {
-        throw std::exception();
-    } else {
-        // Store child in set and register crash handler that will clean
-        // all socat instances on SIGNAL
-        m_socat_pid_list.insert(m_pid);
-        signal(SIGSEGV, crash_handler);
-        signal(SIGABRT, crash_handler);
-
-        bool all_ok = false;
-        while (!all_ok) {
-            all_ok =    (access(in.c_str(), F_OK) == 0)
-                    &&  (access(out.c_str(), F_OK) == 0);
-            usleep(1);
+        if (fds[2].revents != 0)
+            return;
+
+        for (size_t i = 0; i < 2; i++) {
+            pending &p = m_pending[i];
+            if ((fds[i].revents & POLLIN) && p.length == 0) {
+                ssize_t r = read(m_master[i], p.data, sizeof(p.data));
+                if (r > 0) {
+                    p.offset = 0;
+                    p.length = r;
+                }
+            }
+
+            pending &q = m_pending[1 - i];
+            if ((fds[i].revents & POLLOUT) && q.length != 0) {
+                ssize_t w = write(m_master[i], q.data + q.offset, q.length);
+                if (w > 0) {
+                    q.offset += w;
+                    q.length -= w;
+                }
+            }
         }
     }
-#else
-    (void) in;
-    (void) out;
-#endif
 }
 
-fake::serial::~serial()
+uint64_t fake::serial::dropped() const
+{
+    return m_dropped.load();
+}
+
+size_t fake::serial::queued(size_t side)
+{
+    // Polling slave pushes data in flight to its input queue first.
+    struct pollfd pfd = { m_slave[side], POLLIN, 0 };
+    poll(&pfd, 1, 0);
+
+    int count = 0;
+    if (ioctl(m_slave[side], FIONREAD, &count) < 0)
+        return 0;
+    return count;
+}
+
+void fake::serial::deliver(size_t side)
+{
+    uint8_t data[4096];
+    size_t length = m_credit[side] < sizeof(data) ? m_credit[side]
+                                                  : sizeof(data);
+    ssize_t r = read(m_master[side], data, length);
+    if (r <= 0)
+        return;
+    m_credit[side] -= r;
+
+    size_t used = queued(1 - side);
+    size_t room = used < m_rx_limit ? m_rx_limit - used : 0;
+    length = static_cast<size_t>(r) < room ? r : room;
+    ssize_t w = length == 0 ? 0 : write(m_master[1 - side], data, length);
+    m_dropped += r - (w > 0 ? w : 0);
+}
+
+void fake::serial::throttle(size_t side)
 {
-#if HAVE_SOCAT == 1
-    kill(m_pid, SIGINT);
-    m_socat_pid_list.erase(m_pid);
-    waitpid(m_pid, NULL, 0);
-#endif
+    struct termios writer;
+    struct termios reader;
+    if (tcgetattr(m_slave[side], &writer) < 0
+            || tcgetattr(m_slave[1 - side], &reader) < 0)
+        return;
+
+    bool ixoff = (reader.c_iflag & IXOFF) != 0;
+    size_t used = queued(1 - side);
+    uint8_t control;
+    if (!m_throttled[side] && ixoff && used >= m_rx_limit / 4)
+        control = reader.c_cc[VSTOP];
+    else if (m_throttled[side] && (!ixoff || used <= m_rx_limit / 16))
+        control = reader.c_cc[VSTART];
+    else
+        return;
+
+    if (write(m_master[side], &control, 1) != 1)
+        return;
+    m_throttled[side] = !m_throttled[side];
+    // Control character is processed by writer before anything else is read
+    queued(side);
+    m_stopped[side] = m_throttled[side] && (writer.c_iflag & IXON) != 0;
 }
 
+void fake::serial::forward_uart()
+{
+    auto last = std::chrono::steady_clock::now();
+
+    for (;;) {
+        struct pollfd fds[3];
+        for (size_t i = 0; i < 2; i++) {
+            // A stopped writer transmits nothing, buffered data included.
+            fds[i].fd = m_master[i];
+            fds[i].events = 0;
+            if (!m_stopped[i] && m_credit[i] >= 256)
+                fds[i].events |= POLLIN;
+        }
+        fds[2].fd = m_wakefd;
+        fds[2].events = POLLIN;
+
+        // Receive queues are drained by readers without notice.
+        if (poll(fds, 3, 1) < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        if (fds[2].revents != 0)
+            return;
+
+        auto now = std::chrono::steady_clock::now();
+        size_t credit = std::chrono::duration_cast<std::chrono::microseconds>(
+                            now - last).count() * LINE_RATE / 1000;
+        if (credit != 0) {
+            // An idle line does not bank time: burst is one poll period.
+            last = now;
+            for (size_t i = 0; i < 2; i++)
+                m_credit[i] = std::min(m_credit[i] + credit, LINE_RATE);
+        }
+
+        for (size_t i = 0; i < 2; i++) {
+            if (fds[i].revents & POLLIN)
+                deliver(i);
+            throttle(i);
+        }
+    }
+}
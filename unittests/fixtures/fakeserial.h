@@ -1,23 +1,103 @@
 #ifndef FAKESERIAL_H_SCYTFMMV
 #define FAKESERIAL_H_SCYTFMMV
 
-#include <set>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <thread>
 #include <unistd.h>
 
 namespace fake {
+    /**
+    * @brief Pair of connected serial devices.
+    *
+    * Both devices are slave sides of pseudo terminals, reachable through
+    * symbolic links given at construction. An in-process thread forwards
+    * data between master sides, so that anything written on one device is
+    * read on the other one.
+    *
+    * By default, a device which is not read holds back forwarding, so that
+    * writer eventually blocks and nothing is lost. With a receive limit,
+    * devices rather behave like UARTs linked at LINE_RATE: bytes that do
+    * not fit in receive queue of a device are dropped. When IXOFF is set on
+    * a device, XOFF is sent to writer once its queue is a quarter full, and
+    * XON once it is back under a sixteenth, as a UART driver would do
+    * (pseudo terminals never send them by themselves). A writer with IXON
+    * set then stops transmitting.
+    */
     class serial {
         public:
-            serial(const std::string &in, const std::string &out);
+            serial(const std::string &in, const std::string &out,
+                   size_t rx_limit = 0);
             ~serial();
 
+            /**
+            * @brief Get number of bytes dropped because of receive limit.
+            *
+            * @return Number of bytes.
+            */
+            uint64_t dropped() const;
+
+            /**
+            * @brief Line rate in bytes per ms when a receive limit is set.
+            */
+            static const size_t LINE_RATE = 1000;
+
         private:
-            pid_t m_pid;
-            pid_t m_mypid;
+            /**
+            * @brief Main loop of forwarding thread.
+            */
+            void forward();
+            /**
+            * @brief Forwarding loop with a receive limit.
+            */
+            void forward_uart();
+            /**
+            * @brief Get number of bytes waiting in input queue of a device.
+            *
+            * @param side Index of device.
+            *
+            * @return Number of bytes.
+            */
+            size_t queued(size_t side);
+            /**
+            * @brief Forward data written by a device, up to line rate, and
+            *        drop what does not fit in receive queue of other one.
+            *
+            * @param side Index of writing device.
+            */
+            void deliver(size_t side);
+            /**
+            * @brief Send XOFF or XON to a device according to input queue of
+            *        other one.
+            *
+            * @param side Index of writing device.
+            */
+            void throttle(size_t side);
 
-        public:
-            static std::set<pid_t> m_socat_pid_list;
+        private:
+            /**
+            * @brief Data read on a master side, not yet written on other one.
+            */
+            struct pending {
+                uint8_t data[4096];
+                size_t offset;
+                size_t length;
+            };
 
+            std::string m_links[2];
+            int m_master[2];
+            int m_slave[2];
+            pending m_pending[2];
+            size_t m_rx_limit;
+            size_t m_credit[2];
+            bool m_throttled[2];
+            bool m_stopped[2];
+            std::atomic<uint64_t> m_dropped;
+            int m_wakefd;
+            std::thread m_thread;
     };
 };
 
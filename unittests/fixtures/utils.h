@@ -6,12 +6,6 @@
 
 #define DIM_OF(array) (sizeof(array) / sizeof((array)[0]))
 
-#if HAVE_SOCAT == 1
-#   define SOCAT_TEST TEST
-#else
-#   define SOCAT_TEST IGNORE_TEST
-#endif
-
 #define ARRAY(...) { __VA_ARGS__ }
 #define check_frame(expect, type, ...) do { \
     std::vector<uint8_t> expected(expect); \
@@ -0,0 +1,174 @@
+#ifndef UT_BINLOG_H_V2KD7QWM
+#define UT_BINLOG_H_V2KD7QWM
+
+#include "binlog.h"
+#include "logger.h"
+
+#include <CppUTest/TestHarness.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+TEST_GROUP(binlog)
+{
+    void setup()
+    {
+        unlink("unittests_binlog.log");
+        setenv("CSER_LOGDESTINATION", "unittests_binlog.log", 1);
+    }
+
+    void teardown()
+    {
+        unsetenv("CSER_LOGDESTINATION");
+        unsetenv("CSER_LOGLEVEL");
+        unsetenv("CSER_LOGFORMAT");
+        logger::context::instance().reload();
+        unlink("unittests_binlog.log");
+    }
+
+    std::string content()
+    {
+        std::ifstream f("unittests_binlog.log", std::ios::binary);
+        std::stringstream ss;
+        ss << f.rdbuf();
+        return ss.str();
+    }
+};
+
+TEST(binlog, records)
+{
+    const uint8_t raw[] = { 0x00, 0x7f, 0xff };
+    std::string log;
+    std::string chunks;
+
+    binlog::write_header(log);
+    binlog::write_site(log, 1, "file.cpp", 42, "function");
+    binlog::text_chunk(chunks, "Data:");
+    binlog::binary_chunk(chunks, raw, sizeof(raw));
+    binlog::write_message(log, 1234567890123ULL, 1, logger::log_level::warn,
+                          chunks);
+
+    binlog::reader reader(log.data(), log.size());
+    binlog::record r;
+
+    CHECK_TRUE(reader.next(r));
+    LONGS_EQUAL(binlog::HEADER, r.type);
+    MEMCMP_EQUAL(binlog::MAGIC, r.body, r.length);
+
+    CHECK_TRUE(reader.next(r));
+    LONGS_EQUAL(binlog::SITE, r.type);
+    LONGS_EQUAL(1, binlog::get(r.body, 4));
+    LONGS_EQUAL(42, binlog::get(r.body + 4, 4));
+    LONGS_EQUAL(8, binlog::get(r.body + 8, 2));
+    MEMCMP_EQUAL("file.cpp", r.body + 10, 8);
+
+    CHECK_TRUE(reader.next(r));
+    LONGS_EQUAL(binlog::MESSAGE, r.type);
+    LONGS_EQUAL(13 + chunks.size(), r.length);
+    CHECK(binlog::get(r.body, 8) == 1234567890123ULL);
+    LONGS_EQUAL(logger::log_level::warn, r.body[12]);
+    MEMCMP_EQUAL(chunks.data(), r.body + 13, chunks.size());
+    MEMCMP_EQUAL(raw, r.body + r.length - sizeof(raw), sizeof(raw));
+
+    CHECK_FALSE(reader.next(r));
+    LONGS_EQUAL(log.size(), reader.offset());
+}
+
+TEST(binlog, truncated)
+{
+    std::string log;
+    binlog::write_header(log);
+    binlog::write_header(log);
+
+    binlog::reader reader(log.data(), log.size() - 1);
+    binlog::record r;
+
+    CHECK_TRUE(reader.next(r));
+    CHECK_FALSE(reader.next(r));
+    LONGS_EQUAL(log.size() / 2, reader.offset());
+}
+
+#if LOGGER_COMPILED_LEVEL >= 4
+TEST(binlog, context)
+{
+    uint8_t raw[256];
+    for (size_t i = 0; i < sizeof(raw); i++)
+        raw[i] = static_cast<uint8_t>(i);
+
+    setenv("CSER_LOGLEVEL", "4", 1);
+    logger::context::instance().reload();
+    ELOG() << "Data:" << logger::dump(raw, sizeof(raw));
+    size_t text_size = content().size();
+
+    unlink("unittests_binlog.log");
+    setenv("CSER_LOGFORMAT", "binary", 1);
+    logger::context::instance().reload();
+    CHECK_TRUE(logger::context::instance().binary());
+    for (int i = 0; i < 2; i++)
+        ELOG() << "Data:" << logger::dump(raw, sizeof(raw));
+    std::string log = content();
+
+    binlog::reader reader(log.data(), log.size());
+    binlog::record r;
+
+    CHECK_TRUE(reader.next(r));
+    LONGS_EQUAL(binlog::HEADER, r.type);
+    CHECK_TRUE(reader.next(r));
+    LONGS_EQUAL(binlog::SITE, r.type);
+    CHECK_TRUE(reader.next(r));
+    LONGS_EQUAL(binlog::MESSAGE, r.type);
+    LONGS_EQUAL(1, binlog::get(r.body + 8, 4));
+    LONGS_EQUAL(logger::log_level::error, r.body[12]);
+    MEMCMP_EQUAL(raw, r.body + r.length - sizeof(raw), sizeof(raw));
+    size_t message_size = binlog::RECORD_HEADER_SIZE + r.length;
+
+    // Call site is only defined once.
+    CHECK_TRUE(reader.next(r));
+    LONGS_EQUAL(binlog::MESSAGE, r.type);
+    LONGS_EQUAL(1, binlog::get(r.body + 8, 4));
+    CHECK_FALSE(reader.next(r));
+
+    // Raw bytes are about a quarter of their hexdump.
+    CHECK(4 * message_size < text_size);
+}
+
+/**
+* @brief Log a message from a single statement.
+*
+* @param i Value logged.
+*/
+static void log_from_same_site(int i)
+{
+    ELOG() << "Value " << i;
+}
+
+TEST(binlog, site_defined_again_after_header)
+{
+    setenv("CSER_LOGLEVEL", "4", 1);
+    setenv("CSER_LOGFORMAT", "binary", 1);
+    for (int session = 0; session < 2; session++) {
+        unlink("unittests_binlog.log");
+        logger::context::instance().reload();
+        log_from_same_site(0);
+        log_from_same_site(1);
+
+        std::string log = content();
+        binlog::reader reader(log.data(), log.size());
+        binlog::record r;
+
+        CHECK_TRUE(reader.next(r));
+        LONGS_EQUAL(binlog::HEADER, r.type);
+        CHECK_TRUE(reader.next(r));
+        LONGS_EQUAL(binlog::SITE, r.type);
+        LONGS_EQUAL(1, binlog::get(r.body, 4));
+        for (int i = 0; i < 2; i++) {
+            CHECK_TRUE(reader.next(r));
+            LONGS_EQUAL(binlog::MESSAGE, r.type);
+            LONGS_EQUAL(1, binlog::get(r.body + 8, 4));
+        }
+        CHECK_FALSE(reader.next(r));
+    }
+}
+#endif
+
+#endif /* end of include guard: UT_BINLOG_H_V2KD7QWM */
@@ -0,0 +1,226 @@
+#ifndef UT_CONTEXT_H_M3XQ8RLD
+#define UT_CONTEXT_H_M3XQ8RLD
+
+#include "logger.h"
+
+#include <CppUTest/TestHarness.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace logger;
+
+TEST_GROUP(logcontext)
+{
+    void setup()
+    {
+        unlink("unittests_context.log");
+        setenv("CSER_LOGDESTINATION", "unittests_context.log", 1);
+    }
+
+    void teardown()
+    {
+        unsetenv("CSER_LOGDESTINATION");
+        unsetenv("CSER_LOGLEVEL");
+        unsetenv("CSER_LOGASYNC");
+        context::instance().reload();
+        unlink("unittests_context.log");
+    }
+
+    std::string content()
+    {
+        std::ifstream f("unittests_context.log");
+        std::stringstream ss;
+        ss << f.rdbuf();
+        return ss.str();
+    }
+};
+
+TEST(logcontext, disabled)
+{
+    setenv("CSER_LOGLEVEL", "0", 1);
+    context::instance().reload();
+
+    int evaluated = 0;
+    ELOG() << "Error " << ++evaluated;
+
+    CHECK_FALSE(context::enabled(log_level::fatal));
+    LONGS_EQUAL(0, evaluated);
+    STRCMP_EQUAL("", content().c_str());
+}
+
+#if LOGGER_COMPILED_LEVEL >= 4
+TEST(logcontext, level)
+{
+    setenv("CSER_LOGLEVEL", "4", 1);
+    context::instance().reload();
+
+    LONGS_EQUAL(log_level::error, context::instance().level());
+    CHECK_TRUE(context::enabled(log_level::error));
+    CHECK_FALSE(context::enabled(log_level::warn));
+
+    ELOG() << "Error";
+    WLOG() << "Warning";
+
+    std::string log = content();
+    CHECK(log.compare(0, 4, "[E] ") == 0);
+    CHECK(log.find("(testBody) Error\n") != std::string::npos);
+    CHECK(log.find("Warning") == std::string::npos);
+}
+#endif
+
+TEST(logcontext, compiled_out)
+{
+    setenv("CSER_LOGLEVEL", "9", 1);
+    context::instance().reload();
+
+    int evaluated = 0;
+    TLOG() << "Trace " << ++evaluated;
+
+    LONGS_EQUAL(LOGGER_COMPILED_LEVEL >= 9 ? 1 : 0, evaluated);
+}
+
+TEST(logcontext, unbraced_if)
+{
+    setenv("CSER_LOGLEVEL", "9", 1);
+    context::instance().reload();
+
+    bool branch = false;
+    if (branch)
+        ILOG() << "Not printed";
+    else
+        branch = true;
+
+    CHECK_TRUE(branch);
+    STRCMP_EQUAL("", content().c_str());
+}
+
+#if LOGGER_COMPILED_LEVEL >= 7
+TEST(logcontext, concurrent_lines)
+{
+    setenv("CSER_LOGLEVEL", "7", 1);
+    context::instance().reload();
+
+    std::thread t1([] {
+        for (int i = 0; i < 100; i++)
+            ILOG() << "thread " << 1;
+    });
+    std::thread t2([] {
+        for (int i = 0; i < 100; i++)
+            ILOG() << "thread " << 2;
+    });
+    t1.join();
+    t2.join();
+
+    std::istringstream log(content());
+    std::string line;
+    size_t lines = 0;
+    while (std::getline(log, line)) {
+        CHECK(line.compare(0, 4, "[I] ") == 0);
+        CHECK(line.find(") thread ") != std::string::npos);
+        lines++;
+    }
+    UNSIGNED_LONGS_EQUAL(200, lines);
+}
+#endif
+
+#if LOGGER_COMPILED_LEVEL >= 7
+TEST(logcontext, async_lines)
+{
+    setenv("CSER_LOGLEVEL", "7", 1);
+    setenv("CSER_LOGASYNC", "1", 1);
+    context::instance().reload();
+
+    std::thread t1([] {
+        for (int i = 0; i < 100; i++)
+            ILOG() << "thread " << 1;
+    });
+    std::thread t2([] {
+        for (int i = 0; i < 100; i++)
+            ILOG() << "thread " << 2;
+    });
+    t1.join();
+    t2.join();
+    context::instance().flush();
+
+    std::istringstream log(content());
+    std::string line;
+    size_t lines = 0;
+    while (std::getline(log, line)) {
+        CHECK(line.compare(0, 4, "[I] ") == 0);
+        lines++;
+    }
+    UNSIGNED_LONGS_EQUAL(200, lines);
+    UNSIGNED_LONGS_EQUAL(0, context::instance().dropped());
+}
+#endif
+
+/**
+* @brief Stream buffer blocking on first write until released.
+*/
+class blocking_buf : public std::stringbuf
+{
+    public:
+        blocking_buf() : m_mutex(), m_cond(), m_entered(false),
+                         m_released(false) { }
+
+        void wait_entered()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this] { return m_entered; });
+        }
+
+        void release()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_released = true;
+            m_cond.notify_all();
+        }
+
+    protected:
+        std::streamsize xsputn(const char *s, std::streamsize n)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_entered = true;
+            m_cond.notify_all();
+            m_cond.wait(lock, [this] { return m_released; });
+            return std::stringbuf::xsputn(s, n);
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+        bool m_entered;
+        bool m_released;
+};
+
+TEST(logcontext, async_drop)
+{
+    blocking_buf buf;
+    std::ostream output(&buf);
+    async_sink sink(&output, 4);
+
+    // Flusher takes first record and blocks writing it, ring is then full
+    // after 4 more records.
+    CHECK_TRUE(sink.push("first\n"));
+    buf.wait_entered();
+    for (int i = 0; i < 4; i++)
+        CHECK_TRUE(sink.push("queued\n"));
+    CHECK_FALSE(sink.push("dropped\n"));
+    CHECK_FALSE(sink.push("dropped\n"));
+    UNSIGNED_LONGS_EQUAL(2, sink.dropped());
+
+    buf.release();
+    sink.flush();
+    sink.stop();
+    CHECK_FALSE(sink.running());
+
+    STRCMP_EQUAL("first\nqueued\nqueued\nqueued\nqueued\n"
+                 "[W] logger: 2 message(s) dropped\n",
+                 buf.str().c_str());
+}
+
+#endif /* end of include guard: UT_CONTEXT_H_M3XQ8RLD */
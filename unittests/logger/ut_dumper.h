@@ -123,4 +123,18 @@ TEST(dumper, multiline_exactdata)
     check_string(expected, DIM_OF(expected), d);
 }
 
+TEST(dumper, non_printable_data)
+{
+    const char data[] = { 'A', 'B', '\x00', '\x7f', '\xff', ' ', '~', '\x1f', 'z' };
+    const char *expected[] = {
+        "Dump 9 byte(s) starting at 0x",
+        "00000000 41 42 00 7f ff 20 7e 1f  7a                      |AB... ~. z       |",
+    };
+
+    dump mydump(data, sizeof(data));
+    std::string d = mydump.get_formatted_string();
+
+    check_string(expected, DIM_OF(expected), d);
+}
+
 #endif /* end of include guard: UT_DUMPER_H_KNBIKBMF */
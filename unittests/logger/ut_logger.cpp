@@ -1,6 +1,8 @@
 #include "ut_dumper.h"
 #include "ut_log_location.h"
 #include "ut_internallog.h"
+#include "ut_context.h"
+#include "ut_binlog.h"
 
 #include <CppUTest/CommandLineTestRunner.h>
 